@@ -19,13 +19,21 @@
 #ifndef THEORETICA_ALGEBRA_H
 #define THEORETICA_ALGEBRA_H
 
+#include <vector>
+
 #include "../complex/complex_types.h"
 #include "../core/core_traits.h"
 #include "../core/error.h"
+#include "../core/simd.h"
 
 
 namespace theoretica {
 
+
+	// Forward declaration of the matrix class, defined in mat.h
+	template<typename Type, unsigned int N, unsigned int K, typename Allocator> class mat;
+
+
 	namespace algebra {
 
 		// Error states for linear algebra types
@@ -155,6 +163,97 @@ namespace theoretica {
 	namespace algebra {
 
 
+		namespace _internal {
+
+
+			// Check whether the structures are all mat types
+			// with the same element type supported by the SIMD kernels.
+			template<typename Structure1, typename Structure2, typename Structure3>
+			struct is_simd_mat_triple : std::false_type {};
+
+			template<typename Type,
+				unsigned int N1, unsigned int K1, typename Allocator1,
+				unsigned int N2, unsigned int K2, typename Allocator2,
+				unsigned int N3, unsigned int K3, typename Allocator3>
+			struct is_simd_mat_triple<
+				mat<Type, N1, K1, Allocator1>,
+				mat<Type, N2, K2, Allocator2>,
+				mat<Type, N3, K3, Allocator3>
+			> : simd::is_simd_type<Type> {};
+
+
+			// Type of the elements of a vector or mat stored contiguously,
+			// as pointed to by its data() method.
+			template<typename Structure>
+			using simd_element_t = std::remove_cv_t<std::remove_pointer_t<
+				decltype(std::declval<const Structure&>().data())>>;
+
+
+			// Check whether the structures are all contiguous vectors
+			// or all mat types, with the same element type supported
+			// by the SIMD kernels.
+			template<typename Structure1, typename Structure2, typename Structure3>
+			struct is_simd_triple : std::integral_constant<bool,
+				(simd::is_simd_pair<Structure1, Structure2>::value
+					&& simd::is_simd_pair<Structure2, Structure3>::value)
+				|| is_simd_mat_triple<Structure1, Structure2, Structure3>::value
+			> {};
+
+
+			/// Compute dest = a * src using the SIMD kernels,
+			/// if both structures are stored contiguously.
+			/// @return Whether the operation was performed
+			template<typename Structure1, typename Field, typename Structure2,
+				std::enable_if_t<is_simd_triple<Structure1, Structure2, Structure2>::value
+					&& std::is_arithmetic<Field>::value, bool> = true>
+			inline bool simd_scalmul(Structure1& dest, Field a, const Structure2& src, size_t n) {
+
+				using Type = simd_element_t<Structure1>;
+				simd::scale(Type(a), src.data(), dest.data(), n);
+				return true;
+			}
+
+
+			// Fallback for structures not supported by the SIMD kernels
+			template<typename Structure1, typename Field, typename Structure2,
+				std::enable_if_t<!(is_simd_triple<Structure1, Structure2, Structure2>::value
+					&& std::is_arithmetic<Field>::value), bool> = true>
+			inline bool simd_scalmul(Structure1&, Field, const Structure2&, size_t) {
+				return false;
+			}
+
+
+			/// Compute res = alpha * A + beta * B using the SIMD kernels,
+			/// if all structures are stored contiguously.
+			/// @return Whether the operation was performed
+			template<typename Structure1, typename Field1, typename Structure2,
+				typename Field2, typename Structure3,
+				std::enable_if_t<is_simd_triple<Structure1, Structure2, Structure3>::value
+					&& std::is_arithmetic<Field1>::value
+					&& std::is_arithmetic<Field2>::value, bool> = true>
+			inline bool simd_lincomb(
+				Structure1& res, Field1 alpha, const Structure2& A,
+				Field2 beta, const Structure3& B, size_t n) {
+
+				using Type = simd_element_t<Structure1>;
+				simd::lincomb(Type(alpha), A.data(), Type(beta), B.data(), res.data(), n);
+				return true;
+			}
+
+
+			// Fallback for structures not supported by the SIMD kernels
+			template<typename Structure1, typename Field1, typename Structure2,
+				typename Field2, typename Structure3,
+				std::enable_if_t<!(is_simd_triple<Structure1, Structure2, Structure3>::value
+					&& std::is_arithmetic<Field1>::value
+					&& std::is_arithmetic<Field2>::value), bool> = true>
+			inline bool simd_lincomb(
+				Structure1&, Field1, const Structure2&, Field2, const Structure3&, size_t) {
+				return false;
+			}
+		}
+
+
 		// Operations involving one matrix or vector
 
 
@@ -254,6 +353,35 @@ namespace theoretica {
 		}
 
 
+		namespace _internal {
+
+			/// Copy a vector or matrix for algebra::clone. Views,
+			/// whose copies share the referenced elements, specialize
+			/// it to copy the elements into new storage.
+			template<typename Structure>
+			struct clone_helper {
+				
+				static inline Structure clone(const Structure& s) {
+					return s;
+				}
+			};
+		}
+
+
+		/// Copy a vector or matrix into a new object which does not
+		/// share its elements with the original, so that it can be
+		/// modified without side effects. For containers this is a plain
+		/// copy, while the elements referenced by a view are copied into
+		/// new storage owned by the returned view.
+		///
+		/// @param s The vector or matrix to copy
+		/// @return A copy of the vector or matrix
+		template<typename Structure>
+		inline Structure clone(const Structure& s) {
+			return _internal::clone_helper<Structure>::clone(s);
+		}
+
+
 		/// Swap two rows of a matrix, given the matrix and the
 		/// two indices of the rows.
 		///
@@ -374,7 +502,7 @@ namespace theoretica {
 		///
 		/// @param v The vector to compute the norm of
 		/// @return The norm of the given vector
-		template<typename Vector>
+		template<typename Vector, simd::disable_simd<Vector> = true>
 		inline auto sqr_norm(const Vector& v) {
 
 			auto sum = pair_inner_product(v[0], v[0]);
@@ -387,6 +515,17 @@ namespace theoretica {
 		}
 
 
+		/// Returns the square of the Euclidean norm of a vector
+		/// with contiguous real elements, using SIMD kernels.
+		///
+		/// @param v The vector to compute the norm of
+		/// @return The norm of the given vector
+		template<typename Vector, simd::enable_simd<Vector> = true>
+		inline auto sqr_norm(const Vector& v) {
+			return simd::sqr_norm(v.data(), v.size());
+		}
+
+
 		/// Returns the Euclidean/Hermitian norm of the given vector
 		///
 		/// @param v The vector to compute the norm of
@@ -450,7 +589,8 @@ namespace theoretica {
 		/// @param v The first vector
 		/// @param w The second vector
 		/// @return The dot product of the two vectors
-		template<typename Vector1, typename Vector2>
+		template<typename Vector1, typename Vector2,
+			simd::disable_simd<Vector1, Vector2> = true>
 		inline auto dot(const Vector1& v, const Vector2& w) {
 
 			if(v.size() != w.size()) {
@@ -468,6 +608,25 @@ namespace theoretica {
 		}
 
 
+		/// Computes the dot product between two vectors
+		/// with contiguous real elements, using SIMD kernels.
+		///
+		/// @param v The first vector
+		/// @param w The second vector
+		/// @return The dot product of the two vectors
+		template<typename Vector1, typename Vector2,
+			simd::enable_simd<Vector1, Vector2> = true>
+		inline auto dot(const Vector1& v, const Vector2& w) {
+
+			if(v.size() != w.size()) {
+				TH_MATH_ERROR("algebra::dot", v.size(), MathError::InvalidArgument);
+				return vector_element_t<Vector1>(nan());
+			}
+
+			return simd::dot(v.data(), w.data(), v.size());
+		}
+
+
 		/// Compute the cross product between two tridimensional vectors
 		/// @param v1 The first tridimensional vector
 		/// @param w The second tridimensional vector
@@ -726,6 +885,9 @@ namespace theoretica {
 		template<typename Field, typename Vector>
 		inline Vector& vec_scalmul(Field a, Vector& v) {
 
+			if (_internal::simd_scalmul(v, a, v, v.size()))
+				return v;
+
 			for (unsigned int i = 0; i < v.size(); ++i)
 				v[i] *= a;
 
@@ -747,6 +909,9 @@ namespace theoretica {
 				return vec_error(dest);
 			}
 
+			if (_internal::simd_scalmul(dest, a, src, src.size()))
+				return dest;
+
 			for (unsigned int i = 0; i < src.size(); ++i)
 				dest[i] = a * src[i];
 
@@ -793,7 +958,7 @@ namespace theoretica {
 		inline Vector transform(const Matrix& A, const Vector& v) {
 
 			Vector res;
-			res.resize(v.size());
+			res.resize(A.rows());
 
 			if(v.size() != A.cols()) {
 				TH_MATH_ERROR("algebra::transform", v.size(), MathError::InvalidArgument);
@@ -825,7 +990,7 @@ namespace theoretica {
 				return vec_error(res);
 			}
 
-			if(res.size() != v.size()) {
+			if(res.size() != A.rows()) {
 				TH_MATH_ERROR("algebra::transform", res.size(), MathError::InvalidArgument);
 				return vec_error(res);
 			}
@@ -849,7 +1014,7 @@ namespace theoretica {
 		/// @param B The second matrix to add
 		/// @return A reference to the overwritten matrix
 		template<typename Matrix1, typename Matrix2>
-		inline Matrix2& mat_sum(Matrix1& A, const Matrix2& B) {
+		inline Matrix1& mat_sum(Matrix1& A, const Matrix2& B) {
 
 			if(A.rows() != B.rows()) {
 				TH_MATH_ERROR("algebra::mat_sum", A.rows(), MathError::InvalidArgument);
@@ -911,7 +1076,7 @@ namespace theoretica {
 		/// @param B The second matrix
 		/// @return A reference to the overwritten matrix
 		template<typename Matrix1, typename Matrix2>
-		inline Matrix2& mat_diff(Matrix1& A, const Matrix2& B) {
+		inline Matrix1& mat_diff(Matrix1& A, const Matrix2& B) {
 
 			if(A.rows() != B.rows()) {
 				TH_MATH_ERROR("algebra::mat_diff", A.rows(), MathError::InvalidArgument);
@@ -974,7 +1139,7 @@ namespace theoretica {
 		/// @param B The second matrix to combine
 		/// @return A reference to the overwritten matrix
 		template<typename Field1, typename Matrix1, typename Field2, typename Matrix2>
-		inline Matrix2& mat_lincomb(
+		inline Matrix1& mat_lincomb(
 			Field1 alpha, Matrix1& A, Field2 beta, const Matrix2& B) {
 
 			if(A.rows() != B.rows()) {
@@ -987,6 +1152,9 @@ namespace theoretica {
 				return mat_error(A);
 			}
 
+			if (_internal::simd_lincomb(A, alpha, A, beta, B, A.rows() * A.cols()))
+				return A;
+
 			for (unsigned int i = 0; i < A.rows(); ++i)
 				for (unsigned int j = 0; j < A.cols(); ++j)
 					A(i, j) = A(i, j) * alpha + B(i, j) * beta;
@@ -1022,7 +1190,6 @@ namespace theoretica {
 			if(res.rows() != A.rows()) {
 				TH_MATH_ERROR("algebra::mat_lincomb", res.rows(), MathError::InvalidArgument);
 				return mat_error(res);
-				return res;
 			}
 
 			if(res.cols() != A.cols()) {
@@ -1030,16 +1197,269 @@ namespace theoretica {
 				return mat_error(res);
 			}
 
+			if (_internal::simd_lincomb(res, alpha, A, beta, B, A.rows() * A.cols()))
+				return res;
+
 			for (unsigned int i = 0; i < A.rows(); ++i)
 				for (unsigned int j = 0; j < A.cols(); ++j)
 					res(i, j) = A(i, j) * alpha + B(i, j) * beta;
 
-			return A;
+			return res;
+		}
+
+
+		namespace _internal {
+
+
+			/// Number of rows of the register tile of the blocked
+			/// matrix multiplication kernel.
+			constexpr unsigned int GEMM_MR = 4;
+
+			/// Number of columns of the register tile of the blocked
+			/// matrix multiplication kernel.
+			constexpr unsigned int GEMM_NR = 8;
+
+
+			/// Pack a block of the left operand of a matrix product
+			/// into contiguous memory, as consecutive panels of GEMM_MR rows
+			/// where the elements of each column of a panel are adjacent.
+			/// Rows past the end of the block are padded with zeroes.
+			///
+			/// @param dest The buffer to write the packed block to,
+			/// with space for at least ceil(mc / GEMM_MR) * GEMM_MR * kc elements
+			/// @param A A function returning the element of the operand at (i, k)
+			/// @param i0 The first row of the block
+			/// @param k0 The first column of the block
+			/// @param mc The number of rows of the block
+			/// @param kc The number of columns of the block
+			template<typename Type, typename AccessA>
+			inline void gemm_pack_a(
+				Type* dest, AccessA A, unsigned int i0,
+				unsigned int k0, unsigned int mc, unsigned int kc) {
+
+				for (unsigned int p = 0; p < mc; p += GEMM_MR) {
+
+					Type* panel = dest + p * kc;
+					const unsigned int rows = min(GEMM_MR, mc - p);
+
+					// Traverse the operand following its memory layout
+#ifdef THEORETICA_ROW_FIRST
+					for (unsigned int r = 0; r < GEMM_MR; ++r)
+						for (unsigned int k = 0; k < kc; ++k)
+							panel[k * GEMM_MR + r] =
+								(r < rows) ? Type(A(i0 + p + r, k0 + k)) : Type(0.0);
+#else
+					for (unsigned int k = 0; k < kc; ++k)
+						for (unsigned int r = 0; r < GEMM_MR; ++r)
+							panel[k * GEMM_MR + r] =
+								(r < rows) ? Type(A(i0 + p + r, k0 + k)) : Type(0.0);
+#endif
+				}
+			}
+
+
+			/// Pack a block of the right operand of a matrix product
+			/// into contiguous memory, as consecutive panels of GEMM_NR columns
+			/// where the elements of each row of a panel are adjacent.
+			/// Columns past the end of the block are padded with zeroes.
+			///
+			/// @param dest The buffer to write the packed block to,
+			/// with space for at least ceil(nc / GEMM_NR) * GEMM_NR * kc elements
+			/// @param B A function returning the element of the operand at (k, j)
+			/// @param k0 The first row of the block
+			/// @param j0 The first column of the block
+			/// @param kc The number of rows of the block
+			/// @param nc The number of columns of the block
+			template<typename Type, typename AccessB>
+			inline void gemm_pack_b(
+				Type* dest, AccessB B, unsigned int k0,
+				unsigned int j0, unsigned int kc, unsigned int nc) {
+
+				for (unsigned int q = 0; q < nc; q += GEMM_NR) {
+
+					Type* panel = dest + q * kc;
+					const unsigned int cols = min(GEMM_NR, nc - q);
+
+					// Traverse the operand following its memory layout
+#ifdef THEORETICA_ROW_FIRST
+					for (unsigned int k = 0; k < kc; ++k)
+						for (unsigned int c = 0; c < GEMM_NR; ++c)
+							panel[k * GEMM_NR + c] =
+								(c < cols) ? Type(B(k0 + k, j0 + q + c)) : Type(0.0);
+#else
+					for (unsigned int c = 0; c < GEMM_NR; ++c)
+						for (unsigned int k = 0; k < kc; ++k)
+							panel[k * GEMM_NR + c] =
+								(c < cols) ? Type(B(k0 + k, j0 + q + c)) : Type(0.0);
+#endif
+				}
+			}
+
+
+			/// Multiply a packed panel of the left operand by a packed panel
+			/// of the right operand, accumulating the GEMM_MR x GEMM_NR tile
+			/// in local variables and adding it to the destination matrix.
+			///
+			/// @param C The matrix to accumulate the result into
+			/// @param a The packed panel of the left operand
+			/// @param b The packed panel of the right operand
+			/// @param kc The inner size of the panels
+			/// @param i0 The first row of the tile in C
+			/// @param j0 The first column of the tile in C
+			/// @param rows The number of valid rows of the tile
+			/// @param cols The number of valid columns of the tile
+			template<typename Matrix, typename TypeA, typename TypeB>
+			inline void gemm_micro_kernel(
+				Matrix& C, const TypeA* a, const TypeB* b, unsigned int kc,
+				unsigned int i0, unsigned int j0, unsigned int rows, unsigned int cols) {
+
+				// C may be any callable returning a reference to its elements
+				using Type = std::decay_t<decltype(C(0, 0))>;
+
+				Type acc[GEMM_MR][GEMM_NR];
+
+				for (unsigned int i = 0; i < GEMM_MR; ++i)
+					for (unsigned int j = 0; j < GEMM_NR; ++j)
+						acc[i][j] = Type(0.0);
+
+				// Rank-1 updates of the register tile
+				for (unsigned int k = 0; k < kc; ++k) {
+
+					const TypeA* a_k = a + k * GEMM_MR;
+					const TypeB* b_k = b + k * GEMM_NR;
+
+					for (unsigned int i = 0; i < GEMM_MR; ++i)
+						for (unsigned int j = 0; j < GEMM_NR; ++j)
+							acc[i][j] += a_k[i] * b_k[j];
+				}
+
+				// Store the tile following the memory layout of C
+#ifdef THEORETICA_ROW_FIRST
+				for (unsigned int i = 0; i < rows; ++i)
+					for (unsigned int j = 0; j < cols; ++j)
+						C(i0 + i, j0 + j) += acc[i][j];
+#else
+				for (unsigned int j = 0; j < cols; ++j)
+					for (unsigned int i = 0; i < rows; ++i)
+						C(i0 + i, j0 + j) += acc[i][j];
+#endif
+			}
+
+
+			/// Multiply a packed block of the left operand by a packed block
+			/// of the right operand, iterating the micro-kernel over all tiles.
+			///
+			/// @param C The matrix to accumulate the result into
+			/// @param a_pack The packed block of the left operand
+			/// @param b_pack The packed block of the right operand
+			/// @param i0 The first row of the block in C
+			/// @param j0 The first column of the block in C
+			/// @param mc The number of rows of the block
+			/// @param nc The number of columns of the block
+			/// @param kc The inner size of the block
+			template<typename Matrix, typename TypeA, typename TypeB>
+			inline void gemm_macro_kernel(
+				Matrix& C, const TypeA* a_pack, const TypeB* b_pack,
+				unsigned int i0, unsigned int j0,
+				unsigned int mc, unsigned int nc, unsigned int kc) {
+
+				for (unsigned int jr = 0; jr < nc; jr += GEMM_NR)
+					for (unsigned int ir = 0; ir < mc; ir += GEMM_MR)
+						gemm_micro_kernel(
+							C, a_pack + ir * kc, b_pack + jr * kc, kc,
+							i0 + ir, j0 + jr,
+							min(GEMM_MR, mc - ir), min(GEMM_NR, nc - jr)
+						);
+			}
+
+
+			/// Accumulate the product of two matrices into C using
+			/// a cache-blocked kernel, equivalent to \f$C = C + A B\f$.
+			/// Blocks of the operands are packed into contiguous buffers
+			/// sized to fit the cache hierarchy (see ALGEBRA_GEMM_MC,
+			/// ALGEBRA_GEMM_KC and ALGEBRA_GEMM_NC) and multiplied
+			/// by a register-tiled micro-kernel.
+			///
+			/// @param C The matrix to accumulate the result into
+			/// @param A A function returning the element of the left operand at (i, k)
+			/// @param B A function returning the element of the right operand at (k, j)
+			/// @param m The number of rows of the result
+			/// @param n The number of columns of the result
+			/// @param k The inner size of the product
+			template<typename Matrix, typename AccessA, typename AccessB>
+			inline Matrix& gemm_blocked(
+				Matrix& C, AccessA A, AccessB B,
+				unsigned int m, unsigned int n, unsigned int k) {
+
+				using TypeA = std::decay_t<decltype(A(0, 0))>;
+				using TypeB = std::decay_t<decltype(B(0, 0))>;
+
+				const unsigned int mc_max = min(ALGEBRA_GEMM_MC, m);
+				const unsigned int kc_max = min(ALGEBRA_GEMM_KC, k);
+				const unsigned int nc_max = min(ALGEBRA_GEMM_NC, n);
+
+				// Packing buffers rounded up to a whole number of panels
+				std::vector<TypeA> a_pack (
+					((mc_max + GEMM_MR - 1) / GEMM_MR) * GEMM_MR * kc_max);
+				std::vector<TypeB> b_pack (
+					((nc_max + GEMM_NR - 1) / GEMM_NR) * GEMM_NR * kc_max);
+
+				for (unsigned int jc = 0; jc < n; jc += ALGEBRA_GEMM_NC) {
+
+					const unsigned int nc = min(ALGEBRA_GEMM_NC, n - jc);
+
+					for (unsigned int pc = 0; pc < k; pc += ALGEBRA_GEMM_KC) {
+
+						const unsigned int kc = min(ALGEBRA_GEMM_KC, k - pc);
+						gemm_pack_b(b_pack.data(), B, pc, jc, kc, nc);
+
+						for (unsigned int ic = 0; ic < m; ic += ALGEBRA_GEMM_MC) {
+
+							const unsigned int mc = min(ALGEBRA_GEMM_MC, m - ic);
+							gemm_pack_a(a_pack.data(), A, ic, pc, mc, kc);
+
+							gemm_macro_kernel(
+								C, a_pack.data(), b_pack.data(), ic, jc, mc, nc, kc);
+						}
+					}
+				}
+
+				return C;
+			}
+
+
+			/// Accumulate the product of two matrices into C,
+			/// equivalent to \f$C = C + A B\f$, using the blocked kernel
+			/// for products bigger than ALGEBRA_GEMM_THRESHOLD and a simple
+			/// triple loop otherwise (e.g. for small statically allocated matrices).
+			///
+			/// @param C The matrix to accumulate the result into
+			/// @param A A function returning the element of the left operand at (i, k)
+			/// @param B A function returning the element of the right operand at (k, j)
+			/// @param m The number of rows of the result
+			/// @param n The number of columns of the result
+			/// @param k The inner size of the product
+			template<typename Matrix, typename AccessA, typename AccessB>
+			inline Matrix& gemm(
+				Matrix& C, AccessA A, AccessB B,
+				unsigned int m, unsigned int n, unsigned int k) {
+
+				if (uint64_t(m) * n * k >= ALGEBRA_GEMM_THRESHOLD)
+					return gemm_blocked(C, A, B, m, n, k);
+
+				for (unsigned int i = 0; i < m; ++i)
+					for (unsigned int j = 0; j < n; ++j)
+						for (unsigned int l = 0; l < k; ++l)
+							C(i, j) += A(i, l) * B(l, j);
+
+				return C;
+			}
 		}
 
 
 		/// Multiply two matrices and store the result in the first matrix,
 		/// equivalent to the operation \f$R = A B\f$.
+		/// A cache-blocked kernel is used for big matrices.
 		///
 		/// @param A The first matrix to multiply and store the result
 		/// @param B The second matrix to multiply
@@ -1056,18 +1476,19 @@ namespace theoretica {
 			}
 
 			mat_zeroes(R);
-			
-			for (unsigned int i = 0; i < A.rows(); ++i)
-				for (unsigned int j = 0; j < B.cols(); ++j)
-					for (unsigned int k = 0; k < A.cols(); ++k)
-						R(i, j) += A(i, k) * B(k, j);
 
-			return R;
+			return _internal::gemm(
+				R,
+				[&A](unsigned int i, unsigned int k) { return A(i, k); },
+				[&B](unsigned int k, unsigned int j) { return B(k, j); },
+				A.rows(), B.cols(), A.cols()
+			);
 		}
 
 
 		/// Multiply two matrices and store the result in another matrix,
 		/// equivalent to the operation \f$R = A B\f$.
+		/// A cache-blocked kernel is used for big matrices.
 		///
 		/// @param R The matrix to overwrite with the result
 		/// @param A The first matrix to multiply
@@ -1093,12 +1514,12 @@ namespace theoretica {
 
 			mat_zeroes(R);
 
-			for (unsigned int i = 0; i < A.rows(); ++i)
-				for (unsigned int j = 0; j < B.cols(); ++j)
-					for (unsigned int k = 0; k < A.cols(); ++k)
-						R(i, j) += A(i, k) * B(k, j);
-
-			return R;
+			return _internal::gemm(
+				R,
+				[&A](unsigned int i, unsigned int k) { return A(i, k); },
+				[&B](unsigned int k, unsigned int j) { return B(k, j); },
+				A.rows(), B.cols(), A.cols()
+			);
 		}
 
 
@@ -1125,12 +1546,12 @@ namespace theoretica {
 
 			mat_zeroes(R);
 
-			for (unsigned int i = 0; i < R.rows(); ++i)
-				for (unsigned int j = 0; j < R.cols(); ++j)
-					for (unsigned int k = 0; k < A.rows(); ++k)
-						R(i, j) += A(k, i) * B(k, j);
-
-			return R;
+			return _internal::gemm(
+				R,
+				[&A](unsigned int i, unsigned int k) { return A(k, i); },
+				[&B](unsigned int k, unsigned int j) { return B(k, j); },
+				A.cols(), B.cols(), A.rows()
+			);
 		}
 
 
@@ -1157,12 +1578,12 @@ namespace theoretica {
 
 			mat_zeroes(R);
 
-			for (unsigned int i = 0; i < R.rows(); ++i)
-				for (unsigned int j = 0; j < R.cols(); ++j)
-					for (unsigned int k = 0; k < A.cols(); ++k)
-						R(i, j) += A(i, k) * B(j, k);
-
-			return R;
+			return _internal::gemm(
+				R,
+				[&A](unsigned int i, unsigned int k) { return A(i, k); },
+				[&B](unsigned int k, unsigned int j) { return B(j, k); },
+				A.rows(), B.rows(), A.cols()
+			);
 		}
 
 
@@ -1199,13 +1620,16 @@ namespace theoretica {
 		/// @param v2 The second vector to add
 		/// @return A reference to the overwritten vector
 		template<typename Vector1, typename Vector2>
-		inline Vector2& vec_sum(Vector1& v1, const Vector2& v2) {
+		inline Vector1& vec_sum(Vector1& v1, const Vector2& v2) {
 
 			if(v1.size() != v2.size()) {
 				TH_MATH_ERROR("algebra::vec_sum", v1.size(), MathError::InvalidArgument);
 				return vec_error(v1);
 			}
 
+			if (_internal::simd_lincomb(v1, 1, v1, 1, v2, v1.size()))
+				return v1;
+
 			for (unsigned int i = 0; i < v1.size(); ++i)
 				v1[i] = v1[i] + v2[i];
 
@@ -1231,6 +1655,9 @@ namespace theoretica {
 				return vec_error(res);
 			}
 
+			if (_internal::simd_lincomb(res, 1, v1, 1, v2, v1.size()))
+				return res;
+
 			for (unsigned int i = 0; i < v1.size(); ++i)
 				res[i] = v1[i] + v2[i];
 
@@ -1244,7 +1671,7 @@ namespace theoretica {
 		/// @param v2 The second vector
 		/// @return A reference to the overwritten vector
 		template<typename Vector1, typename Vector2>
-		inline Vector2& vec_diff(Vector1& v1, const Vector2& v2) {
+		inline Vector1& vec_diff(Vector1& v1, const Vector2& v2) {
 
 			if(v1.size() != v2.size()) {
 				TH_MATH_ERROR("algebra::vec_diff", v1.size(), MathError::InvalidArgument);
@@ -1512,6 +1939,115 @@ namespace theoretica {
 		}
 
 
+		/// Decompose a square matrix in-place to two triangular matrices
+		/// using partial pivoting, so that \f$PA = LU\f$ where \f$P\f$ is
+		/// a permutation matrix. The matrix A is overwritten with the elements
+		/// of both L and U, omitting the diagonal of L (equal to all ones),
+		/// while the permutation is stored as a vector of row indices,
+		/// so that the i-th row of \f$PA\f$ is the perm[i]-th row of A.
+		///
+		/// The decomposition is right-looking and blocked: panels of
+		/// ALGEBRA_LU_BLOCK columns are factorized one at a time, then the
+		/// trailing submatrix is updated using the blocked matrix product.
+		/// Singular matrices are decomposed without errors, leaving
+		/// zero elements on the diagonal of U.
+		///
+		/// @param A The matrix to decompose and overwrite
+		/// @param perm The vector of indices to overwrite with the row permutation
+		/// @return A reference to the overwritten matrix A
+		template<typename Matrix, typename Permutation>
+		inline Matrix& decompose_lu_pivot_inplace(Matrix& A, Permutation& perm) {
+
+			using Type = matrix_element_t<Matrix>;
+			const unsigned int n = A.rows();
+
+			perm.resize(n);
+
+			if (!is_square(A)) {
+				TH_MATH_ERROR("algebra::decompose_lu_pivot_inplace", A.rows(), MathError::InvalidArgument);
+				return mat_error(A);
+			}
+
+			for (unsigned int i = 0; i < n; ++i)
+				perm[i] = i;
+
+			for (unsigned int k0 = 0; k0 < n; k0 += ALGEBRA_LU_BLOCK) {
+
+				const unsigned int k1 = min(k0 + ALGEBRA_LU_BLOCK, n);
+
+				// Factorize the panel of columns [k0, k1)
+				for (unsigned int j = k0; j < k1; ++j) {
+
+					// Find the pivot with the largest absolute value
+					unsigned int p = j;
+					real max_abs = abs(A(j, j));
+
+					for (unsigned int i = j + 1; i < n; ++i) {
+
+						const real a = abs(A(i, j));
+
+						if (a > max_abs) {
+							max_abs = a;
+							p = i;
+						}
+					}
+
+					// Swap the whole rows, so that the permutation
+					// is also applied to the already factorized columns
+					if (p != j) {
+
+						for (unsigned int k = 0; k < n; ++k) {
+							const Type tmp = A(j, k);
+							A(j, k) = A(p, k);
+							A(p, k) = tmp;
+						}
+
+						const auto tmp = perm[j];
+						perm[j] = perm[p];
+						perm[p] = tmp;
+					}
+
+					// Skip the elimination for a null column
+					if (A(j, j) == Type(0.0))
+						continue;
+
+					const Type inv_pivot = Type(1.0) / A(j, j);
+
+					for (unsigned int i = j + 1; i < n; ++i)
+						A(i, j) *= inv_pivot;
+
+					// Update the remaining columns of the panel
+					for (unsigned int k = j + 1; k < k1; ++k)
+						for (unsigned int i = j + 1; i < n; ++i)
+							A(i, k) -= A(i, j) * A(j, k);
+				}
+
+				if (k1 == n)
+					break;
+
+				// Compute the block row of U by solving L11 U12 = A12
+				for (unsigned int k = k1; k < n; ++k)
+					for (unsigned int i = k0 + 1; i < k1; ++i)
+						for (unsigned int l = k0; l < i; ++l)
+							A(i, k) -= A(i, l) * A(l, k);
+
+				// Update the trailing submatrix, A22 = A22 - L21 U12
+				auto A22 = [&A, k1](unsigned int i, unsigned int j) -> Type& {
+					return A(k1 + i, k1 + j);
+				};
+
+				_internal::gemm(
+					A22,
+					[&A, k0, k1](unsigned int i, unsigned int k) { return -A(k1 + i, k0 + k); },
+					[&A, k0, k1](unsigned int k, unsigned int j) { return A(k0 + k, k1 + j); },
+					n - k1, n - k1, k1 - k0
+				);
+			}
+
+			return A;
+		}
+
+
 		/// Decompose a symmetric positive definite matrix into
 		/// a triangular matrix so that \f$A = L L^T\f$ using
 		/// Cholesky decomposition.
@@ -1556,7 +2092,7 @@ namespace theoretica {
 							return mat_error(L);
 						}
 
-						L(i, j) = sqrt(sqr_diag);
+						L(i, j) = Type(sqrt(sqr_diag));
 
 					} else {
 
@@ -1592,7 +2128,14 @@ namespace theoretica {
 			// Compute the Cholesky decomposition in-place
 			for (unsigned int k = 0; k < A.rows(); ++k) {
 
-				A(k, k) = sqrt(A(k, k));
+				// Check that the matrix is positive definite, which may
+				// fail because of rounding for ill-conditioned matrices
+				if (!(A(k, k) > Type(0.0))) {
+					TH_MATH_ERROR("algebra::decompose_cholesky_inplace", A(k, k), MathError::InvalidArgument);
+					return mat_error(A);
+				}
+
+				A(k, k) = Type(sqrt(A(k, k)));
 
 				for (unsigned int i = k + 1; i < A.rows(); ++i)
 					A(i, k) = A(i, k) / A(k, k);
@@ -1612,6 +2155,312 @@ namespace theoretica {
 		}
 
 
+		/// Update the Cholesky decomposition of a symmetric positive
+		/// definite matrix in-place after a rank-one update of the matrix,
+		/// so that the result is the decomposition of \f$A + \vec v \vec v^T\f$,
+		/// given the decomposition \f$A = L L^T\f$. The factor is updated
+		/// with a sequence of Givens rotations, with \f$O(n^2)\f$ complexity
+		/// instead of the \f$O(n^3)\f$ needed to decompose the matrix again.
+		///
+		/// @param L The lower triangular factor of the decomposition,
+		/// overwritten with the factor of the updated matrix
+		/// @param v The vector of the rank-one update
+		/// @return A reference to the overwritten factor
+		template<typename Matrix, typename Vector>
+		inline Matrix& cholesky_update(Matrix& L, const Vector& v) {
+
+			using Type = matrix_element_t<Matrix>;
+
+			if (!is_square(L)) {
+				TH_MATH_ERROR("algebra::cholesky_update", L.rows(), MathError::InvalidArgument);
+				return mat_error(L);
+			}
+
+			if (v.size() != L.rows()) {
+				TH_MATH_ERROR("algebra::cholesky_update", v.size(), MathError::InvalidArgument);
+				return mat_error(L);
+			}
+
+			// Working copy of the vector, rotated at each step
+			std::vector<Type> x (v.size());
+
+			for (unsigned int i = 0; i < v.size(); ++i)
+				x[i] = v[i];
+
+			for (unsigned int k = 0; k < L.rows(); ++k) {
+
+				const Type r = Type(sqrt(L(k, k) * L(k, k) + x[k] * x[k]));
+				const Type c = r / L(k, k);
+				const Type s = x[k] / L(k, k);
+				L(k, k) = r;
+
+				for (unsigned int i = k + 1; i < L.rows(); ++i) {
+					L(i, k) = (L(i, k) + s * x[i]) / c;
+					x[i] = c * x[i] - s * L(i, k);
+				}
+			}
+
+			return L;
+		}
+
+
+		/// Downdate the Cholesky decomposition of a symmetric positive
+		/// definite matrix in-place after a rank-one downdate of the matrix,
+		/// so that the result is the decomposition of \f$A - \vec v \vec v^T\f$,
+		/// given the decomposition \f$A = L L^T\f$, with \f$O(n^2)\f$ complexity.
+		/// The downdated matrix must still be positive definite,
+		/// an error is raised otherwise.
+		///
+		/// @param L The lower triangular factor of the decomposition,
+		/// overwritten with the factor of the downdated matrix
+		/// @param v The vector of the rank-one downdate
+		/// @return A reference to the overwritten factor
+		template<typename Matrix, typename Vector>
+		inline Matrix& cholesky_downdate(Matrix& L, const Vector& v) {
+
+			using Type = matrix_element_t<Matrix>;
+
+			if (!is_square(L)) {
+				TH_MATH_ERROR("algebra::cholesky_downdate", L.rows(), MathError::InvalidArgument);
+				return mat_error(L);
+			}
+
+			if (v.size() != L.rows()) {
+				TH_MATH_ERROR("algebra::cholesky_downdate", v.size(), MathError::InvalidArgument);
+				return mat_error(L);
+			}
+
+			// Working copy of the vector, rotated at each step
+			std::vector<Type> x (v.size());
+
+			for (unsigned int i = 0; i < v.size(); ++i)
+				x[i] = v[i];
+
+			for (unsigned int k = 0; k < L.rows(); ++k) {
+
+				const Type sqr_diag = L(k, k) * L(k, k) - x[k] * x[k];
+
+				// The downdated matrix is not positive definite
+				if (!(sqr_diag > Type(0.0))) {
+					TH_MATH_ERROR("algebra::cholesky_downdate", sqr_diag, MathError::InvalidArgument);
+					return mat_error(L);
+				}
+
+				const Type r = Type(sqrt(sqr_diag));
+				const Type c = r / L(k, k);
+				const Type s = x[k] / L(k, k);
+				L(k, k) = r;
+
+				for (unsigned int i = k + 1; i < L.rows(); ++i) {
+					L(i, k) = (L(i, k) - s * x[i]) / c;
+					x[i] = c * x[i] - s * L(i, k);
+				}
+			}
+
+			return L;
+		}
+
+
+		namespace _internal {
+
+
+			/// Compute the Householder reflections of the columns [j0, j1)
+			/// of a matrix in-place, applying each reflection only
+			/// to the following columns of the same panel.
+			///
+			/// @param A The matrix to decompose and overwrite
+			/// @param tau The vector to write the scalar factors to
+			/// @param j0 The first column of the panel
+			/// @param j1 The end of the panel (excluded)
+			template<typename Matrix, typename Vector>
+			inline void qr_panel(Matrix& A, Vector& tau, unsigned int j0, unsigned int j1) {
+
+				using Type = matrix_element_t<Matrix>;
+				const unsigned int m = A.rows();
+
+				for (unsigned int j = j0; j < j1; ++j) {
+
+					// Norm of the column under the diagonal
+					Type sqr_norm = Type(0.0);
+
+					for (unsigned int i = j + 1; i < m; ++i)
+						sqr_norm += A(i, j) * A(i, j);
+
+					if (sqr_norm == Type(0.0)) {
+						tau[j] = Type(0.0);
+						continue;
+					}
+
+					// Choose the sign of beta to avoid cancellation
+					const Type alpha = A(j, j);
+					const Type norm = sqrt(alpha * alpha + sqr_norm);
+					const Type beta = (alpha >= Type(0.0)) ? -norm : norm;
+
+					tau[j] = (beta - alpha) / beta;
+
+					const Type scale = Type(1.0) / (alpha - beta);
+
+					for (unsigned int i = j + 1; i < m; ++i)
+						A(i, j) *= scale;
+
+					A(j, j) = beta;
+
+					// Apply the reflection to the remaining columns of the panel
+					for (unsigned int c = j + 1; c < j1; ++c) {
+
+						Type w = A(j, c);
+
+						for (unsigned int i = j + 1; i < m; ++i)
+							w += A(i, j) * A(i, c);
+
+						w *= tau[j];
+						A(j, c) -= w;
+
+						for (unsigned int i = j + 1; i < m; ++i)
+							A(i, c) -= w * A(i, j);
+					}
+				}
+			}
+		}
+
+
+		/// Decompose a matrix in-place using Householder reflections,
+		/// so that \f$A = QR\f$ where Q is orthogonal and R is upper triangular.
+		/// The matrix may have more rows than columns. On return, the upper
+		/// triangle of A contains R, while the elements under the diagonal
+		/// contain the Householder vectors \f$v_j\f$ (whose first element,
+		/// equal to one, is omitted), so that \f$Q = H_0 H_1 ... H_{k-1}\f$
+		/// with \f$H_j = I - \tau_j v_j v_j^T\f$. Only real matrices are supported.
+		///
+		/// The decomposition is blocked: the reflections of each panel of
+		/// ALGEBRA_QR_BLOCK columns are accumulated in the compact WY form
+		/// \f$I - V T V^T\f$ and applied to the trailing columns
+		/// using the blocked matrix product.
+		///
+		/// @param A The matrix to decompose and overwrite
+		/// @param tau The vector to overwrite with the scalar factors
+		/// of the Householder reflections
+		/// @return A reference to the overwritten matrix
+		template<typename Matrix, typename Vector>
+		inline Matrix& decompose_qr_inplace(Matrix& A, Vector& tau) {
+
+			using Type = matrix_element_t<Matrix>;
+
+			const unsigned int m = A.rows();
+			const unsigned int n = A.cols();
+			const unsigned int k = min(m, n);
+
+			tau.resize(k);
+
+			if (m < n) {
+				TH_MATH_ERROR("algebra::decompose_qr_inplace", A.rows(), MathError::InvalidArgument);
+				vec_error(tau);
+				return mat_error(A);
+			}
+
+			// Buffers for the triangular factor T and for the product W = V^T C
+			std::vector<Type> T_buff;
+			std::vector<Type> W_buff;
+
+			for (unsigned int j0 = 0; j0 < k; j0 += ALGEBRA_QR_BLOCK) {
+
+				const unsigned int j1 = min(j0 + ALGEBRA_QR_BLOCK, k);
+				const unsigned int jb = j1 - j0;
+
+				_internal::qr_panel(A, tau, j0, j1);
+
+				if (j1 == n)
+					break;
+
+				// Householder vectors of the panel, with implicit unit diagonal
+				auto V = [&A, j0](unsigned int i, unsigned int r) -> Type {
+					return (i == r) ? Type(1.0) : ((i > r) ? A(j0 + i, j0 + r) : Type(0.0));
+				};
+
+				// Form the upper triangular factor T of the compact WY form
+				T_buff.assign(jb * jb, Type(0.0));
+				auto T = [&T_buff, jb](unsigned int r, unsigned int c) -> Type& {
+					return T_buff[r + c * jb];
+				};
+
+				for (unsigned int i = 0; i < jb; ++i) {
+
+					T(i, i) = tau[j0 + i];
+
+					// Compute w = V(:, 0:i)^T v_i into the column of T
+					for (unsigned int r = 0; r < i; ++r) {
+
+						Type w = A(j0 + i, j0 + r);
+
+						for (unsigned int l = j0 + i + 1; l < m; ++l)
+							w += A(l, j0 + r) * A(l, j0 + i);
+
+						T(r, i) = w;
+					}
+
+					// Compute T(0:i, i) = -tau_i T(0:i, 0:i) w
+					for (unsigned int r = 0; r < i; ++r) {
+
+						Type sum = Type(0.0);
+
+						for (unsigned int q = r; q < i; ++q)
+							sum += T(r, q) * T(q, i);
+
+						T(r, i) = sum;
+					}
+
+					for (unsigned int r = 0; r < i; ++r)
+						T(r, i) *= -tau[j0 + i];
+				}
+
+				// Apply the block reflector H^T = I - V T^T V^T
+				// to the trailing columns C = A(j0:m, j1:n)
+				const unsigned int nc = n - j1;
+				W_buff.assign(jb * nc, Type(0.0));
+
+				auto W = [&W_buff, jb](unsigned int r, unsigned int c) -> Type& {
+					return W_buff[r + c * jb];
+				};
+
+				// W = V^T C
+				_internal::gemm(
+					W,
+					[&V](unsigned int r, unsigned int l) { return V(l, r); },
+					[&A, j0, j1](unsigned int l, unsigned int c) { return A(j0 + l, j1 + c); },
+					jb, nc, m - j0
+				);
+
+				// W = T^T W, proceeding backwards to overwrite W in-place
+				for (unsigned int c = 0; c < nc; ++c) {
+
+					for (int r = jb - 1; r >= 0; --r) {
+
+						Type sum = Type(0.0);
+
+						for (int q = 0; q <= r; ++q)
+							sum += T(q, r) * W(q, c);
+
+						W(r, c) = sum;
+					}
+				}
+
+				// C = C - V W
+				auto C = [&A, j0, j1](unsigned int i, unsigned int c) -> Type& {
+					return A(j0 + i, j1 + c);
+				};
+
+				_internal::gemm(
+					C,
+					[&V](unsigned int i, unsigned int r) { return -V(i, r); },
+					[&W](unsigned int r, unsigned int c) { return W(r, c); },
+					m - j0, nc, jb
+				);
+			}
+
+			return A;
+		}
+
+
 		// Linear system solvers
 
 
@@ -1778,21 +2627,67 @@ namespace theoretica {
 		}
 
 
+		/// Solve the linear system \f$A \vec x = \vec b\f$ using the
+		/// in-place LU decomposition with partial pivoting of A, as computed by
+		/// decompose_lu_pivot_inplace, applying the row permutation to the known
+		/// vector and then using forward and backward elimination.
+		/// The input vector is overwritten with the solution.
+		///
+		/// @param A The matrix of the linear system, after in-place pivoted LU decomposition
+		/// @param perm The row permutation of the decomposition
+		/// @param b The known vector, to be overwritten with the solution
+		/// @return A reference to the overwritten vector solution
+		template<typename Matrix, typename Permutation, typename Vector>
+		inline Vector& solve_lu_pivot_inplace(const Matrix& A, const Permutation& perm, Vector& b) {
+
+			if (perm.size() != b.size()) {
+				TH_MATH_ERROR("algebra::solve_lu_pivot_inplace", perm.size(), MathError::InvalidArgument);
+				return vec_error(b);
+			}
+
+			// Apply the row permutation to the known vector in-place,
+			// rotating the elements of each cycle starting from its first index
+			for (unsigned int i = 0; i < b.size(); ++i) {
+
+				unsigned int j = perm[i];
+
+				while (j > i)
+					j = perm[j];
+
+				if (j < i)
+					continue;
+
+				const auto tmp = b[i];
+
+				for (j = i; perm[j] != i; j = perm[j])
+					b[j] = b[perm[j]];
+
+				b[j] = tmp;
+			}
+
+			return solve_lu_inplace(A, b);
+		}
+
+
 		/// Solve the linear system \f$A \vec x = \vec b\f$, finding \f$\vec x\f$.
-		/// In-place LU decomposition is used on a copy of A, followed by forward and backward
-		/// elimination.
+		/// In-place LU decomposition with partial pivoting is used on a copy of A,
+		/// followed by forward and backward elimination.
 		/// 
 		/// @param A The matrix of the linear system
 		/// @param b The known vector
 		/// @return The unknown vector
 		template<typename Matrix, typename Vector>
-		inline Vector solve_lu(Matrix A, Vector b) {
+		inline Vector solve_lu(const Matrix& A, const Vector& b) {
+
+			Matrix LU = algebra::clone(A);
+			Vector x = algebra::clone(b);
 
-			// Apply in-place LU decomposition
-			decompose_lu_inplace(A);
+			// Apply in-place LU decomposition with partial pivoting
+			std::vector<unsigned int> perm;
+			decompose_lu_pivot_inplace(LU, perm);
 
 			// Apply forward and backward substitution
-			return solve_lu_inplace(A, b);
+			return solve_lu_pivot_inplace(LU, perm, x);
 		}
 
 
@@ -1809,7 +2704,7 @@ namespace theoretica {
 		template<typename Matrix1, typename Matrix2, typename Vector>
 		inline Vector solve_lu(const Matrix1& L, const Matrix2& U, const Vector& b) {
 
-			Vector x = b;
+			Vector x = algebra::clone(b);
 
 			if (!is_square(L)) {
 				TH_MATH_ERROR("algebra::solve_lu", L.rows(), MathError::InvalidArgument);
@@ -1880,7 +2775,7 @@ namespace theoretica {
 		template<typename Matrix, typename Vector>
 		inline Vector solve_cholesky(const Matrix& L, const Vector& b) {
 
-			Vector x = b;
+			Vector x = algebra::clone(b);
 
 			if (!is_square(L)) {
 				TH_MATH_ERROR("algebra::solve_cholesky", L.rows(), MathError::InvalidArgument);
@@ -1920,6 +2815,150 @@ namespace theoretica {
 		}
 
 
+		/// Multiply a vector by the transpose of the orthogonal matrix Q
+		/// of a QR decomposition, computed by decompose_qr_inplace,
+		/// applying the Householder reflections in order.
+		/// Equivalent to the operation \f$b = Q^T b\f$.
+		///
+		/// @param QR The matrix after in-place QR decomposition
+		/// @param tau The scalar factors of the Householder reflections
+		/// @param b The vector to transform and overwrite
+		/// @return A reference to the overwritten vector
+		template<typename Matrix, typename Vector1, typename Vector2>
+		inline Vector2& householder_qt_inplace(const Matrix& QR, const Vector1& tau, Vector2& b) {
+
+			if (QR.rows() != b.size()) {
+				TH_MATH_ERROR("algebra::householder_qt_inplace", b.size(), MathError::InvalidArgument);
+				return vec_error(b);
+			}
+
+			for (unsigned int j = 0; j < tau.size(); ++j) {
+
+				auto w = b[j];
+
+				for (unsigned int i = j + 1; i < QR.rows(); ++i)
+					w += QR(i, j) * b[i];
+
+				w *= tau[j];
+				b[j] -= w;
+
+				for (unsigned int i = j + 1; i < QR.rows(); ++i)
+					b[i] -= w * QR(i, j);
+			}
+
+			return b;
+		}
+
+
+		/// Multiply a vector by the orthogonal matrix Q of a QR
+		/// decomposition, computed by decompose_qr_inplace, applying
+		/// the Householder reflections in reverse order.
+		/// Equivalent to the operation \f$b = Q b\f$.
+		///
+		/// @param QR The matrix after in-place QR decomposition
+		/// @param tau The scalar factors of the Householder reflections
+		/// @param b The vector to transform and overwrite
+		/// @return A reference to the overwritten vector
+		template<typename Matrix, typename Vector1, typename Vector2>
+		inline Vector2& householder_q_inplace(const Matrix& QR, const Vector1& tau, Vector2& b) {
+
+			if (QR.rows() != b.size()) {
+				TH_MATH_ERROR("algebra::householder_q_inplace", b.size(), MathError::InvalidArgument);
+				return vec_error(b);
+			}
+
+			for (int j = int(tau.size()) - 1; j >= 0; --j) {
+
+				auto w = b[j];
+
+				for (unsigned int i = j + 1; i < QR.rows(); ++i)
+					w += QR(i, j) * b[i];
+
+				w *= tau[j];
+				b[j] -= w;
+
+				for (unsigned int i = j + 1; i < QR.rows(); ++i)
+					b[i] -= w * QR(i, j);
+			}
+
+			return b;
+		}
+
+
+		/// Use the QR decomposition of a matrix, computed by decompose_qr_inplace,
+		/// to solve the linear system \f$A \vec x = \vec b\f$. If the matrix
+		/// has more rows than columns, the least squares solution which
+		/// minimizes \f$||A \vec x - \vec b||\f$ is found.
+		///
+		/// @param QR The matrix after in-place QR decomposition
+		/// @param tau The scalar factors of the Householder reflections
+		/// @param b The known vector, with as many elements as the rows of the matrix
+		/// @return The vector solution, with as many elements as the columns of the matrix
+		template<typename Matrix, typename Vector1, typename Vector2>
+		inline Vector2 solve_qr(const Matrix& QR, const Vector1& tau, const Vector2& b) {
+
+			Vector2 x;
+			x.resize(QR.cols());
+
+			if (QR.rows() != b.size()) {
+				TH_MATH_ERROR("algebra::solve_qr", b.size(), MathError::InvalidArgument);
+				return vec_error(x);
+			}
+
+			// Compute Q^T b and keep its first elements
+			Vector2 y = algebra::clone(b);
+			householder_qt_inplace(QR, tau, y);
+
+			using Type = matrix_element_t<Matrix>;
+
+			// Backward elimination for R
+			for (int i = QR.cols() - 1; i >= 0; --i) {
+
+				if (abs(QR(i, i)) < MACH_EPSILON) {
+					TH_MATH_ERROR("algebra::solve_qr", QR(i, i), MathError::DivByZero);
+					return vec_error(x);
+				}
+
+				Type sum = Type(0.0);
+
+				for (unsigned int j = i + 1; j < QR.cols(); ++j)
+					sum += QR(i, j) * x[j];
+
+				x[i] = (y[i] - sum) / QR(i, i);
+			}
+
+			return x;
+		}
+
+
+		/// Find the least squares solution of the overdetermined linear
+		/// system \f$A \vec x = \vec b\f$, minimizing \f$||A \vec x - \vec b||\f$,
+		/// for a real matrix with at least as many rows as columns.
+		/// In-place QR decomposition is used on a copy of A, avoiding the
+		/// normal equations \f$A^T A \vec x = A^T \vec b\f$, which square
+		/// the condition number of the problem.
+		///
+		/// @param A The matrix of the linear system
+		/// @param b The known vector, with as many elements as the rows of A
+		/// @return The least squares solution, with as many elements as the columns of A
+		template<typename Matrix, typename Vector>
+		inline Vector solve_least_squares(const Matrix& A, const Vector& b) {
+
+			if (A.rows() != b.size()) {
+				TH_MATH_ERROR("algebra::solve_least_squares", b.size(), MathError::InvalidArgument);
+				Vector x;
+				x.resize(A.cols());
+				return vec_error(x);
+			}
+
+			Matrix QR = algebra::clone(A);
+			std::vector<matrix_element_t<Matrix>> tau;
+			decompose_qr_inplace(QR, tau);
+
+			return solve_qr(QR, tau, b);
+		}
+
+
 		/// Solve the linear system \f$A \vec x = \vec b\f$, finding \f$\vec x\f$
 		/// using the best available algorithm.
 		/// 
@@ -2072,21 +3111,57 @@ namespace theoretica {
 		}
 
 
+		/// Compute the sign of a permutation, given as a vector
+		/// of indices, equal to +1 for even permutations
+		/// and -1 for odd permutations.
+		///
+		/// @param perm The permutation of the indices from 0 to perm.size() - 1
+		/// @return The sign of the permutation
+		template<typename Permutation>
+		inline int permutation_sign(const Permutation& perm) {
+
+			std::vector<bool> visited (perm.size(), false);
+			int sign = 1;
+
+			// Each cycle of even length flips the sign
+			for (unsigned int i = 0; i < perm.size(); ++i) {
+
+				if (visited[i])
+					continue;
+
+				unsigned int length = 0;
+
+				for (unsigned int j = i; !visited[j]; j = perm[j]) {
+					visited[j] = true;
+					length++;
+				}
+
+				if (length % 2 == 0)
+					sign = -sign;
+			}
+
+			return sign;
+		}
+
+
 		/// Compute the determinant of a square matrix.
-		/// In-place LU decomposition is used to reduce the
-		/// matrix to triangular form.
+		/// In-place LU decomposition with partial pivoting
+		/// is used to reduce the matrix to triangular form.
 		///
 		/// @param A The matrix to compute the determinant of
 		/// @return The determinant of the matrix
 		template<typename Matrix>
 		inline auto det(const Matrix& A) {
 
-			Matrix LU = A;
-			decompose_lu_inplace(LU);
+			Matrix LU = algebra::clone(A);
+			std::vector<unsigned int> perm;
+			decompose_lu_pivot_inplace(LU, perm);
 
 			// The determinant of a triangular matrix
-			// is the product of the elements on its diagonal
-			return diagonal_product(LU);
+			// is the product of the elements on its diagonal,
+			// while each row swap changes its sign
+			const auto d = diagonal_product(LU);
+			return permutation_sign(perm) > 0 ? d : -d;
 		}
 
 
@@ -2145,7 +3220,7 @@ namespace theoretica {
 
 			// Apply a first iteration to initialize
 			// the current and previous vectors
-			Vector x_prev = x;
+			Vector x_prev = algebra::clone(x);
 			Vector x_curr = normalize(A * x_prev);
 
 			// Iteration counter
@@ -2211,7 +3286,7 @@ namespace theoretica {
 
 			// Apply a first iteration to initialize
 			// the current and previous vectors
-			Vector1 x_prev = x;
+			Vector1 x_prev = algebra::clone(x);
 			Vector1 x_curr = normalize(A * x_prev);
 
 			// Iteration counter
@@ -2273,12 +3348,12 @@ namespace theoretica {
 			}
 
 			// Compute the LU decomposition of A to speed up system solution
-			Matrix LU = A;
+			Matrix LU = algebra::clone(A);
 			decompose_lu_inplace(LU);
 
 			// Compute the first step to initialize the two vectors
 			Vector x_prev = normalize(x);
-			Vector x_curr = x_prev;
+			Vector x_curr = algebra::clone(x_prev);
 			solve_lu_inplace(LU, x_curr);
 
 			// Iteration counter
@@ -2339,12 +3414,12 @@ namespace theoretica {
 			}
 
 			// Compute the LU decomposition of A to speed up system solution
-			Matrix LU = A;
+			Matrix LU = algebra::clone(A);
 			decompose_lu_inplace(LU);
 
 			// Compute the first step to initialize the two vectors
 			Vector1 x_prev = normalize(x);
-			Vector1 x_curr = x_prev;
+			Vector1 x_curr = algebra::clone(x_prev);
 			solve_lu_inplace(LU, x_curr);
 
 			// Iteration counter
@@ -2408,7 +3483,7 @@ namespace theoretica {
 				return make_error<Vector>(A.rows());
 			}
 
-			Matrix LU = A;
+			Matrix LU = algebra::clone(A);
 			mat_shift_diagonal(LU, -lambda);
 
 			// Compute the LU decomposition of A
@@ -2417,7 +3492,7 @@ namespace theoretica {
 
 			// Compute the first step to initialize the two vectors
 			Vector v_prev = normalize(x);
-			Vector v_curr = v_prev;
+			Vector v_curr = algebra::clone(v_prev);
 			solve_lu_inplace(LU, v_curr);
 
 			// Iteration counter
@@ -2477,7 +3552,7 @@ namespace theoretica {
 			}
 
 			// Keep track of the shifted matrix
-			Matrix A_shift = A;
+			Matrix A_shift = algebra::clone(A);
 			mat_shift_diagonal(A_shift, -lambda);
 
 			Type lambda_prev = lambda;
@@ -2554,7 +3629,7 @@ namespace theoretica {
 			}
 
 			// Keep track of the shifted matrix
-			Matrix A_shift = A;
+			Matrix A_shift = algebra::clone(A);
 			mat_shift_diagonal(A_shift, -lambda);
 
 			Type lambda_prev = lambda;
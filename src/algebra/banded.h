@@ -0,0 +1,733 @@
+///
+/// @file banded.h Tridiagonal and banded matrices, stored by diagonals,
+/// with linear systems solvers of linear complexity in the size of the matrix.
+///
+
+#ifndef THEORETICA_BANDED_H
+#define THEORETICA_BANDED_H
+
+#include <vector>
+#include <algorithm>
+#include "../core/error.h"
+#include "../core/constants.h"
+#include "../core/core_traits.h"
+#include "../core/real_analysis.h"
+#include "../complex/complex_analysis.h"
+#include "./algebra.h"
+#include "./vec.h"
+#include "./factorization.h"
+
+
+namespace theoretica {
+
+
+	/// @class tridiag_mat
+	/// A square tridiagonal matrix, which only stores its
+	/// main diagonal and the two adjacent diagonals, for a
+	/// total of \f$3n - 2\f$ elements.
+	///
+	/// Elements are read-only through operator(), which makes tridiagonal
+	/// matrices usable as input to generic routines of the algebra namespace,
+	/// while the diagonals may be accessed directly as vectors.
+	///
+	/// @tparam Type The type of the elements
+	template<typename Type = real>
+	class tridiag_mat {
+		public:
+
+			/// The subdiagonal, so that lower[i] is the
+			/// element at row i + 1 and column i
+			std::vector<Type> lower;
+
+			/// The main diagonal
+			std::vector<Type> diag;
+
+			/// The superdiagonal, so that upper[i] is the
+			/// element at row i and column i + 1
+			std::vector<Type> upper;
+
+
+			/// Default constructor, creates an empty matrix
+			tridiag_mat() = default;
+
+
+			/// Construct a zero tridiagonal matrix of the given size.
+			///
+			/// @param n The number of rows and columns
+			tridiag_mat(unsigned int n) {
+				resize(n);
+			}
+
+
+			/// Construct a tridiagonal matrix from its diagonals.
+			///
+			/// @param lower The subdiagonal, of size n - 1
+			/// @param diag The main diagonal, of size n
+			/// @param upper The superdiagonal, of size n - 1
+			tridiag_mat(
+				const std::vector<Type>& lower,
+				const std::vector<Type>& diag,
+				const std::vector<Type>& upper)
+				: lower(lower), diag(diag), upper(upper) {
+
+				if (lower.size() + 1 != diag.size() || upper.size() + 1 != diag.size()) {
+					TH_MATH_ERROR("tridiag_mat::tridiag_mat", diag.size(), MathError::InvalidArgument);
+					resize(diag.size());
+					std::fill(this->diag.begin(), this->diag.end(), make_error<Type>());
+				}
+			}
+
+
+			/// Construct a tridiagonal matrix from the elements
+			/// of a square matrix on and adjacent to the diagonal,
+			/// ignoring all other elements.
+			///
+			/// @param A The matrix to convert
+			template<typename Matrix, enable_matrix<Matrix> = true>
+			tridiag_mat(const Matrix& A) {
+
+				resize(A.rows());
+
+				if (!algebra::is_square(A)) {
+					TH_MATH_ERROR("tridiag_mat::tridiag_mat", A.cols(), MathError::InvalidArgument);
+					std::fill(diag.begin(), diag.end(), make_error<Type>());
+					return;
+				}
+
+				for (unsigned int i = 0; i < diag.size(); ++i)
+					diag[i] = A(i, i);
+
+				for (unsigned int i = 0; i < upper.size(); ++i) {
+					lower[i] = A(i + 1, i);
+					upper[i] = A(i, i + 1);
+				}
+			}
+
+
+			/// Resize the matrix, setting all elements to zero.
+			///
+			/// @param n The number of rows and columns
+			inline void resize(unsigned int n) {
+
+				diag.assign(n, Type(0.0));
+				lower.assign(n ? n - 1 : 0, Type(0.0));
+				upper.assign(n ? n - 1 : 0, Type(0.0));
+			}
+
+
+			/// Get the element at the given row and column,
+			/// or zero if it lies outside of the three diagonals.
+			///
+			/// @param i The row index
+			/// @param j The column index
+			/// @return The value of the element
+			inline Type operator()(unsigned int i, unsigned int j) const {
+
+				if (i == j)
+					return diag[i];
+				else if (i == j + 1)
+					return lower[j];
+				else if (j == i + 1)
+					return upper[i];
+
+				return Type(0.0);
+			}
+
+
+			/// Get the number of rows of the matrix
+			inline unsigned int rows() const {
+				return diag.size();
+			}
+
+
+			/// Get the number of columns of the matrix
+			inline unsigned int cols() const {
+				return diag.size();
+			}
+
+
+			/// Apply the matrix to a vector, visiting only the three diagonals.
+			///
+			/// @param v The vector to transform
+			/// @return The transformed vector
+			template<typename Vector>
+			inline Vector transform(const Vector& v) const {
+
+				const unsigned int n = diag.size();
+
+				Vector res;
+				res.resize(n);
+
+				if (v.size() != n) {
+					TH_MATH_ERROR("tridiag_mat::transform", v.size(), MathError::InvalidArgument);
+					return algebra::vec_error(res);
+				}
+
+				for (unsigned int i = 0; i < n; ++i) {
+
+					Type sum = diag[i] * v[i];
+
+					if (i > 0)
+						sum += lower[i - 1] * v[i - 1];
+
+					if (i + 1 < n)
+						sum += upper[i] * v[i + 1];
+
+					res[i] = sum;
+				}
+
+				return res;
+			}
+
+
+			/// Apply the matrix to a vector, visiting only the three diagonals.
+			///
+			/// @param v The vector to transform
+			/// @return The transformed vector
+			template<typename Vector, enable_vector<Vector> = true>
+			inline Vector operator*(const Vector& v) const {
+				return transform(v);
+			}
+	};
+
+
+	/// @class banded_mat
+	/// A square banded matrix, with a given number of subdiagonals
+	/// and superdiagonals, which only stores the elements inside the band.
+	/// The band of each row is stored contiguously, so that the element
+	/// at row i and column j, with \f$-k_l \leq j - i \leq k_u\f$, is
+	/// stored in data at position \f$i (k_l + k_u + 1) + j - i + k_l\f$.
+	///
+	/// Elements are read-only through operator(), which makes banded
+	/// matrices usable as input to generic routines of the algebra namespace,
+	/// while elements inside the band are modified through at().
+	///
+	/// @tparam Type The type of the elements
+	template<typename Type = real>
+	class banded_mat {
+		public:
+
+			/// The elements inside the band, stored by rows,
+			/// with the elements outside of the matrix set to zero
+			std::vector<Type> data;
+
+
+		private:
+
+			/// Number of rows and columns
+			unsigned int n {0};
+
+			/// Number of subdiagonals
+			unsigned int kl {0};
+
+			/// Number of superdiagonals
+			unsigned int ku {0};
+
+
+		public:
+
+			/// Default constructor, creates an empty matrix
+			banded_mat() = default;
+
+
+			/// Construct a zero banded matrix with the given
+			/// size and number of subdiagonals and superdiagonals.
+			///
+			/// @param n The number of rows and columns
+			/// @param kl The number of subdiagonals
+			/// @param ku The number of superdiagonals
+			banded_mat(unsigned int n, unsigned int kl, unsigned int ku) {
+				resize(n, kl, ku);
+			}
+
+
+			/// Construct a banded matrix from the elements of a square
+			/// matrix inside the band, ignoring all other elements.
+			///
+			/// @param A The matrix to convert
+			/// @param kl The number of subdiagonals
+			/// @param ku The number of superdiagonals
+			template<typename Matrix, enable_matrix<Matrix> = true>
+			banded_mat(const Matrix& A, unsigned int kl, unsigned int ku) {
+
+				resize(A.rows(), kl, ku);
+
+				if (!algebra::is_square(A)) {
+					TH_MATH_ERROR("banded_mat::banded_mat", A.cols(), MathError::InvalidArgument);
+					std::fill(data.begin(), data.end(), make_error<Type>());
+					return;
+				}
+
+				for (unsigned int i = 0; i < n; ++i) {
+
+					const unsigned int j_begin = i > kl ? i - kl : 0;
+					const unsigned int j_end = std::min(n, i + ku + 1);
+
+					for (unsigned int j = j_begin; j < j_end; ++j)
+						at(i, j) = A(i, j);
+				}
+			}
+
+
+			/// Resize the matrix, setting all elements to zero.
+			///
+			/// @param n The number of rows and columns
+			/// @param kl The number of subdiagonals
+			/// @param ku The number of superdiagonals
+			inline void resize(unsigned int n, unsigned int kl, unsigned int ku) {
+
+				this->n = n;
+				this->kl = kl;
+				this->ku = ku;
+				data.assign(size_t(n) * (kl + ku + 1), Type(0.0));
+			}
+
+
+			/// Get a reference to an element inside the band
+			/// (no check on the indices is performed).
+			///
+			/// @param i The row index
+			/// @param j The column index, with \f$-k_l \leq j - i \leq k_u\f$
+			/// @return A reference to the element
+			inline Type& at(unsigned int i, unsigned int j) {
+				return data[size_t(i) * (kl + ku + 1) + j + kl - i];
+			}
+
+
+			/// Get an element inside the band
+			/// (no check on the indices is performed).
+			///
+			/// @param i The row index
+			/// @param j The column index, with \f$-k_l \leq j - i \leq k_u\f$
+			/// @return The value of the element
+			inline const Type& at(unsigned int i, unsigned int j) const {
+				return data[size_t(i) * (kl + ku + 1) + j + kl - i];
+			}
+
+
+			/// Get the element at the given row and column,
+			/// or zero if it lies outside of the band.
+			///
+			/// @param i The row index
+			/// @param j The column index
+			/// @return The value of the element
+			inline Type operator()(unsigned int i, unsigned int j) const {
+
+				if (j + kl < i || j > i + ku)
+					return Type(0.0);
+
+				return at(i, j);
+			}
+
+
+			/// Get the number of rows of the matrix
+			inline unsigned int rows() const {
+				return n;
+			}
+
+
+			/// Get the number of columns of the matrix
+			inline unsigned int cols() const {
+				return n;
+			}
+
+
+			/// Get the number of subdiagonals
+			inline unsigned int lower() const {
+				return kl;
+			}
+
+
+			/// Get the number of superdiagonals
+			inline unsigned int upper() const {
+				return ku;
+			}
+
+
+			/// Apply the matrix to a vector, visiting only the elements
+			/// inside the band. The rows of the result are computed in parallel
+			/// when the band holds at least ALGEBRA_BANDED_PARALLEL_MIN elements.
+			///
+			/// @param v The vector to transform
+			/// @return The transformed vector
+			template<typename Vector>
+			inline Vector transform(const Vector& v) const {
+
+				Vector res;
+				res.resize(n);
+
+				if (v.size() != n) {
+					TH_MATH_ERROR("banded_mat::transform", v.size(), MathError::InvalidArgument);
+					return algebra::vec_error(res);
+				}
+
+				#pragma omp parallel for if(n * (kl + ku + 1) >= ALGEBRA_BANDED_PARALLEL_MIN)
+				for (unsigned int i = 0; i < n; ++i) {
+
+					const unsigned int j_begin = i > kl ? i - kl : 0;
+					const unsigned int j_end = std::min(n, i + ku + 1);
+
+					Type sum = Type(0.0);
+
+					for (unsigned int j = j_begin; j < j_end; ++j)
+						sum += at(i, j) * v[j];
+
+					res[i] = sum;
+				}
+
+				return res;
+			}
+
+
+			/// Apply the matrix to a vector, visiting only the elements inside the band.
+			///
+			/// @param v The vector to transform
+			/// @return The transformed vector
+			template<typename Vector, enable_vector<Vector> = true>
+			inline Vector operator*(const Vector& v) const {
+				return transform(v);
+			}
+	};
+
+
+	namespace algebra {
+
+
+		/// Returns the matrix transformation of a vector by a
+		/// tridiagonal matrix, visiting only its three diagonals.
+		/// Equivalent to the operation A * v
+		///
+		/// @param A The tridiagonal matrix transformation
+		/// @param v The vector to transform
+		/// @return The transformed vector
+		template<typename Type, typename Vector>
+		inline Vector transform(const tridiag_mat<Type>& A, const Vector& v) {
+			return A.transform(v);
+		}
+
+
+		/// Returns the matrix transformation of a vector by a
+		/// banded matrix, visiting only the elements inside the band.
+		/// Equivalent to the operation A * v
+		///
+		/// @param A The banded matrix transformation
+		/// @param v The vector to transform
+		/// @return The transformed vector
+		template<typename Type, typename Vector>
+		inline Vector transform(const banded_mat<Type>& A, const Vector& v) {
+			return A.transform(v);
+		}
+
+
+		/// Solve the tridiagonal linear system \f$A \vec x = \vec b\f$ in place,
+		/// given the three diagonals of the matrix, using the Thomas algorithm
+		/// with \f$O(n)\f$ complexity. No pivoting is performed, so the matrix
+		/// should be diagonally dominant or symmetric positive definite,
+		/// as for the systems arising from splines and finite differences.
+		///
+		/// @param lower The subdiagonal, so that lower[i] is the element at row i + 1 and column i
+		/// @param diag The main diagonal
+		/// @param upper The superdiagonal, so that upper[i] is the element at row i and column i + 1
+		/// @param x The known vector, to be overwritten with the solution
+		/// @return A reference to the overwritten vector
+		template<typename Vector1, typename Vector2, typename Vector3, typename Vector>
+		inline Vector& solve_tridiagonal_inplace(
+			const Vector1& lower, const Vector2& diag, const Vector3& upper, Vector& x) {
+
+			using Type = vector_element_t<Vector>;
+			const size_t n = diag.size();
+
+			if (x.size() != n || lower.size() + 1 < n || upper.size() + 1 < n) {
+				TH_MATH_ERROR("algebra::solve_tridiagonal_inplace", x.size(), MathError::InvalidArgument);
+				return vec_error(x);
+			}
+
+			if (n == 0)
+				return x;
+
+			// Modified superdiagonal of the forward sweep
+			std::vector<Type> c (n);
+			Type pivot = diag[0];
+
+			for (size_t i = 0; ; ++i) {
+
+				if (abs(pivot) <= MACH_EPSILON) {
+					TH_MATH_ERROR("algebra::solve_tridiagonal_inplace", pivot, MathError::DivByZero);
+					return vec_error(x);
+				}
+
+				x[i] /= pivot;
+
+				if (i + 1 == n)
+					break;
+
+				c[i] = upper[i] / pivot;
+				pivot = diag[i + 1] - lower[i] * c[i];
+				x[i + 1] -= lower[i] * x[i];
+			}
+
+			// Back substitution
+			for (size_t i = n - 1; i > 0; --i)
+				x[i - 1] -= c[i - 1] * x[i];
+
+			return x;
+		}
+
+
+		/// Solve the tridiagonal linear system \f$A \vec x = \vec b\f$,
+		/// using the Thomas algorithm with \f$O(n)\f$ complexity.
+		/// No pivoting is performed, so the matrix should be diagonally
+		/// dominant or symmetric positive definite.
+		///
+		/// @param A The tridiagonal matrix
+		/// @param b The known vector
+		/// @return The unknown vector
+		template<typename Type, typename Vector>
+		inline Vector solve(const tridiag_mat<Type>& A, const Vector& b) {
+
+			Vector x = algebra::clone(b);
+			return solve_tridiagonal_inplace(A.lower, A.diag, A.upper, x);
+		}
+	}
+
+
+	/// @class banded_lu_factor
+	/// LU decomposition with partial pivoting of a square banded matrix,
+	/// so that \f$PA = LU\f$, with \f$O(n k_l (k_l + k_u))\f$ complexity.
+	/// Row exchanges widen the band of U to \f$k_l + k_u\f$ superdiagonals,
+	/// so the factors are stored in a banded matrix with the same number
+	/// of subdiagonals and \f$k_l\f$ additional superdiagonals.
+	/// As in LAPACK's gbtrf, the multipliers of L are stored in the order
+	/// in which they were computed, so that row exchanges and elimination
+	/// steps are interleaved when solving a system, with \f$O(n (2 k_l + k_u))\f$
+	/// cost for each known vector.
+	///
+	/// @tparam Type The type of the elements
+	template<typename Type = real>
+	class banded_lu_factor {
+		public:
+
+			/// The type of the elements of the factorization
+			using value_type = Type;
+
+			/// The L and U factors stored in the same banded matrix,
+			/// omitting the diagonal of L (equal to all ones)
+			banded_mat<Type> LU;
+
+			/// The row exchanges, so that row k was exchanged
+			/// with row pivots[k] at the k-th elimination step
+			std::vector<unsigned int> pivots;
+
+
+			/// Default constructor, the factorization
+			/// needs to be computed using decompose().
+			banded_lu_factor() = default;
+
+
+			/// Construct the factorization of a banded matrix.
+			///
+			/// @param A The matrix to decompose
+			banded_lu_factor(const banded_mat<Type>& A) {
+				decompose(A);
+			}
+
+
+			/// Compute the factorization of a banded matrix,
+			/// overwriting any previous factorization.
+			///
+			/// @param A The matrix to decompose
+			/// @return A reference to the factorization
+			inline banded_lu_factor& decompose(const banded_mat<Type>& A) {
+
+				const unsigned int n = A.rows();
+				const unsigned int kl = A.lower();
+				const unsigned int ku = A.upper();
+
+				LU.resize(n, kl, kl + ku);
+				pivots.resize(n);
+
+				for (unsigned int i = 0; i < n; ++i) {
+
+					const unsigned int j_begin = i > kl ? i - kl : 0;
+					const unsigned int j_end = std::min(n, i + ku + 1);
+
+					for (unsigned int j = j_begin; j < j_end; ++j)
+						LU.at(i, j) = A.at(i, j);
+				}
+
+				for (unsigned int k = 0; k < n; ++k) {
+
+					const unsigned int i_end = std::min(n, k + kl + 1);
+					const unsigned int j_end = std::min(n, k + kl + ku + 1);
+
+					// Find the pivot inside the band of the column
+					unsigned int p = k;
+					auto p_abs = abs(LU.at(k, k));
+
+					for (unsigned int i = k + 1; i < i_end; ++i) {
+
+						const auto a = abs(LU.at(i, k));
+
+						if (a > p_abs) {
+							p = i;
+							p_abs = a;
+						}
+					}
+
+					pivots[k] = p;
+
+					if (p_abs <= MACH_EPSILON) {
+						TH_MATH_ERROR("banded_lu_factor::decompose", p_abs, MathError::DivByZero);
+						std::fill(LU.data.begin(), LU.data.end(), make_error<Type>());
+						return *this;
+					}
+
+					if (p != k)
+						for (unsigned int j = k; j < j_end; ++j)
+							std::swap(LU.at(k, j), LU.at(p, j));
+
+					const Type inv_pivot = Type(1.0) / LU.at(k, k);
+
+					for (unsigned int i = k + 1; i < i_end; ++i) {
+
+						const Type l = LU.at(i, k) * inv_pivot;
+						LU.at(i, k) = l;
+
+						for (unsigned int j = k + 1; j < j_end; ++j)
+							LU.at(i, j) -= l * LU.at(k, j);
+					}
+				}
+
+				return *this;
+			}
+
+
+			/// Solve the linear system \f$A \vec x = \vec b\f$
+			/// using the factorization, overwriting the known vector
+			/// with the solution.
+			///
+			/// @param b The known vector, to be overwritten with the solution
+			/// @return A reference to the overwritten vector
+			template<typename Vector>
+			inline Vector& solve_inplace(Vector& b) const {
+
+				const unsigned int n = LU.rows();
+				const unsigned int kl = LU.lower();
+				const unsigned int ku = LU.upper();
+
+				if (b.size() != n) {
+					TH_MATH_ERROR("banded_lu_factor::solve_inplace", b.size(), MathError::InvalidArgument);
+					return algebra::vec_error(b);
+				}
+
+				// Forward substitution, interleaved with the row exchanges
+				for (unsigned int k = 0; k < n; ++k) {
+
+					if (pivots[k] != k)
+						std::swap(b[k], b[pivots[k]]);
+
+					const unsigned int i_end = std::min(n, k + kl + 1);
+
+					for (unsigned int i = k + 1; i < i_end; ++i)
+						b[i] -= LU.at(i, k) * b[k];
+				}
+
+				// Backward substitution
+				for (unsigned int i = n; i > 0; --i) {
+
+					const unsigned int r = i - 1;
+					const unsigned int j_end = std::min(n, r + ku + 1);
+
+					auto sum = b[r];
+
+					for (unsigned int j = r + 1; j < j_end; ++j)
+						sum -= LU.at(r, j) * b[j];
+
+					b[r] = sum / LU.at(r, r);
+				}
+
+				return b;
+			}
+
+
+			/// Solve the linear system \f$A \vec x = \vec b\f$
+			/// using the factorization.
+			///
+			/// @param b The known vector
+			/// @return The solution of the linear system
+			template<typename Vector>
+			inline Vector solve(const Vector& b) const {
+
+				Vector x = algebra::clone(b);
+				return solve_inplace(x);
+			}
+
+
+			/// Solve the linear system \f$A X = B\f$ for many known
+			/// vectors at once, given as the columns of a matrix.
+			///
+			/// @param B The matrix of known vectors
+			/// @return The matrix whose columns are the solutions
+			template<typename Matrix>
+			inline Matrix solve_many(const Matrix& B) const {
+				return _internal::solve_columns(*this, B);
+			}
+
+
+			/// Compute the determinant of the decomposed matrix,
+			/// as the product of the diagonal of U and the sign
+			/// of the row exchanges.
+			///
+			/// @return The determinant of the matrix
+			inline Type det() const {
+
+				Type d = Type(1.0);
+
+				for (unsigned int k = 0; k < LU.rows(); ++k)
+					d *= (pivots[k] != k) ? -LU.at(k, k) : LU.at(k, k);
+
+				return d;
+			}
+
+
+			/// Get the number of rows of the decomposed matrix.
+			inline unsigned int rows() const {
+				return LU.rows();
+			}
+
+
+			/// Get the number of columns of the decomposed matrix.
+			inline unsigned int cols() const {
+				return LU.cols();
+			}
+	};
+
+
+	namespace algebra {
+
+
+		/// Solve the banded linear system \f$A \vec x = \vec b\f$,
+		/// using LU decomposition with partial pivoting restricted
+		/// to the band, with \f$O(n k_l (k_l + k_u))\f$ complexity.
+		/// To solve many systems with the same matrix, construct
+		/// a banded_lu_factor once instead.
+		///
+		/// @param A The banded matrix
+		/// @param b The known vector
+		/// @return The unknown vector
+		template<typename Type, typename Vector>
+		inline Vector solve(const banded_mat<Type>& A, const Vector& b) {
+
+			Vector x = algebra::clone(b);
+
+			if (b.size() != A.rows()) {
+				TH_MATH_ERROR("algebra::solve", b.size(), MathError::InvalidArgument);
+				return vec_error(x);
+			}
+
+			return banded_lu_factor<Type>(A).solve_inplace(x);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,822 @@
+///
+/// @file batch.h Batches of small fixed-size matrices and vectors,
+/// stored in structure-of-arrays form so that the same operation is applied
+/// to many entries at once, with each SIMD lane mapped to a different entry
+/// of the batch. This is useful when transforming a large number of small
+/// systems, such as rotations or coordinate changes of many points.
+/// The overloads writing to an existing batch do not allocate memory
+/// and should be preferred when the same operation is repeated.
+///
+
+#ifndef THEORETICA_BATCH_H
+#define THEORETICA_BATCH_H
+
+#include <vector>
+#include <algorithm>
+#include "../core/error.h"
+#include "../core/simd.h"
+#include "../core/allocator.h"
+#include "./vec.h"
+#include "./mat.h"
+
+
+namespace theoretica {
+
+
+	/// @class mat_batch
+	/// A batch of matrices with a fixed number of rows and columns,
+	/// stored in structure-of-arrays form: the same element of all
+	/// the matrices of the batch is stored contiguously, so that
+	/// batched operations load the elements of consecutive entries
+	/// into the lanes of a SIMD register. The storage is padded
+	/// to a multiple of the number of lanes.
+	///
+	/// @param Type The type of the elements
+	/// @param N The number of rows of each matrix
+	/// @param K The number of columns of each matrix
+	template<typename Type, unsigned int N, unsigned int K>
+	class mat_batch {
+
+		private:
+
+			/// The elements of the matrices, grouped by position
+			std::vector<Type, aligned_allocator<Type>> elements;
+
+			/// Number of matrices in the batch
+			unsigned int count {0};
+
+			/// Number of matrices including padding
+			unsigned int capacity {0};
+
+		public:
+
+			/// Number of entries processed together by batched operations
+			static constexpr unsigned int width = simd::_internal::pack<Type>::width;
+
+
+			/// Construct an empty batch
+			mat_batch() = default;
+
+
+			/// Construct a batch of the given number
+			/// of matrices, with all elements set to zero.
+			///
+			/// @param n The number of matrices
+			mat_batch(unsigned int n) {
+				resize(n);
+			}
+
+
+			/// Construct a batch from a list of matrices
+			///
+			/// @param matrices The matrices to store in the batch
+			template<typename Matrix>
+			mat_batch(const std::vector<Matrix>& matrices) {
+
+				resize(matrices.size());
+
+				for (unsigned int b = 0; b < count; ++b)
+					set(b, matrices[b]);
+			}
+
+
+			/// Change the number of matrices in the batch,
+			/// setting all elements to zero.
+			///
+			/// @param n The number of matrices
+			inline void resize(unsigned int n) {
+
+				count = n;
+				capacity = ((n + width - 1) / width) * width;
+				elements.assign(size_t(N) * K * capacity, Type(0));
+			}
+
+
+			/// Get the number of matrices in the batch
+			inline unsigned int size() const {
+				return count;
+			}
+
+
+			/// Get the number of matrices in the batch, including padding
+			inline unsigned int padded_size() const {
+				return capacity;
+			}
+
+
+			/// Get the number of rows of each matrix
+			static constexpr unsigned int rows() {
+				return N;
+			}
+
+
+			/// Get the number of columns of each matrix
+			static constexpr unsigned int cols() {
+				return K;
+			}
+
+
+			/// Get a pointer to the contiguous array holding
+			/// the element at the given row and column of all
+			/// the matrices of the batch.
+			inline Type* lanes(unsigned int i, unsigned int j) {
+				return &elements[(size_t(i) * K + j) * capacity];
+			}
+
+
+			/// Get a pointer to the contiguous array holding
+			/// the element at the given row and column of all
+			/// the matrices of the batch.
+			inline const Type* lanes(unsigned int i, unsigned int j) const {
+				return &elements[(size_t(i) * K + j) * capacity];
+			}
+
+
+			/// Access an element of a matrix of the batch
+			///
+			/// @param b The index of the matrix
+			/// @param i The row of the element
+			/// @param j The column of the element
+			inline Type& operator()(unsigned int b, unsigned int i, unsigned int j) {
+				return lanes(i, j)[b];
+			}
+
+
+			/// Get an element of a matrix of the batch
+			///
+			/// @param b The index of the matrix
+			/// @param i The row of the element
+			/// @param j The column of the element
+			inline const Type& operator()(unsigned int b, unsigned int i, unsigned int j) const {
+				return lanes(i, j)[b];
+			}
+
+
+			/// Get a copy of a matrix of the batch
+			///
+			/// @param b The index of the matrix
+			/// @return The b-th matrix of the batch
+			inline mat<Type, N, K> get(unsigned int b) const {
+
+				mat<Type, N, K> A;
+
+				for (unsigned int i = 0; i < N; ++i)
+					for (unsigned int j = 0; j < K; ++j)
+						A(i, j) = lanes(i, j)[b];
+
+				return A;
+			}
+
+
+			/// Overwrite a matrix of the batch
+			///
+			/// @param b The index of the matrix
+			/// @param A The matrix to copy, with N rows and K columns
+			template<typename Matrix>
+			inline void set(unsigned int b, const Matrix& A) {
+
+				if (A.rows() != N || A.cols() != K) {
+					TH_MATH_ERROR("mat_batch::set", A.rows(), MathError::InvalidArgument);
+					return;
+				}
+
+				for (unsigned int i = 0; i < N; ++i)
+					for (unsigned int j = 0; j < K; ++j)
+						lanes(i, j)[b] = A(i, j);
+			}
+
+
+			/// Get a pointer to the storage of the batch
+			inline Type* data() {
+				return elements.data();
+			}
+
+
+			/// Get a pointer to the storage of the batch
+			inline const Type* data() const {
+				return elements.data();
+			}
+	};
+
+
+	/// @class vec_batch
+	/// A batch of vectors with a fixed number of elements, stored in
+	/// structure-of-arrays form: the same element of all the vectors
+	/// of the batch is stored contiguously. The storage is padded
+	/// to a multiple of the number of SIMD lanes.
+	///
+	/// @param Type The type of the elements
+	/// @param N The number of elements of each vector
+	template<typename Type, unsigned int N>
+	class vec_batch {
+
+		private:
+
+			/// The elements of the vectors, grouped by position
+			std::vector<Type, aligned_allocator<Type>> elements;
+
+			/// Number of vectors in the batch
+			unsigned int count {0};
+
+			/// Number of vectors including padding
+			unsigned int capacity {0};
+
+		public:
+
+			/// Number of entries processed together by batched operations
+			static constexpr unsigned int width = simd::_internal::pack<Type>::width;
+
+
+			/// Construct an empty batch
+			vec_batch() = default;
+
+
+			/// Construct a batch of the given number
+			/// of vectors, with all elements set to zero.
+			///
+			/// @param n The number of vectors
+			vec_batch(unsigned int n) {
+				resize(n);
+			}
+
+
+			/// Construct a batch from a list of vectors
+			///
+			/// @param vectors The vectors to store in the batch
+			template<typename Vector>
+			vec_batch(const std::vector<Vector>& vectors) {
+
+				resize(vectors.size());
+
+				for (unsigned int b = 0; b < count; ++b)
+					set(b, vectors[b]);
+			}
+
+
+			/// Change the number of vectors in the batch,
+			/// setting all elements to zero.
+			///
+			/// @param n The number of vectors
+			inline void resize(unsigned int n) {
+
+				count = n;
+				capacity = ((n + width - 1) / width) * width;
+				elements.assign(size_t(N) * capacity, Type(0));
+			}
+
+
+			/// Get the number of vectors in the batch
+			inline unsigned int size() const {
+				return count;
+			}
+
+
+			/// Get the number of vectors in the batch, including padding
+			inline unsigned int padded_size() const {
+				return capacity;
+			}
+
+
+			/// Get the number of elements of each vector
+			static constexpr unsigned int dim() {
+				return N;
+			}
+
+
+			/// Get a pointer to the contiguous array holding
+			/// the i-th element of all the vectors of the batch.
+			inline Type* lanes(unsigned int i) {
+				return &elements[size_t(i) * capacity];
+			}
+
+
+			/// Get a pointer to the contiguous array holding
+			/// the i-th element of all the vectors of the batch.
+			inline const Type* lanes(unsigned int i) const {
+				return &elements[size_t(i) * capacity];
+			}
+
+
+			/// Access an element of a vector of the batch
+			///
+			/// @param b The index of the vector
+			/// @param i The index of the element
+			inline Type& operator()(unsigned int b, unsigned int i) {
+				return lanes(i)[b];
+			}
+
+
+			/// Get an element of a vector of the batch
+			///
+			/// @param b The index of the vector
+			/// @param i The index of the element
+			inline const Type& operator()(unsigned int b, unsigned int i) const {
+				return lanes(i)[b];
+			}
+
+
+			/// Get a copy of a vector of the batch
+			///
+			/// @param b The index of the vector
+			/// @return The b-th vector of the batch
+			inline vec<Type, N> get(unsigned int b) const {
+
+				vec<Type, N> v;
+
+				for (unsigned int i = 0; i < N; ++i)
+					v[i] = lanes(i)[b];
+
+				return v;
+			}
+
+
+			/// Overwrite a vector of the batch
+			///
+			/// @param b The index of the vector
+			/// @param v The vector to copy, with N elements
+			template<typename Vector>
+			inline void set(unsigned int b, const Vector& v) {
+
+				if (v.size() != N) {
+					TH_MATH_ERROR("vec_batch::set", v.size(), MathError::InvalidArgument);
+					return;
+				}
+
+				for (unsigned int i = 0; i < N; ++i)
+					lanes(i)[b] = v[i];
+			}
+
+
+			/// Get a pointer to the storage of the batch
+			inline Type* data() {
+				return elements.data();
+			}
+
+
+			/// Get a pointer to the storage of the batch
+			inline const Type* data() const {
+				return elements.data();
+			}
+	};
+
+
+	namespace algebra {
+
+
+		namespace _internal {
+
+
+			/// Overwrite all the elements of a batch
+			/// of matrices with NaN, to signal an error.
+			template<typename Type, unsigned int N, unsigned int K>
+			inline mat_batch<Type, N, K>& batch_error(mat_batch<Type, N, K>& B) {
+
+				std::fill(
+					B.data(), B.data() + size_t(N) * K * B.padded_size(),
+					make_error<Type>());
+
+				return B;
+			}
+
+
+			/// Overwrite all the elements of a batch
+			/// of vectors with NaN, to signal an error.
+			template<typename Type, unsigned int N>
+			inline vec_batch<Type, N>& batch_error(vec_batch<Type, N>& B) {
+
+				std::fill(
+					B.data(), B.data() + size_t(N) * B.padded_size(),
+					make_error<Type>());
+
+				return B;
+			}
+
+
+			/// Swap two rows of registers, starting from the given column,
+			/// in the lanes where the first value is greater than the second.
+			template<typename P, unsigned int L, std::enable_if_t<(P::width > 1), bool> = true>
+			inline void batch_swap_gt(
+				typename P::reg a, typename P::reg b,
+				typename P::reg (&u)[L], typename P::reg (&v)[L], unsigned int from) {
+
+				for (unsigned int j = from; j < L; ++j) {
+					const typename P::reg t = u[j];
+					u[j] = P::select_gt(a, b, v[j], t);
+					v[j] = P::select_gt(a, b, t, v[j]);
+				}
+			}
+
+
+			/// Swap two rows of registers, starting from the given column,
+			/// if the first value is greater than the second. Without SIMD,
+			/// a single branch is cheaper than selecting each element.
+			template<typename P, unsigned int L, std::enable_if_t<(P::width == 1), bool> = true>
+			inline void batch_swap_gt(
+				typename P::reg a, typename P::reg b,
+				typename P::reg (&u)[L], typename P::reg (&v)[L], unsigned int from) {
+
+				if (a > b)
+					for (unsigned int j = from; j < L; ++j)
+						std::swap(u[j], v[j]);
+			}
+
+
+			/// Reduce the square matrices held in the lanes of the registers
+			/// to upper triangular form by Gaussian elimination with partial
+			/// pivoting, applying the same operations to the right hand sides.
+			/// Pivoting is performed by conditional swaps, so that each lane
+			/// ends up with its largest pivot without branching.
+			///
+			/// @param a The matrices, overwritten by their triangular form
+			/// @param x The right hand sides
+			/// @param sign The sign of the permutation of the rows
+			template<typename P, unsigned int N, unsigned int M>
+			inline void batch_eliminate(
+				typename P::reg (&a)[N][N], typename P::reg (&x)[N][M],
+				typename P::reg& sign) {
+
+				using reg = typename P::reg;
+				const reg zero = P::zero();
+
+				for (unsigned int k = 0; k < N; ++k) {
+
+					for (unsigned int r = k + 1; r < N; ++r) {
+
+						const reg pk = P::abs(a[k][k]);
+						const reg pr = P::abs(a[r][k]);
+
+						batch_swap_gt<P>(pr, pk, a[k], a[r], k);
+						batch_swap_gt<P>(pr, pk, x[k], x[r], 0);
+						sign = P::select_gt(pr, pk, P::sub(zero, sign), sign);
+					}
+
+					// Lanes with a null pivot are left untouched,
+					// as the rest of the column is null too
+					const reg inv = P::select_gt(
+						P::abs(a[k][k]), zero, P::div(P::set1(1), a[k][k]), zero);
+
+					for (unsigned int r = k + 1; r < N; ++r) {
+
+						const reg f = P::mul(a[r][k], inv);
+
+						for (unsigned int j = k + 1; j < N; ++j)
+							a[r][j] = P::sub(a[r][j], P::mul(f, a[k][j]));
+
+						for (unsigned int j = 0; j < M; ++j)
+							x[r][j] = P::sub(x[r][j], P::mul(f, x[k][j]));
+					}
+				}
+			}
+
+
+			/// Solve the linear systems held in the lanes of the registers,
+			/// overwriting the right hand sides with the solutions.
+			///
+			/// @param a The matrices of the systems, overwritten
+			/// @param x The right hand sides, overwritten by the solutions
+			template<typename P, unsigned int N, unsigned int M>
+			inline void batch_solve(
+				typename P::reg (&a)[N][N], typename P::reg (&x)[N][M]) {
+
+				using reg = typename P::reg;
+				reg sign = P::set1(1);
+
+				batch_eliminate<P, N, M>(a, x, sign);
+
+				for (unsigned int k = N; k-- > 0;) {
+
+					const reg inv = P::div(P::set1(1), a[k][k]);
+
+					for (unsigned int j = 0; j < M; ++j) {
+
+						reg s = x[k][j];
+
+						for (unsigned int c = k + 1; c < N; ++c)
+							s = P::sub(s, P::mul(a[k][c], x[c][j]));
+
+						x[k][j] = P::mul(s, inv);
+					}
+				}
+			}
+
+
+			/// Load the matrices of a batch starting
+			/// from the given entry into registers.
+			template<typename P, typename Type, unsigned int N, unsigned int K>
+			inline void batch_load(
+				typename P::reg (&a)[N][K], const mat_batch<Type, N, K>& A, size_t b) {
+
+				for (unsigned int i = 0; i < N; ++i)
+					for (unsigned int j = 0; j < K; ++j)
+						a[i][j] = P::load(A.lanes(i, j) + b);
+			}
+
+
+			/// Store registers into the matrices of a batch
+			/// starting from the given entry.
+			template<typename P, typename Type, unsigned int N, unsigned int K>
+			inline void batch_store(
+				mat_batch<Type, N, K>& A, typename P::reg (&a)[N][K], size_t b) {
+
+				for (unsigned int i = 0; i < N; ++i)
+					for (unsigned int j = 0; j < K; ++j)
+						P::store(A.lanes(i, j) + b, a[i][j]);
+			}
+		}
+
+
+		/// Multiply two batches of matrices entry by entry,
+		/// computing \f$R_b = A_b B_b\f$ for each entry b.
+		/// The result may be one of the operands.
+		///
+		/// @param R The batch to overwrite with the result
+		/// @param A The first batch of matrices
+		/// @param B The second batch of matrices
+		/// @return A reference to the resulting batch
+		template<typename Type, unsigned int N, unsigned int K, unsigned int M>
+		inline mat_batch<Type, N, M>& mat_mul(
+			mat_batch<Type, N, M>& R,
+			const mat_batch<Type, N, K>& A,
+			const mat_batch<Type, K, M>& B) {
+
+			using P = simd::_internal::pack<Type>;
+			using reg = typename P::reg;
+
+			if (A.size() != B.size()) {
+				TH_MATH_ERROR("algebra::mat_mul", B.size(), MathError::InvalidArgument);
+				R.resize(A.size());
+				return _internal::batch_error(R);
+			}
+
+			if (R.size() != A.size())
+				R.resize(A.size());
+
+			for (size_t b = 0; b < A.padded_size(); b += P::width) {
+
+				reg a[N][K];
+				_internal::batch_load<P>(a, A, b);
+
+				// Each column of B is loaded before
+				// the same column of R is stored
+				for (unsigned int j = 0; j < M; ++j) {
+
+					reg c[K];
+
+					for (unsigned int k = 0; k < K; ++k)
+						c[k] = P::load(B.lanes(k, j) + b);
+
+					for (unsigned int i = 0; i < N; ++i) {
+
+						reg s = P::mul(a[i][0], c[0]);
+
+						for (unsigned int k = 1; k < K; ++k)
+							s = P::fmadd(a[i][k], c[k], s);
+
+						P::store(R.lanes(i, j) + b, s);
+					}
+				}
+			}
+
+			return R;
+		}
+
+
+		/// Multiply two batches of matrices entry by entry,
+		/// computing \f$A_b B_b\f$ for each entry b.
+		///
+		/// @param A The first batch of matrices
+		/// @param B The second batch of matrices
+		/// @return The batch of products
+		template<typename Type, unsigned int N, unsigned int K, unsigned int M>
+		inline mat_batch<Type, N, M> mat_mul(
+			const mat_batch<Type, N, K>& A,
+			const mat_batch<Type, K, M>& B) {
+
+			mat_batch<Type, N, M> R (A.size());
+			return mat_mul(R, A, B);
+		}
+
+
+		/// Apply a batch of matrices to a batch of vectors entry by entry,
+		/// computing \f$\vec r_b = A_b \vec v_b\f$ for each entry b.
+		/// The result may be the batch of vectors itself.
+		///
+		/// @param res The batch to overwrite with the result
+		/// @param A The batch of matrices
+		/// @param v The batch of vectors
+		/// @return A reference to the resulting batch
+		template<typename Type, unsigned int N, unsigned int K>
+		inline vec_batch<Type, N>& transform(
+			vec_batch<Type, N>& res,
+			const mat_batch<Type, N, K>& A,
+			const vec_batch<Type, K>& v) {
+
+			using P = simd::_internal::pack<Type>;
+			using reg = typename P::reg;
+
+			if (A.size() != v.size()) {
+				TH_MATH_ERROR("algebra::transform", v.size(), MathError::InvalidArgument);
+				res.resize(A.size());
+				return _internal::batch_error(res);
+			}
+
+			if (res.size() != A.size())
+				res.resize(A.size());
+
+			for (size_t b = 0; b < A.padded_size(); b += P::width) {
+
+				reg x[K];
+				reg r[N];
+
+				for (unsigned int k = 0; k < K; ++k)
+					x[k] = P::load(v.lanes(k) + b);
+
+				for (unsigned int i = 0; i < N; ++i) {
+
+					r[i] = P::mul(P::load(A.lanes(i, 0) + b), x[0]);
+
+					for (unsigned int k = 1; k < K; ++k)
+						r[i] = P::fmadd(P::load(A.lanes(i, k) + b), x[k], r[i]);
+				}
+
+				for (unsigned int i = 0; i < N; ++i)
+					P::store(res.lanes(i) + b, r[i]);
+			}
+
+			return res;
+		}
+
+
+		/// Apply a batch of matrices to a batch of vectors entry by entry,
+		/// computing \f$A_b \vec v_b\f$ for each entry b.
+		///
+		/// @param A The batch of matrices
+		/// @param v The batch of vectors
+		/// @return The batch of transformed vectors
+		template<typename Type, unsigned int N, unsigned int K>
+		inline vec_batch<Type, N> transform(
+			const mat_batch<Type, N, K>& A,
+			const vec_batch<Type, K>& v) {
+
+			vec_batch<Type, N> res (A.size());
+			return transform(res, A, v);
+		}
+
+
+		/// Compute the inverse of each matrix of a batch using
+		/// Gaussian elimination with partial pivoting.
+		/// No error is raised for singular matrices, whose
+		/// inverse has infinite or NaN elements.
+		/// The result may be the batch itself.
+		///
+		/// @param dest The batch to overwrite with the inverses
+		/// @param src The batch of matrices to invert
+		/// @return A reference to the batch of inverses
+		template<typename Type, unsigned int N>
+		inline mat_batch<Type, N, N>& inverse(
+			mat_batch<Type, N, N>& dest, const mat_batch<Type, N, N>& src) {
+
+			using P = simd::_internal::pack<Type>;
+			using reg = typename P::reg;
+
+			if (dest.size() != src.size())
+				dest.resize(src.size());
+
+			for (size_t b = 0; b < src.padded_size(); b += P::width) {
+
+				reg a[N][N];
+				reg x[N][N];
+				_internal::batch_load<P>(a, src, b);
+
+				for (unsigned int i = 0; i < N; ++i)
+					for (unsigned int j = 0; j < N; ++j)
+						x[i][j] = P::set1(i == j ? 1 : 0);
+
+				_internal::batch_solve<P, N, N>(a, x);
+				_internal::batch_store<P>(dest, x, b);
+			}
+
+			return dest;
+		}
+
+
+		/// Compute the inverse of each matrix of a batch using
+		/// Gaussian elimination with partial pivoting.
+		///
+		/// @param A The batch of matrices to invert
+		/// @return The batch of inverses
+		template<typename Type, unsigned int N>
+		inline mat_batch<Type, N, N> inverse(const mat_batch<Type, N, N>& A) {
+
+			mat_batch<Type, N, N> res (A.size());
+			return inverse(res, A);
+		}
+
+
+		/// Compute the determinant of each matrix of a batch
+		/// using Gaussian elimination with partial pivoting.
+		///
+		/// @param A The batch of square matrices
+		/// @return A vector with the determinant of each matrix
+		template<typename Type, unsigned int N>
+		inline vec<Type> det(const mat_batch<Type, N, N>& A) {
+
+			using P = simd::_internal::pack<Type>;
+			using reg = typename P::reg;
+
+			vec<Type> res (A.size());
+			Type buff[P::width];
+
+			for (size_t b = 0; b < A.padded_size(); b += P::width) {
+
+				reg a[N][N];
+				reg x[N][1];
+				reg d = P::set1(1);
+
+				_internal::batch_load<P>(a, A, b);
+
+				for (unsigned int i = 0; i < N; ++i)
+					x[i][0] = P::zero();
+
+				_internal::batch_eliminate<P, N, 1>(a, x, d);
+
+				for (unsigned int k = 0; k < N; ++k)
+					d = P::mul(d, a[k][k]);
+
+				P::store(buff, d);
+
+				for (size_t l = 0; l < P::width && b + l < A.size(); ++l)
+					res[b + l] = buff[l];
+			}
+
+			return res;
+		}
+
+
+		/// Solve the linear systems \f$A_b \vec x_b = \vec v_b\f$
+		/// for each entry b of a batch using Gaussian elimination
+		/// with partial pivoting. No error is raised for singular
+		/// systems, whose solution has infinite or NaN elements.
+		/// The result may be the batch of known vectors itself.
+		///
+		/// @param x The batch to overwrite with the solutions
+		/// @param A The batch of matrices of the systems
+		/// @param v The batch of known vectors
+		/// @return A reference to the batch of solutions
+		template<typename Type, unsigned int N>
+		inline vec_batch<Type, N>& solve(
+			vec_batch<Type, N>& x,
+			const mat_batch<Type, N, N>& A,
+			const vec_batch<Type, N>& v) {
+
+			using P = simd::_internal::pack<Type>;
+			using reg = typename P::reg;
+
+			if (A.size() != v.size()) {
+				TH_MATH_ERROR("algebra::solve", v.size(), MathError::InvalidArgument);
+				x.resize(A.size());
+				return _internal::batch_error(x);
+			}
+
+			if (x.size() != A.size())
+				x.resize(A.size());
+
+			for (size_t b = 0; b < A.padded_size(); b += P::width) {
+
+				reg a[N][N];
+				reg r[N][1];
+				_internal::batch_load<P>(a, A, b);
+
+				for (unsigned int i = 0; i < N; ++i)
+					r[i][0] = P::load(v.lanes(i) + b);
+
+				_internal::batch_solve<P, N, 1>(a, r);
+
+				for (unsigned int i = 0; i < N; ++i)
+					P::store(x.lanes(i) + b, r[i][0]);
+			}
+
+			return x;
+		}
+
+
+		/// Solve the linear systems \f$A_b \vec x_b = \vec v_b\f$
+		/// for each entry b of a batch using Gaussian elimination
+		/// with partial pivoting.
+		///
+		/// @param A The batch of matrices of the systems
+		/// @param v The batch of known vectors
+		/// @return The batch of solutions
+		template<typename Type, unsigned int N>
+		inline vec_batch<Type, N> solve(
+			const mat_batch<Type, N, N>& A,
+			const vec_batch<Type, N>& v) {
+
+			vec_batch<Type, N> x (A.size());
+			return solve(x, A, v);
+		}
+	}
+
+}
+
+#endif
@@ -8,7 +8,11 @@
 #ifndef THEORETICA_DISTANCE_H
 #define THEORETICA_DISTANCE_H
 
+#include <vector>
+#include <algorithm>
+
 #include "./vec.h"
+#include "./mat.h"
 #include "./algebra.h"
 #include "../core/constants.h"
 #include "../core/core_traits.h"
@@ -357,6 +361,340 @@ namespace theoretica {
 
 			return count;
 		}
+
+
+		/// Pairwise distances
+
+
+		namespace _internal {
+
+
+			/// Compute the pairwise distances between the rows of X
+			/// and the rows of Y, block by block, writing them into D.
+			/// Each block of rows of X is packed contiguously and each
+			/// block of rows of Y is packed transposed, so that the
+			/// innermost loop runs over consecutive points of Y and is
+			/// vectorized independently of the dimension of the points.
+			/// Blocks are processed in parallel.
+			///
+			/// @param D The matrix to write the distances to,
+			/// already of size X.rows() x Y.rows()
+			/// @param X The first set of points, one for each row
+			/// @param Y The second set of points, one for each row
+			/// @param symmetric Whether X and Y are the same set,
+			/// in which case only the upper blocks are computed and mirrored
+			/// @param init The initial value of the accumulator
+			/// @param accumulate A function which updates the accumulator
+			/// with a pair of coordinates, as accumulate(acc, x_k, y_k)
+			/// @param finalize A function which computes the distance
+			/// from the accumulator, as finalize(acc, i, j)
+			/// @return A reference to D
+			template <
+				typename Matrix1, typename Matrix2, typename MatrixRes,
+				typename Accumulate, typename Finalize
+			>
+			inline MatrixRes& pairwise_distance(
+				MatrixRes& D, const Matrix1& X, const Matrix2& Y, bool symmetric,
+				real init, Accumulate accumulate, Finalize finalize) {
+
+				const unsigned int N = X.rows();
+				const unsigned int M = Y.rows();
+				const unsigned int dim = X.cols();
+				const unsigned int block = ALGEBRA_DISTANCE_BLOCK;
+				const unsigned int blocks_N = (N + block - 1) / block;
+				const unsigned int blocks_M = (M + block - 1) / block;
+
+				#pragma omp parallel for collapse(2) schedule(dynamic)
+				for (unsigned int bi = 0; bi < blocks_N; ++bi) {
+					for (unsigned int bj = 0; bj < blocks_M; ++bj) {
+
+						// Only the upper blocks are needed for symmetric sets
+						if (symmetric && bj < bi)
+							continue;
+
+						const unsigned int i0 = bi * block;
+						const unsigned int j0 = bj * block;
+						const unsigned int n = std::min(block, N - i0);
+						const unsigned int m = std::min(block, M - j0);
+
+						std::vector<real> X_block(n * dim);
+						std::vector<real> Y_block(dim * m);
+						std::vector<real> acc(n * m, init);
+
+						for (unsigned int i = 0; i < n; ++i)
+							for (unsigned int k = 0; k < dim; ++k)
+								X_block[i * dim + k] = X(i0 + i, k);
+
+						for (unsigned int k = 0; k < dim; ++k)
+							for (unsigned int j = 0; j < m; ++j)
+								Y_block[k * m + j] = Y(j0 + j, k);
+
+						for (unsigned int i = 0; i < n; ++i) {
+
+							real* acc_i = &acc[i * m];
+
+							for (unsigned int k = 0; k < dim; ++k) {
+
+								const real x = X_block[i * dim + k];
+								const real* Y_k = &Y_block[k * m];
+
+								for (unsigned int j = 0; j < m; ++j)
+									acc_i[j] = accumulate(acc_i[j], x, Y_k[j]);
+							}
+						}
+
+						for (unsigned int j = 0; j < m; ++j) {
+							for (unsigned int i = 0; i < n; ++i) {
+
+								const real d = finalize(acc[i * m + j], i0 + i, j0 + j);
+								D(i0 + i, j0 + j) = d;
+
+								if (symmetric)
+									D(j0 + j, i0 + i) = d;
+							}
+						}
+					}
+				}
+
+				return D;
+			}
+
+
+			/// Compute the squared Euclidean norm of each row of a matrix.
+			///
+			/// @param X The matrix of points, one for each row
+			/// @return A vector with the squared norms of the rows
+			template<typename Matrix>
+			inline std::vector<real> row_sqr_norms(const Matrix& X) {
+
+				std::vector<real> norms(X.rows(), 0.0);
+
+				for (unsigned int j = 0; j < X.cols(); ++j)
+					for (unsigned int i = 0; i < X.rows(); ++i)
+						norms[i] += square(X(i, j));
+
+				return norms;
+			}
+
+
+			/// Check that two sets of points have the same dimension
+			/// and resize the matrix of their pairwise distances.
+			///
+			/// @param X The first set of points, one for each row
+			/// @param Y The second set of points, one for each row
+			/// @param D The matrix to resize to X.rows() x Y.rows()
+			/// @param fname The name of the calling function
+			/// @return Whether the sets of points are compatible
+			template<typename Matrix1, typename Matrix2, typename MatrixRes>
+			inline bool pairwise_prepare(
+				const Matrix1& X, const Matrix2& Y, MatrixRes& D, const char* fname) {
+
+				// Only reported by TH_MATH_ERROR when exceptions are enabled
+				(void) fname;
+
+				D.resize(X.rows(), Y.rows());
+
+				if (X.cols() != Y.cols()) {
+					TH_MATH_ERROR(fname, Y.cols(), MathError::InvalidArgument);
+					mat_error(D);
+					return false;
+				}
+
+				return true;
+			}
+		}
+
+
+		/// Compute the Euclidean distances between all pairs of points
+		/// of two sets, stored as the rows of two matrices. The distances
+		/// are computed from the norms and inner products of the points as
+		/// \f$d(x, y)^2 = \|x\|^2 + \|y\|^2 - 2 x \cdot y\f$, which is much
+		/// faster than computing the difference of each pair, at the price of
+		/// some cancellation for points which are very close with respect to
+		/// their norm. Blocks of the result are computed in parallel.
+		///
+		/// @param X The first set of points, one for each row
+		/// @param Y The second set of points, one for each row
+		/// @return The matrix of distances, with element (i, j) equal to
+		/// the distance between the i-th row of X and the j-th row of Y
+		template <
+			typename Matrix1, typename Matrix2, typename MatrixRes = mat<real>,
+			enable_matrix<Matrix1> = true, enable_matrix<Matrix2> = true
+		>
+		inline MatrixRes euclidean_distance_matrix(const Matrix1& X, const Matrix2& Y) {
+
+			MatrixRes D;
+
+			if (!_internal::pairwise_prepare(X, Y, D, "algebra::euclidean_distance_matrix"))
+				return D;
+
+			const std::vector<real> X_norms = _internal::row_sqr_norms(X);
+			const std::vector<real> Y_norms = _internal::row_sqr_norms(Y);
+
+			return _internal::pairwise_distance(D, X, Y, false, 0.0,
+				[](real acc, real x, real y) { return acc + x * y; },
+				[&](real acc, unsigned int i, unsigned int j) {
+					return sqrt(max(X_norms[i] + Y_norms[j] - 2.0 * acc, 0.0));
+				}
+			);
+		}
+
+
+		/// Compute the Euclidean distances between all pairs of points
+		/// of a set, stored as the rows of a matrix, using the norms and
+		/// inner products of the points. Only half of the pairs are computed,
+		/// as the resulting matrix is symmetric, and its diagonal is zero.
+		///
+		/// @param X The set of points, one for each row
+		/// @return The symmetric matrix of distances between the rows of X
+		template<typename Matrix, typename MatrixRes = mat<real>, enable_matrix<Matrix> = true>
+		inline MatrixRes euclidean_distance_matrix(const Matrix& X) {
+
+			MatrixRes D;
+			_internal::pairwise_prepare(X, X, D, "algebra::euclidean_distance_matrix");
+
+			const std::vector<real> norms = _internal::row_sqr_norms(X);
+
+			return _internal::pairwise_distance(D, X, X, true, 0.0,
+				[](real acc, real x, real y) { return acc + x * y; },
+				[&](real acc, unsigned int i, unsigned int j) {
+					return (i == j) ? 0.0 : sqrt(max(norms[i] + norms[j] - 2.0 * acc, 0.0));
+				}
+			);
+		}
+
+
+		/// Compute the Euclidean distances between all pairs of points
+		/// of two sets, stored as the rows of two matrices.
+		/// Equivalent to euclidean_distance_matrix(X, Y).
+		///
+		/// @param X The first set of points, one for each row
+		/// @param Y The second set of points, one for each row
+		/// @return The matrix of distances between the rows of X and Y
+		template <
+			typename Matrix1, typename Matrix2, typename MatrixRes = mat<real>,
+			enable_matrix<Matrix1> = true, enable_matrix<Matrix2> = true
+		>
+		inline MatrixRes distance_matrix(const Matrix1& X, const Matrix2& Y) {
+			return euclidean_distance_matrix<Matrix1, Matrix2, MatrixRes>(X, Y);
+		}
+
+
+		/// Compute the Euclidean distances between all pairs of points
+		/// of a set, stored as the rows of a matrix.
+		/// Equivalent to euclidean_distance_matrix(X).
+		///
+		/// @param X The set of points, one for each row
+		/// @return The symmetric matrix of distances between the rows of X
+		template<typename Matrix, typename MatrixRes = mat<real>, enable_matrix<Matrix> = true>
+		inline MatrixRes distance_matrix(const Matrix& X) {
+			return euclidean_distance_matrix<Matrix, MatrixRes>(X);
+		}
+
+
+		/// Compute the cosine distances between all pairs of points
+		/// of two sets, stored as the rows of two matrices, consistently
+		/// with cosine_distance. The inner products of all pairs are computed
+		/// block by block in parallel and then divided by the norms.
+		///
+		/// @param X The first set of points, one for each row
+		/// @param Y The second set of points, one for each row
+		/// @return The matrix of cosine distances between the rows of X and Y
+		template <
+			typename Matrix1, typename Matrix2, typename MatrixRes = mat<real>,
+			enable_matrix<Matrix1> = true, enable_matrix<Matrix2> = true
+		>
+		inline MatrixRes cosine_distance_matrix(const Matrix1& X, const Matrix2& Y) {
+
+			MatrixRes D;
+
+			if (!_internal::pairwise_prepare(X, Y, D, "algebra::cosine_distance_matrix"))
+				return D;
+
+			const std::vector<real> X_norms = _internal::row_sqr_norms(X);
+			const std::vector<real> Y_norms = _internal::row_sqr_norms(Y);
+
+			return _internal::pairwise_distance(D, X, Y, false, 0.0,
+				[](real acc, real x, real y) { return acc + x * y; },
+				[&](real acc, unsigned int i, unsigned int j) {
+					return acc / sqrt(X_norms[i] * Y_norms[j]);
+				}
+			);
+		}
+
+
+		/// Compute the cosine distances between all pairs of points
+		/// of a set, stored as the rows of a matrix, consistently
+		/// with cosine_distance. Only half of the pairs are computed,
+		/// as the resulting matrix is symmetric.
+		///
+		/// @param X The set of points, one for each row
+		/// @return The symmetric matrix of cosine distances between the rows of X
+		template<typename Matrix, typename MatrixRes = mat<real>, enable_matrix<Matrix> = true>
+		inline MatrixRes cosine_distance_matrix(const Matrix& X) {
+
+			MatrixRes D;
+			_internal::pairwise_prepare(X, X, D, "algebra::cosine_distance_matrix");
+
+			const std::vector<real> norms = _internal::row_sqr_norms(X);
+
+			return _internal::pairwise_distance(D, X, X, true, 0.0,
+				[](real acc, real x, real y) { return acc + x * y; },
+				[&](real acc, unsigned int i, unsigned int j) {
+					return acc / sqrt(norms[i] * norms[j]);
+				}
+			);
+		}
+
+
+		/// Compute the Manhattan distances between all pairs of points
+		/// of two sets, stored as the rows of two matrices.
+		/// Blocks of the result are computed in parallel.
+		///
+		/// @param X The first set of points, one for each row
+		/// @param Y The second set of points, one for each row
+		/// @return The matrix of Manhattan distances between the rows of X and Y
+		template <
+			typename Matrix1, typename Matrix2, typename MatrixRes = mat<real>,
+			enable_matrix<Matrix1> = true, enable_matrix<Matrix2> = true
+		>
+		inline MatrixRes manhattan_distance_matrix(const Matrix1& X, const Matrix2& Y) {
+
+			MatrixRes D;
+
+			if (!_internal::pairwise_prepare(X, Y, D, "algebra::manhattan_distance_matrix"))
+				return D;
+
+			return _internal::pairwise_distance(D, X, Y, false, 0.0,
+				[](real acc, real x, real y) { return acc + abs(x - y); },
+				[](real acc, unsigned int, unsigned int) { return acc; }
+			);
+		}
+
+
+		/// Compute the Chebyshev distances between all pairs of points
+		/// of two sets, stored as the rows of two matrices.
+		/// Blocks of the result are computed in parallel.
+		///
+		/// @param X The first set of points, one for each row
+		/// @param Y The second set of points, one for each row
+		/// @return The matrix of Chebyshev distances between the rows of X and Y
+		template <
+			typename Matrix1, typename Matrix2, typename MatrixRes = mat<real>,
+			enable_matrix<Matrix1> = true, enable_matrix<Matrix2> = true
+		>
+		inline MatrixRes chebyshev_distance_matrix(const Matrix1& X, const Matrix2& Y) {
+
+			MatrixRes D;
+
+			if (!_internal::pairwise_prepare(X, Y, D, "algebra::chebyshev_distance_matrix"))
+				return D;
+
+			return _internal::pairwise_distance(D, X, Y, false, 0.0,
+				[](real acc, real x, real y) { return max(acc, abs(x - y)); },
+				[](real acc, unsigned int, unsigned int) { return acc; }
+			);
+		}
 	}
 }
 
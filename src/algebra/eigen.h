@@ -0,0 +1,416 @@
+///
+/// @file eigen.h Eigensolvers for the full spectrum of real symmetric matrices,
+/// using Householder reduction to tridiagonal form and the implicit QL algorithm.
+///
+
+#ifndef THEORETICA_EIGEN_H
+#define THEORETICA_EIGEN_H
+
+#include "../core/error.h"
+#include "../core/constants.h"
+#include "../core/core_traits.h"
+#include "../core/real_analysis.h"
+#include "./algebra.h"
+#include "./vec.h"
+#include "./mat.h"
+
+
+namespace theoretica {
+
+	namespace algebra {
+
+
+		namespace _internal {
+
+
+			/// Reduce a real symmetric matrix to tridiagonal form
+			/// using Householder similarity transformations, \f$A = Q T Q^T\f$.
+			///
+			/// @param V The symmetric matrix to reduce, which is overwritten
+			/// with the orthogonal matrix Q if accumulate is true
+			/// @param d The vector to overwrite with the diagonal of T
+			/// @param e The vector to overwrite with the subdiagonal of T,
+			/// stored in the elements from 1 to n - 1
+			/// @param accumulate Whether to compute the orthogonal matrix Q
+			template<typename Matrix, typename Vector>
+			inline void tridiagonalize_symmetric(
+				Matrix& V, Vector& d, Vector& e, bool accumulate) {
+
+				using Type = matrix_element_t<Matrix>;
+				const unsigned int n = V.rows();
+
+				for (unsigned int j = 0; j < n; ++j)
+					d[j] = V(n - 1, j);
+
+				// Householder reduction, from the last row upwards
+				for (unsigned int i = n - 1; i > 0; --i) {
+
+					// Scale the row to avoid underflow and overflow
+					Type scale = Type(0.0);
+					Type h = Type(0.0);
+
+					for (unsigned int k = 0; k < i; ++k)
+						scale += abs(d[k]);
+
+					if (scale == Type(0.0)) {
+
+						e[i] = d[i - 1];
+
+						for (unsigned int j = 0; j < i; ++j) {
+							d[j] = V(i - 1, j);
+							V(i, j) = Type(0.0);
+							V(j, i) = Type(0.0);
+						}
+
+					} else {
+
+						// Generate the Householder vector
+						for (unsigned int k = 0; k < i; ++k) {
+							d[k] /= scale;
+							h += d[k] * d[k];
+						}
+
+						Type f = d[i - 1];
+						Type g = sqrt(h);
+
+						if (f > Type(0.0))
+							g = -g;
+
+						e[i] = scale * g;
+						h -= f * g;
+						d[i - 1] = f - g;
+
+						for (unsigned int j = 0; j < i; ++j)
+							e[j] = Type(0.0);
+
+						// Apply the similarity transformation to the remaining columns
+						for (unsigned int j = 0; j < i; ++j) {
+
+							f = d[j];
+							V(j, i) = f;
+							g = e[j] + V(j, j) * f;
+
+							for (unsigned int k = j + 1; k < i; ++k) {
+								g += V(k, j) * d[k];
+								e[k] += V(k, j) * f;
+							}
+
+							e[j] = g;
+						}
+
+						f = Type(0.0);
+
+						for (unsigned int j = 0; j < i; ++j) {
+							e[j] /= h;
+							f += e[j] * d[j];
+						}
+
+						const Type hh = f / (h + h);
+
+						for (unsigned int j = 0; j < i; ++j)
+							e[j] -= hh * d[j];
+
+						for (unsigned int j = 0; j < i; ++j) {
+
+							f = d[j];
+							g = e[j];
+
+							for (unsigned int k = j; k < i; ++k)
+								V(k, j) -= (f * e[k] + g * d[k]);
+
+							d[j] = V(i - 1, j);
+							V(i, j) = Type(0.0);
+						}
+					}
+
+					d[i] = h;
+				}
+
+				// Only the diagonal is needed for the eigenvalues
+				if (!accumulate) {
+
+					for (unsigned int j = 0; j < n; ++j)
+						d[j] = V(j, j);
+
+					e[0] = Type(0.0);
+					return;
+				}
+
+				// Accumulate the transformations
+				for (unsigned int i = 0; i < n - 1; ++i) {
+
+					V(n - 1, i) = V(i, i);
+					V(i, i) = Type(1.0);
+					const Type h = d[i + 1];
+
+					if (h != Type(0.0)) {
+
+						for (unsigned int k = 0; k <= i; ++k)
+							d[k] = V(k, i + 1) / h;
+
+						for (unsigned int j = 0; j <= i; ++j) {
+
+							Type g = Type(0.0);
+
+							for (unsigned int k = 0; k <= i; ++k)
+								g += V(k, i + 1) * V(k, j);
+
+							for (unsigned int k = 0; k <= i; ++k)
+								V(k, j) -= g * d[k];
+						}
+					}
+
+					for (unsigned int k = 0; k <= i; ++k)
+						V(k, i + 1) = Type(0.0);
+				}
+
+				for (unsigned int j = 0; j < n; ++j) {
+					d[j] = V(n - 1, j);
+					V(n - 1, j) = Type(0.0);
+				}
+
+				V(n - 1, n - 1) = Type(1.0);
+				e[0] = Type(0.0);
+			}
+
+
+			/// Compute the eigenvalues of a real symmetric tridiagonal matrix
+			/// using the implicit QL algorithm with Wilkinson shifts, optionally
+			/// updating a matrix with the eigenvectors. The eigenvalues are
+			/// sorted in ascending order together with the eigenvectors.
+			///
+			/// @param d The diagonal of the matrix, overwritten with the eigenvalues
+			/// @param e The subdiagonal of the matrix, stored in the elements
+			/// from 1 to n - 1, which is destroyed
+			/// @param V The orthogonal matrix of the tridiagonal reduction,
+			/// overwritten with the eigenvectors as columns if accumulate is true
+			/// @param accumulate Whether to compute the eigenvectors
+			/// @return Whether the algorithm converged
+			template<typename Matrix, typename Vector>
+			inline bool tridiagonal_ql(Vector& d, Vector& e, Matrix& V, bool accumulate) {
+
+				using Type = matrix_element_t<Matrix>;
+				const unsigned int n = d.size();
+				const unsigned int max_iter = (unsigned int) ALGEBRA_EIGEN_ITER;
+
+				for (unsigned int i = 1; i < n; ++i)
+					e[i - 1] = e[i];
+
+				e[n - 1] = Type(0.0);
+
+				Type f = Type(0.0);
+				Type tst1 = Type(0.0);
+
+				for (unsigned int l = 0; l < n; ++l) {
+
+					// Find a negligible subdiagonal element
+					tst1 = max(tst1, abs(d[l]) + abs(e[l]));
+					unsigned int m = l;
+
+					while (m < n - 1) {
+
+						if (abs(e[m]) <= MACH_EPSILON * tst1)
+							break;
+
+						m++;
+					}
+
+					// If m == l, d[l] is already an eigenvalue
+					if (m > l) {
+
+						unsigned int iter = 0;
+
+						do {
+
+							if (++iter > max_iter)
+								return false;
+
+							// Compute the implicit shift
+							Type g = d[l];
+							Type p = (d[l + 1] - g) / (2.0 * e[l]);
+							Type r = sqrt(p * p + 1.0);
+
+							if (p < Type(0.0))
+								r = -r;
+
+							d[l] = e[l] / (p + r);
+							d[l + 1] = e[l] * (p + r);
+
+							const Type dl1 = d[l + 1];
+							Type h = g - d[l];
+
+							for (unsigned int i = l + 2; i < n; ++i)
+								d[i] -= h;
+
+							f += h;
+
+							// Implicit QL transformation
+							p = d[m];
+
+							Type c = 1.0, c2 = 1.0, c3 = 1.0;
+							Type s = 0.0, s2 = 0.0;
+							const Type el1 = e[l + 1];
+
+							for (int i = m - 1; i >= int(l); --i) {
+
+								c3 = c2;
+								c2 = c;
+								s2 = s;
+								g = c * e[i];
+								h = c * p;
+								r = sqrt(p * p + e[i] * e[i]);
+								e[i + 1] = s * r;
+								s = e[i] / r;
+								c = p / r;
+								p = c * d[i] - s * g;
+								d[i + 1] = h + s * (c * g + s * d[i]);
+
+								// Accumulate the Givens rotation
+								if (accumulate) {
+
+									for (unsigned int k = 0; k < n; ++k) {
+										h = V(k, i + 1);
+										V(k, i + 1) = s * V(k, i) + c * h;
+										V(k, i) = c * V(k, i) - s * h;
+									}
+								}
+							}
+
+							p = -s * s2 * c3 * el1 * e[l] / dl1;
+							e[l] = s * p;
+							d[l] = c * p;
+
+						} while (abs(e[l]) > MACH_EPSILON * tst1);
+					}
+
+					d[l] += f;
+					e[l] = Type(0.0);
+				}
+
+				// Sort the eigenvalues and eigenvectors in ascending order
+				for (unsigned int i = 0; i < n - 1; ++i) {
+
+					unsigned int k = i;
+					Type p = d[i];
+
+					for (unsigned int j = i + 1; j < n; ++j) {
+						if (d[j] < p) {
+							k = j;
+							p = d[j];
+						}
+					}
+
+					if (k == i)
+						continue;
+
+					d[k] = d[i];
+					d[i] = p;
+
+					if (accumulate) {
+
+						for (unsigned int j = 0; j < n; ++j) {
+							p = V(j, i);
+							V(j, i) = V(j, k);
+							V(j, k) = p;
+						}
+					}
+				}
+
+				return true;
+			}
+		}
+
+
+		/// Compute all the eigenvalues of a real symmetric matrix,
+		/// reducing it to tridiagonal form with Householder transformations
+		/// and then applying the implicit QL algorithm, with a total cost
+		/// of \f$O(n^3)\f$. The eigenvectors are not computed, which
+		/// is faster than using eigenpairs_symmetric.
+		///
+		/// @param A The symmetric matrix to compute the eigenvalues of
+		/// @return The vector of the eigenvalues, sorted in ascending order
+		template<typename Matrix, typename Vector = vec<matrix_element_t<Matrix>>>
+		inline Vector eigenvalues_symmetric(const Matrix& A) {
+
+			Vector d;
+			d.resize(A.rows());
+
+			if (!is_square(A)) {
+				TH_MATH_ERROR("algebra::eigenvalues_symmetric", A.rows(), MathError::InvalidArgument);
+				return vec_error(d);
+			}
+
+			if (!is_symmetric(A)) {
+				TH_MATH_ERROR("algebra::eigenvalues_symmetric", false, MathError::InvalidArgument);
+				return vec_error(d);
+			}
+
+			if (A.rows() == 0)
+				return d;
+
+			Vector e;
+			e.resize(A.rows());
+
+			Matrix V = algebra::clone(A);
+			_internal::tridiagonalize_symmetric(V, d, e, false);
+
+			if (!_internal::tridiagonal_ql(d, e, V, false)) {
+				TH_MATH_ERROR("algebra::eigenvalues_symmetric", false, MathError::NoConvergence);
+				return vec_error(d);
+			}
+
+			return d;
+		}
+
+
+		/// Compute all the eigenvalues and eigenvectors of a real symmetric
+		/// matrix, reducing it to tridiagonal form with Householder
+		/// transformations and then applying the implicit QL algorithm,
+		/// with a total cost of \f$O(n^3)\f$. The eigenvectors are
+		/// orthonormal, so that \f$A = V \Lambda V^T\f$.
+		///
+		/// @param A The symmetric matrix to compute the eigenpairs of
+		/// @param V The matrix to overwrite with the eigenvectors as columns,
+		/// in the same order as the eigenvalues
+		/// @return The vector of the eigenvalues, sorted in ascending order
+		template<typename Matrix1, typename Matrix2,
+			typename Vector = vec<matrix_element_t<Matrix1>>>
+		inline Vector eigenpairs_symmetric(const Matrix1& A, Matrix2& V) {
+
+			Vector d;
+			d.resize(A.rows());
+			V.resize(A.rows(), A.cols());
+
+			if (!is_square(A)) {
+				TH_MATH_ERROR("algebra::eigenpairs_symmetric", A.rows(), MathError::InvalidArgument);
+				mat_error(V);
+				return vec_error(d);
+			}
+
+			if (!is_symmetric(A)) {
+				TH_MATH_ERROR("algebra::eigenpairs_symmetric", false, MathError::InvalidArgument);
+				mat_error(V);
+				return vec_error(d);
+			}
+
+			if (A.rows() == 0)
+				return d;
+
+			Vector e;
+			e.resize(A.rows());
+
+			mat_copy(V, A);
+			_internal::tridiagonalize_symmetric(V, d, e, true);
+
+			if (!_internal::tridiagonal_ql(d, e, V, true)) {
+				TH_MATH_ERROR("algebra::eigenpairs_symmetric", false, MathError::NoConvergence);
+				mat_error(V);
+				return vec_error(d);
+			}
+
+			return d;
+		}
+	}
+}
+
+#endif
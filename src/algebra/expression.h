@@ -0,0 +1,705 @@
+///
+/// @file expression.h Expression templates for the lazy evaluation of
+/// element-wise arithmetic on dynamically allocated vectors and matrices.
+/// Wrapping an operand with lazy() makes addition, subtraction and
+/// multiplication by a scalar return lightweight expression objects instead
+/// of temporary containers. Operators between containers alone are unaffected
+/// and still return a vec or mat, so a term like `b * y` on a plain vector
+/// allocates a temporary before joining the expression. Every container
+/// operand must be wrapped, as in `a * lazy(x) + b * lazy(y) - lazy(z)`, for
+/// the whole expression to be evaluated in a single loop, without intermediate
+/// allocations, when it is assigned to a vector.
+///
+/// Expressions reference their lvalue operands and store temporaries by value,
+/// so they should be evaluated (assigned to a vec or mat) before the referenced
+/// containers go out of scope.
+///
+
+#ifndef THEORETICA_EXPRESSION_H
+#define THEORETICA_EXPRESSION_H
+
+#include <type_traits>
+#include <utility>
+#include <memory>
+#include "../core/error.h"
+#include "../core/constants.h"
+#include "../core/core_traits.h"
+#include "../core/real_analysis.h"
+#include "./algebra.h"
+
+
+namespace theoretica {
+
+
+	// Forward declarations of the containers, defined in vec.h and mat.h
+	template<typename Type, unsigned int N, typename Allocator> class vec;
+	template<typename Type, unsigned int N, unsigned int K, typename Allocator> class mat;
+	template<typename Vector, typename ReturnType> class vec_iterator;
+	template<typename Matrix, typename ReturnType> class mat_iterator;
+
+	template<typename Op, typename LHS, typename RHS> class vec_expr;
+	template<typename Op, typename LHS, typename RHS> class mat_expr;
+
+
+	namespace _internal {
+
+
+		/// Element-wise sum of expression operands
+		struct expr_sum {
+			template<typename T1, typename T2>
+			inline auto operator()(const T1& a, const T2& b) const {
+				return a + b;
+			}
+		};
+
+
+		/// Element-wise difference of expression operands
+		struct expr_diff {
+			template<typename T1, typename T2>
+			inline auto operator()(const T1& a, const T2& b) const {
+				return a - b;
+			}
+		};
+
+
+		/// Element-wise product of expression operands
+		struct expr_mul {
+			template<typename T1, typename T2>
+			inline auto operator()(const T1& a, const T2& b) const {
+				return a * b;
+			}
+		};
+
+
+		/// Element-wise division of expression operands
+		struct expr_div {
+			template<typename T1, typename T2>
+			inline auto operator()(const T1& a, const T2& b) const {
+				return a / b;
+			}
+		};
+
+
+		/// Identity on the left operand, used to wrap a container in an expression
+		struct expr_first {
+			template<typename T1, typename T2>
+			inline const T1& operator()(const T1& a, const T2&) const {
+				return a;
+			}
+		};
+
+
+		/// Empty operand of an expression wrapping a container
+		struct expr_none {
+
+			inline int operator[](unsigned int) const {
+				return 0;
+			}
+
+			inline int operator()(unsigned int, unsigned int) const {
+				return 0;
+			}
+		};
+
+
+		/// Scalar operand of an expression, which may be
+		/// indexed like a vector or a matrix.
+		template<typename Type>
+		struct expr_scalar {
+
+			Type value;
+
+			inline const Type& operator[](unsigned int) const {
+				return value;
+			}
+
+			inline const Type& operator()(unsigned int, unsigned int) const {
+				return value;
+			}
+		};
+
+
+		/// Check whether a type is a vector expression
+		template<typename Structure>
+		struct is_vec_expr : std::false_type {};
+
+		template<typename Op, typename LHS, typename RHS>
+		struct is_vec_expr<vec_expr<Op, LHS, RHS>> : std::true_type {};
+
+
+		/// Check whether a type is a matrix expression
+		template<typename Structure>
+		struct is_mat_expr : std::false_type {};
+
+		template<typename Op, typename LHS, typename RHS>
+		struct is_mat_expr<mat_expr<Op, LHS, RHS>> : std::true_type {};
+
+
+		/// Check whether a type is a vector or matrix expression
+		template<typename Structure>
+		using is_expr = std::integral_constant<bool,
+			is_vec_expr<Structure>::value || is_mat_expr<Structure>::value>;
+
+
+		/// Enable an operator overload for vector expressions
+		template<typename Structure, typename T = bool>
+		using enable_vec_operand = std::enable_if_t<
+			is_vec_expr<std::decay_t<Structure>>::value, T>;
+
+
+		/// Enable an operator overload for matrix expressions
+		template<typename Structure, typename T = bool>
+		using enable_mat_operand = std::enable_if_t<
+			is_mat_expr<std::decay_t<Structure>>::value, T>;
+
+
+		/// Enable an operator overload for two vectors,
+		/// at least one of which is a vector expression
+		template<typename Vector1, typename Vector2, typename T = bool>
+		using enable_vec_operands = std::enable_if_t<
+			is_vector<std::decay_t<Vector1>>::value
+			&& is_vector<std::decay_t<Vector2>>::value
+			&& (is_vec_expr<std::decay_t<Vector1>>::value
+				|| is_vec_expr<std::decay_t<Vector2>>::value), T>;
+
+
+		/// Enable an operator overload for two matrices,
+		/// at least one of which is a matrix expression
+		template<typename Matrix1, typename Matrix2, typename T = bool>
+		using enable_mat_operands = std::enable_if_t<
+			is_matrix<std::decay_t<Matrix1>>::value
+			&& is_matrix<std::decay_t<Matrix2>>::value
+			&& (is_mat_expr<std::decay_t<Matrix1>>::value
+				|| is_mat_expr<std::decay_t<Matrix2>>::value), T>;
+
+
+		/// Disable a function overload for vector and matrix expressions
+		template<typename Structure, typename T = bool>
+		using disable_expr = std::enable_if_t<!is_expr<std::decay_t<Structure>>::value, T>;
+
+
+		/// Type used to hold an operand inside an expression: containers passed
+		/// as lvalues are held by reference, while temporaries and nested
+		/// expressions are held by value, so that they live as long as the expression.
+		template<typename Structure>
+		using expr_operand_t = std::conditional_t<
+			std::is_lvalue_reference<Structure>::value
+				&& !is_expr<std::decay_t<Structure>>::value,
+			const std::remove_reference_t<Structure>&,
+			std::decay_t<Structure>>;
+
+
+		/// Evaluate a vector expression into a vector
+		/// with a single loop over the elements.
+		template<typename Vector, typename Op, typename LHS, typename RHS>
+		inline Vector& expr_eval(Vector& dest, const vec_expr<Op, LHS, RHS>& expr) {
+
+			dest.resize(expr.size());
+
+			if (!expr.valid())
+				return algebra::vec_error(dest);
+
+			for (unsigned int i = 0; i < dest.size(); ++i)
+				dest[i] = expr[i];
+
+			return dest;
+		}
+
+
+		/// Evaluate a matrix expression into a matrix
+		/// with a single loop over the elements, in storage order.
+		template<typename Matrix, typename Op, typename LHS, typename RHS>
+		inline Matrix& expr_eval(Matrix& dest, const mat_expr<Op, LHS, RHS>& expr) {
+
+			dest.resize(expr.rows(), expr.cols());
+
+			if (!expr.valid())
+				return algebra::mat_error(dest);
+
+#ifdef THEORETICA_ROW_FIRST
+
+			for (unsigned int i = 0; i < dest.rows(); ++i)
+				for (unsigned int j = 0; j < dest.cols(); ++j)
+					dest(i, j) = expr(i, j);
+#else
+
+			for (unsigned int j = 0; j < dest.cols(); ++j)
+				for (unsigned int i = 0; i < dest.rows(); ++i)
+					dest(i, j) = expr(i, j);
+#endif
+
+			return dest;
+		}
+	}
+
+
+	/// @class vec_expr
+	/// A lazily evaluated element-wise operation between two operands,
+	/// each of which may be a vector, a vector expression or a scalar.
+	/// The elements are only computed when they are accessed, usually
+	/// when the expression is assigned to a vector.
+	///
+	/// @tparam Op The element-wise operation
+	/// @tparam LHS The type used to hold the left operand
+	/// @tparam RHS The type used to hold the right operand
+	template<typename Op, typename LHS, typename RHS>
+	class vec_expr {
+
+		private:
+
+			/// The left operand
+			LHS lhs;
+
+			/// The right operand
+			RHS rhs;
+
+			/// The size of the resulting vector
+			unsigned int sz;
+
+			/// Whether the operands have compatible sizes
+			bool is_valid;
+
+		public:
+
+			/// The type of the elements of the resulting vector
+			using value_type = std::decay_t<decltype(
+				Op()(std::declval<const LHS&>()[0], std::declval<const RHS&>()[0]))>;
+
+
+			/// Construct the expression from its operands.
+			///
+			/// @param lhs The left operand
+			/// @param rhs The right operand
+			/// @param size The size of the resulting vector
+			/// @param valid Whether the operands are compatible
+			template<typename T1, typename T2>
+			vec_expr(T1&& lhs, T2&& rhs, unsigned int size, bool valid = true)
+				: lhs(std::forward<T1>(lhs)), rhs(std::forward<T2>(rhs)),
+				sz(size), is_valid(valid) {}
+
+
+			/// Compute the i-th element of the expression
+			inline value_type operator[](unsigned int i) const {
+				return Op()(lhs[i], rhs[i]);
+			}
+
+
+			/// Returns the size of the resulting vector
+			inline unsigned int size() const {
+				return sz;
+			}
+
+
+			/// Returns whether the operands of the expression,
+			/// and of all nested expressions, have compatible sizes.
+			inline bool valid() const {
+				return is_valid;
+			}
+
+
+			/// Evaluate the expression into a vector
+			inline vec<value_type, 0, std::allocator<value_type>> eval() const {
+				vec<value_type, 0, std::allocator<value_type>> res;
+				return _internal::expr_eval(res, *this);
+			}
+
+
+			/// Compute the norm of the resulting vector
+			inline auto norm() const {
+				return algebra::norm(*this);
+			}
+
+
+			/// Compute the square norm of the resulting vector
+			inline auto sqr_norm() const {
+				return algebra::sqr_norm(*this);
+			}
+
+
+			/// Get a const iterator to the first element
+			inline auto begin() const {
+				return vec_iterator<const vec_expr, value_type>(*this, 0);
+			}
+
+
+			/// Get a const iterator to one plus the last element
+			inline auto end() const {
+				return vec_iterator<const vec_expr, value_type>(*this, size());
+			}
+	};
+
+
+	/// @class mat_expr
+	/// A lazily evaluated element-wise operation between two operands,
+	/// each of which may be a matrix, a matrix expression or a scalar.
+	/// The elements are only computed when they are accessed, usually
+	/// when the expression is assigned to a matrix.
+	///
+	/// @tparam Op The element-wise operation
+	/// @tparam LHS The type used to hold the left operand
+	/// @tparam RHS The type used to hold the right operand
+	template<typename Op, typename LHS, typename RHS>
+	class mat_expr {
+
+		private:
+
+			/// The left operand
+			LHS lhs;
+
+			/// The right operand
+			RHS rhs;
+
+			/// The number of rows of the resulting matrix
+			unsigned int row_sz;
+
+			/// The number of columns of the resulting matrix
+			unsigned int col_sz;
+
+			/// Whether the operands have compatible sizes
+			bool is_valid;
+
+		public:
+
+			/// The type of the elements of the resulting matrix
+			using value_type = std::decay_t<decltype(
+				Op()(std::declval<const LHS&>()(0, 0), std::declval<const RHS&>()(0, 0)))>;
+
+
+			/// Construct the expression from its operands.
+			///
+			/// @param lhs The left operand
+			/// @param rhs The right operand
+			/// @param rows The number of rows of the resulting matrix
+			/// @param cols The number of columns of the resulting matrix
+			/// @param valid Whether the operands are compatible
+			template<typename T1, typename T2>
+			mat_expr(T1&& lhs, T2&& rhs,
+				unsigned int rows, unsigned int cols, bool valid = true)
+				: lhs(std::forward<T1>(lhs)), rhs(std::forward<T2>(rhs)),
+				row_sz(rows), col_sz(cols), is_valid(valid) {}
+
+
+			/// Compute the element of the expression at the given row and column
+			inline value_type operator()(unsigned int i, unsigned int j) const {
+				return Op()(lhs(i, j), rhs(i, j));
+			}
+
+
+			/// Returns the number of rows of the resulting matrix
+			inline unsigned int rows() const {
+				return row_sz;
+			}
+
+
+			/// Returns the number of columns of the resulting matrix
+			inline unsigned int cols() const {
+				return col_sz;
+			}
+
+
+			/// Returns the number of elements of the resulting matrix
+			inline unsigned int size() const {
+				return row_sz * col_sz;
+			}
+
+
+			/// Returns whether the operands of the expression,
+			/// and of all nested expressions, have compatible sizes.
+			inline bool valid() const {
+				return is_valid;
+			}
+
+
+			/// Evaluate the expression into a matrix
+			inline mat<value_type, 0, 0, std::allocator<value_type>> eval() const {
+				mat<value_type, 0, 0, std::allocator<value_type>> res;
+				return _internal::expr_eval(res, *this);
+			}
+
+
+			/// Get a const iterator to the first element
+			inline auto begin() const {
+				return mat_iterator<const mat_expr, value_type>(*this, 0, 0);
+			}
+
+
+			/// Get a const iterator to one past the last element
+			inline auto end() const {
+				return mat_iterator<const mat_expr, value_type>(*this, rows(), 0);
+			}
+	};
+
+
+	namespace _internal {
+
+
+		/// Whether an operand holds valid data, which is always
+		/// the case for containers and scalars.
+		template<typename Structure>
+		inline bool expr_valid(const Structure&) {
+			return true;
+		}
+
+		template<typename Op, typename LHS, typename RHS>
+		inline bool expr_valid(const vec_expr<Op, LHS, RHS>& expr) {
+			return expr.valid();
+		}
+
+		template<typename Op, typename LHS, typename RHS>
+		inline bool expr_valid(const mat_expr<Op, LHS, RHS>& expr) {
+			return expr.valid();
+		}
+
+
+		/// Construct the expression of an element-wise operation between vectors
+		template<typename Op, typename Vector1, typename Vector2>
+		inline auto make_vec_expr(Vector1&& v, Vector2&& w, const char* name) {
+
+			// The name is only read when errors throw exceptions
+			(void) name;
+
+			const unsigned int n = min(v.size(), w.size());
+			bool valid = expr_valid(v) && expr_valid(w);
+
+			if (v.size() != w.size()) {
+				TH_MATH_ERROR(name, v.size(), MathError::InvalidArgument);
+				valid = false;
+			}
+
+			return vec_expr<Op, expr_operand_t<Vector1>, expr_operand_t<Vector2>>(
+				std::forward<Vector1>(v), std::forward<Vector2>(w), n, valid);
+		}
+
+
+		/// Construct the expression of an element-wise operation between matrices
+		template<typename Op, typename Matrix1, typename Matrix2>
+		inline auto make_mat_expr(Matrix1&& A, Matrix2&& B, const char* name) {
+
+			(void) name;
+
+			const unsigned int rows = min(A.rows(), B.rows());
+			const unsigned int cols = min(A.cols(), B.cols());
+			bool valid = expr_valid(A) && expr_valid(B);
+
+			if (A.rows() != B.rows()) {
+				TH_MATH_ERROR(name, A.rows(), MathError::InvalidArgument);
+				valid = false;
+			} else if (A.cols() != B.cols()) {
+				TH_MATH_ERROR(name, A.cols(), MathError::InvalidArgument);
+				valid = false;
+			}
+
+			return mat_expr<Op, expr_operand_t<Matrix1>, expr_operand_t<Matrix2>>(
+				std::forward<Matrix1>(A), std::forward<Matrix2>(B), rows, cols, valid);
+		}
+	}
+
+
+	/// Wrap a vector in an expression, so that the element-wise operations
+	/// it takes part in are evaluated lazily when the result is assigned
+	/// to a vector. Other container operands of the expression are only
+	/// fused into the same loop if they are wrapped too.
+	/// The expression references the vector, which must outlive it.
+	///
+	/// @param v The vector to wrap
+	/// @return An expression with the same elements as the vector
+	template<typename Vector, enable_vector<Vector> = true, disable_matrix<Vector> = true>
+	inline auto lazy(const Vector& v) {
+		return vec_expr<_internal::expr_first, const Vector&, _internal::expr_none>(
+			v, _internal::expr_none(), v.size());
+	}
+
+
+	/// Wrap a matrix in an expression, so that the element-wise operations
+	/// it takes part in are evaluated lazily when the result is assigned
+	/// to a matrix. Other container operands of the expression are only
+	/// fused into the same loop if they are wrapped too.
+	/// The expression references the matrix, which must outlive it.
+	///
+	/// @param A The matrix to wrap
+	/// @return An expression with the same elements as the matrix
+	template<typename Matrix, enable_matrix<Matrix> = true>
+	inline auto lazy(const Matrix& A) {
+		return mat_expr<_internal::expr_first, const Matrix&, _internal::expr_none>(
+			A, _internal::expr_none(), A.rows(), A.cols());
+	}
+
+
+	/// Temporaries cannot be wrapped, as the expression would outlive them
+	template<typename Structure>
+	void lazy(const Structure&& S) = delete;
+
+
+	// Vector operators
+
+
+	/// Lazily sum two vectors
+	template<typename Vector1, typename Vector2,
+		_internal::enable_vec_operands<Vector1, Vector2> = true>
+	inline auto operator+(Vector1&& v, Vector2&& w) {
+		return _internal::make_vec_expr<_internal::expr_sum>(
+			std::forward<Vector1>(v), std::forward<Vector2>(w), "vec::operator+");
+	}
+
+
+	/// Lazily subtract two vectors
+	template<typename Vector1, typename Vector2,
+		_internal::enable_vec_operands<Vector1, Vector2> = true>
+	inline auto operator-(Vector1&& v, Vector2&& w) {
+		return _internal::make_vec_expr<_internal::expr_diff>(
+			std::forward<Vector1>(v), std::forward<Vector2>(w), "vec::operator-");
+	}
+
+
+	/// Lazily multiply a vector by a scalar
+	template<typename Vector, _internal::enable_vec_operand<Vector> = true>
+	inline auto operator*(Vector&& v, vector_element_t<std::decay_t<Vector>> a) {
+
+		using Type = vector_element_t<std::decay_t<Vector>>;
+		const unsigned int n = v.size();
+		const bool valid = _internal::expr_valid(v);
+
+		return vec_expr<_internal::expr_mul,
+			_internal::expr_operand_t<Vector>, _internal::expr_scalar<Type>>(
+				std::forward<Vector>(v), _internal::expr_scalar<Type>{a}, n, valid);
+	}
+
+
+	/// Lazily multiply a scalar by a vector
+	template<typename Vector, _internal::enable_vec_operand<Vector> = true>
+	inline auto operator*(vector_element_t<std::decay_t<Vector>> a, Vector&& v) {
+
+		using Type = vector_element_t<std::decay_t<Vector>>;
+		const unsigned int n = v.size();
+		const bool valid = _internal::expr_valid(v);
+
+		return vec_expr<_internal::expr_mul,
+			_internal::expr_scalar<Type>, _internal::expr_operand_t<Vector>>(
+				_internal::expr_scalar<Type>{a}, std::forward<Vector>(v), n, valid);
+	}
+
+
+	/// Lazily divide a vector by a scalar
+	template<typename Vector, _internal::enable_vec_operand<Vector> = true>
+	inline auto operator/(Vector&& v, vector_element_t<std::decay_t<Vector>> a) {
+
+		using Type = vector_element_t<std::decay_t<Vector>>;
+		const unsigned int n = v.size();
+		const bool valid = _internal::expr_valid(v);
+
+		return vec_expr<_internal::expr_div,
+			_internal::expr_operand_t<Vector>, _internal::expr_scalar<Type>>(
+				std::forward<Vector>(v), _internal::expr_scalar<Type>{a}, n, valid);
+	}
+
+
+	/// Lazily compute the opposite of a vector
+	template<typename Vector, _internal::enable_vec_operand<Vector> = true>
+	inline auto operator-(Vector&& v) {
+		return std::forward<Vector>(v) * vector_element_t<std::decay_t<Vector>>(-1);
+	}
+
+
+	/// Dot product between a vector expression and another vector
+	template<typename Vector1, typename Vector2,
+		std::enable_if_t<_internal::is_vec_expr<Vector1>::value, bool> = true,
+		enable_vector<Vector2> = true>
+	inline auto operator*(const Vector1& v, const Vector2& w) {
+		return algebra::dot(v, w);
+	}
+
+
+	// Matrix operators
+
+
+	/// Lazily sum two matrices
+	template<typename Matrix1, typename Matrix2,
+		_internal::enable_mat_operands<Matrix1, Matrix2> = true>
+	inline auto operator+(Matrix1&& A, Matrix2&& B) {
+		return _internal::make_mat_expr<_internal::expr_sum>(
+			std::forward<Matrix1>(A), std::forward<Matrix2>(B), "mat::operator+");
+	}
+
+
+	/// Lazily subtract two matrices
+	template<typename Matrix1, typename Matrix2,
+		_internal::enable_mat_operands<Matrix1, Matrix2> = true>
+	inline auto operator-(Matrix1&& A, Matrix2&& B) {
+		return _internal::make_mat_expr<_internal::expr_diff>(
+			std::forward<Matrix1>(A), std::forward<Matrix2>(B), "mat::operator-");
+	}
+
+
+	/// Lazily multiply a matrix by a scalar
+	template<typename Matrix, _internal::enable_mat_operand<Matrix> = true>
+	inline auto operator*(Matrix&& A, matrix_element_t<std::decay_t<Matrix>> a) {
+
+		using Type = matrix_element_t<std::decay_t<Matrix>>;
+		const unsigned int rows = A.rows();
+		const unsigned int cols = A.cols();
+		const bool valid = _internal::expr_valid(A);
+
+		return mat_expr<_internal::expr_mul,
+			_internal::expr_operand_t<Matrix>, _internal::expr_scalar<Type>>(
+				std::forward<Matrix>(A), _internal::expr_scalar<Type>{a}, rows, cols, valid);
+	}
+
+
+	/// Lazily multiply a scalar by a matrix
+	template<typename Matrix, _internal::enable_mat_operand<Matrix> = true>
+	inline auto operator*(matrix_element_t<std::decay_t<Matrix>> a, Matrix&& A) {
+
+		using Type = matrix_element_t<std::decay_t<Matrix>>;
+		const unsigned int rows = A.rows();
+		const unsigned int cols = A.cols();
+		const bool valid = _internal::expr_valid(A);
+
+		return mat_expr<_internal::expr_mul,
+			_internal::expr_scalar<Type>, _internal::expr_operand_t<Matrix>>(
+				_internal::expr_scalar<Type>{a}, std::forward<Matrix>(A), rows, cols, valid);
+	}
+
+
+	/// Lazily divide a matrix by a scalar,
+	/// multiplying it by the reciprocal of the scalar.
+	template<typename Matrix, _internal::enable_mat_operand<Matrix> = true>
+	inline auto operator/(Matrix&& A, matrix_element_t<std::decay_t<Matrix>> a) {
+
+		using Type = matrix_element_t<std::decay_t<Matrix>>;
+		const unsigned int rows = A.rows();
+		const unsigned int cols = A.cols();
+		bool valid = _internal::expr_valid(A);
+
+		if (abs(a) < MACH_EPSILON) {
+			TH_MATH_ERROR("mat::operator/", a, MathError::DivByZero);
+			valid = false;
+		}
+
+		return mat_expr<_internal::expr_mul,
+			_internal::expr_operand_t<Matrix>, _internal::expr_scalar<Type>>(
+				std::forward<Matrix>(A), _internal::expr_scalar<Type>{Type(1.0) / a},
+				rows, cols, valid);
+	}
+
+
+	/// Multiply a matrix expression by a matrix or a vector,
+	/// evaluating the expression first.
+	template<typename Matrix, typename Structure,
+		std::enable_if_t<_internal::is_mat_expr<Matrix>::value
+			&& (is_matrix<Structure>::value || is_vector<Structure>::value), bool> = true>
+	inline auto operator*(const Matrix& A, const Structure& B) {
+		return A.eval() * B;
+	}
+
+
+	/// Multiply a dynamic matrix by a matrix or vector expression,
+	/// evaluating the expression first.
+	template<typename Type, typename Allocator, typename Structure,
+		std::enable_if_t<_internal::is_expr<Structure>::value, bool> = true>
+	inline auto operator*(const mat<Type, 0, 0, Allocator>& A, const Structure& B) {
+		return A * B.eval();
+	}
+
+}
+
+#endif
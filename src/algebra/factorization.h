@@ -0,0 +1,658 @@
+///
+/// @file factorization.h Matrix factorization objects, which store
+/// the decomposition of a matrix so that it can be reused
+/// to solve many linear systems with the same matrix.
+///
+
+#ifndef THEORETICA_FACTORIZATION_H
+#define THEORETICA_FACTORIZATION_H
+
+#include <vector>
+#include "../core/error.h"
+#include "../core/core_traits.h"
+#include "../core/iter_result.h"
+#include "./algebra.h"
+#include "./mat.h"
+#include "./vec.h"
+
+
+namespace theoretica {
+
+
+	namespace _internal {
+
+
+		/// Solve a linear system for each column of a matrix of
+		/// known vectors, using the solve_inplace() method of a factorization.
+		///
+		/// @param F The factorization of the matrix of the system
+		/// @param B The matrix of known vectors
+		/// @return The matrix whose columns are the solutions
+		template<typename Factorization, typename Matrix>
+		inline Matrix solve_columns(const Factorization& F, const Matrix& B) {
+
+			Matrix X;
+			X.resize(F.cols(), B.cols());
+
+			if (B.rows() != F.rows()) {
+				TH_MATH_ERROR("solve_many", B.rows(), MathError::InvalidArgument);
+				return algebra::mat_error(X);
+			}
+
+			// Column buffer reused for all known vectors
+			vec<matrix_element_t<Matrix>> col (B.rows());
+
+			for (unsigned int j = 0; j < B.cols(); ++j) {
+
+				for (unsigned int i = 0; i < B.rows(); ++i)
+					col[i] = B(i, j);
+
+				F.solve_inplace(col);
+
+				for (unsigned int i = 0; i < X.rows(); ++i)
+					X(i, j) = col[i];
+			}
+
+			return X;
+		}
+	}
+
+
+	/// @class lu_factor
+	/// LU decomposition with partial pivoting of a square matrix,
+	/// so that \f$PA = LU\f$. The decomposition is computed once on
+	/// construction, using algebra::decompose_lu_pivot_inplace, and then
+	/// reused to solve linear systems for any number of known vectors,
+	/// with a cost of \f$O(n^2)\f$ for each system instead of \f$O(n^3)\f$.
+	///
+	/// @tparam Matrix The type of the matrix to store the decomposition in
+	template<typename Matrix = mat<real>>
+	class lu_factor {
+		public:
+
+			/// The type of the elements of the factorization
+			using value_type = matrix_element_t<Matrix>;
+
+			/// The L and U factors stored in the same matrix,
+			/// omitting the diagonal of L (equal to all ones)
+			Matrix LU;
+
+			/// The row permutation, so that the i-th row
+			/// of PA is the perm[i]-th row of A
+			std::vector<unsigned int> perm;
+
+
+			/// Default constructor, the factorization
+			/// needs to be computed using decompose().
+			lu_factor() = default;
+
+
+			/// Construct the factorization of a square matrix.
+			///
+			/// @param A The matrix to decompose
+			template<typename Matrix2>
+			lu_factor(const Matrix2& A) {
+				decompose(A);
+			}
+
+
+			/// Compute the factorization of a square matrix,
+			/// overwriting any previous factorization.
+			///
+			/// @param A The matrix to decompose
+			/// @return A reference to the factorization
+			template<typename Matrix2>
+			inline lu_factor& decompose(const Matrix2& A) {
+
+				LU.resize(A.rows(), A.cols());
+				algebra::mat_copy(LU, A);
+				algebra::decompose_lu_pivot_inplace(LU, perm);
+
+				return *this;
+			}
+
+
+			/// Solve the linear system \f$A \vec x = \vec b\f$
+			/// using the factorization, overwriting the known vector
+			/// with the solution.
+			///
+			/// @param b The known vector, to be overwritten with the solution
+			/// @return A reference to the overwritten vector
+			template<typename Vector>
+			inline Vector& solve_inplace(Vector& b) const {
+				return algebra::solve_lu_pivot_inplace(LU, perm, b);
+			}
+
+
+			/// Solve the linear system \f$A \vec x = \vec b\f$
+			/// using the factorization.
+			///
+			/// @param b The known vector
+			/// @return The solution of the linear system
+			template<typename Vector>
+			inline Vector solve(const Vector& b) const {
+
+				Vector x = algebra::clone(b);
+				return solve_inplace(x);
+			}
+
+
+			/// Solve the linear system \f$A X = B\f$ for many known
+			/// vectors at once, given as the columns of a matrix.
+			///
+			/// @param B The matrix of known vectors
+			/// @return The matrix whose columns are the solutions
+			template<typename Matrix2>
+			inline Matrix2 solve_many(const Matrix2& B) const {
+				return _internal::solve_columns(*this, B);
+			}
+
+
+			/// Compute the determinant of the decomposed matrix,
+			/// as the product of the diagonal of U and the sign
+			/// of the permutation.
+			///
+			/// @return The determinant of the matrix
+			inline auto det() const {
+
+				const auto d = algebra::diagonal_product(LU);
+				return algebra::permutation_sign(perm) > 0 ? d : -d;
+			}
+
+
+			/// Compute the inverse of the decomposed matrix,
+			/// by solving the linear system for the columns of the identity.
+			///
+			/// @return The inverse matrix
+			inline Matrix inverse() const {
+
+				Matrix I;
+				I.resize(LU.rows(), LU.cols());
+				algebra::make_identity(I);
+
+				return solve_many(I);
+			}
+
+
+			/// Get the number of rows of the decomposed matrix.
+			inline unsigned int rows() const {
+				return LU.rows();
+			}
+
+
+			/// Get the number of columns of the decomposed matrix.
+			inline unsigned int cols() const {
+				return LU.cols();
+			}
+	};
+
+
+	/// @class cholesky_factor
+	/// Cholesky decomposition of a symmetric positive definite matrix,
+	/// so that \f$A = L L^T\f$. The decomposition is computed once on
+	/// construction, using algebra::decompose_cholesky_inplace, and then
+	/// reused to solve linear systems for any number of known vectors,
+	/// such as the normal equations of a linear regression.
+	///
+	/// @tparam Matrix The type of the matrix to store the decomposition in
+	template<typename Matrix = mat<real>>
+	class cholesky_factor {
+		public:
+
+			/// The type of the elements of the factorization
+			using value_type = matrix_element_t<Matrix>;
+
+			/// The lower triangular factor
+			Matrix L;
+
+
+			/// Default constructor, the factorization
+			/// needs to be computed using decompose().
+			cholesky_factor() = default;
+
+
+			/// Construct the factorization of a symmetric
+			/// positive definite matrix.
+			///
+			/// @param A The matrix to decompose
+			template<typename Matrix2>
+			cholesky_factor(const Matrix2& A) {
+				decompose(A);
+			}
+
+
+			/// Compute the factorization of a symmetric positive
+			/// definite matrix, overwriting any previous factorization.
+			///
+			/// @param A The matrix to decompose
+			/// @return A reference to the factorization
+			template<typename Matrix2>
+			inline cholesky_factor& decompose(const Matrix2& A) {
+
+				L.resize(A.rows(), A.cols());
+				algebra::mat_copy(L, A);
+				algebra::decompose_cholesky_inplace(L);
+
+				return *this;
+			}
+
+
+			/// Solve the linear system \f$A \vec x = \vec b\f$
+			/// using the factorization, overwriting the known vector
+			/// with the solution.
+			///
+			/// @param b The known vector, to be overwritten with the solution
+			/// @return A reference to the overwritten vector
+			template<typename Vector>
+			inline Vector& solve_inplace(Vector& b) const {
+
+				if (L.rows() != b.size()) {
+					TH_MATH_ERROR("cholesky_factor::solve_inplace", b.size(), MathError::InvalidArgument);
+					return algebra::vec_error(b);
+				}
+
+				using Type = matrix_element_t<Matrix>;
+
+				// Forward elimination for L
+				for (unsigned int i = 0; i < L.rows(); ++i) {
+
+					Type sum = Type(0.0);
+
+					for (unsigned int j = 0; j < i; ++j)
+						sum += L(i, j) * b[j];
+
+					b[i] = (b[i] - sum) / L(i, i);
+				}
+
+				// Backward elimination for L transpose
+				for (int i = L.rows() - 1; i >= 0; --i) {
+
+					Type sum = Type(0.0);
+
+					for (unsigned int j = i + 1; j < L.rows(); ++j)
+						sum += L(j, i) * b[j];
+
+					b[i] = (b[i] - sum) / L(i, i);
+				}
+
+				return b;
+			}
+
+
+			/// Solve the linear system \f$A \vec x = \vec b\f$
+			/// using the factorization.
+			///
+			/// @param b The known vector
+			/// @return The solution of the linear system
+			template<typename Vector>
+			inline Vector solve(const Vector& b) const {
+
+				Vector x = algebra::clone(b);
+				return solve_inplace(x);
+			}
+
+
+			/// Solve the linear system \f$A X = B\f$ for many known
+			/// vectors at once, given as the columns of a matrix.
+			///
+			/// @param B The matrix of known vectors
+			/// @return The matrix whose columns are the solutions
+			template<typename Matrix2>
+			inline Matrix2 solve_many(const Matrix2& B) const {
+				return _internal::solve_columns(*this, B);
+			}
+
+
+			/// Compute the determinant of the decomposed matrix,
+			/// as the square of the product of the diagonal of L.
+			///
+			/// @return The determinant of the matrix
+			inline auto det() const {
+
+				const auto d = algebra::diagonal_product(L);
+				return d * d;
+			}
+
+
+			/// Compute the inverse of the decomposed matrix,
+			/// by solving the linear system for the columns of the identity.
+			///
+			/// @return The inverse matrix
+			inline Matrix inverse() const {
+
+				Matrix I;
+				I.resize(L.rows(), L.cols());
+				algebra::make_identity(I);
+
+				return solve_many(I);
+			}
+
+
+			/// Update the factorization after adding the outer product
+			/// \f$\vec v \vec v^T\f$ to the decomposed matrix, such as when
+			/// an observation is added to a least squares problem,
+			/// with \f$O(n^2)\f$ complexity.
+			///
+			/// @param v The vector of the rank-one update
+			/// @return A reference to the factorization
+			template<typename Vector>
+			inline cholesky_factor& update(const Vector& v) {
+
+				algebra::cholesky_update(L, v);
+				return *this;
+			}
+
+
+			/// Update the factorization after subtracting the outer product
+			/// \f$\vec v \vec v^T\f$ from the decomposed matrix, such as when
+			/// an observation is removed from a least squares problem,
+			/// with \f$O(n^2)\f$ complexity. The resulting matrix must
+			/// still be positive definite, an error is raised otherwise.
+			///
+			/// @param v The vector of the rank-one downdate
+			/// @return A reference to the factorization
+			template<typename Vector>
+			inline cholesky_factor& downdate(const Vector& v) {
+
+				algebra::cholesky_downdate(L, v);
+				return *this;
+			}
+
+
+			/// Get the number of rows of the decomposed matrix.
+			inline unsigned int rows() const {
+				return L.rows();
+			}
+
+
+			/// Get the number of columns of the decomposed matrix.
+			inline unsigned int cols() const {
+				return L.cols();
+			}
+	};
+
+
+	/// @class qr_factor
+	/// QR decomposition of a real matrix with at least as many rows
+	/// as columns, using Householder reflections, so that \f$A = QR\f$.
+	/// The decomposition is computed once on construction, using
+	/// algebra::decompose_qr_inplace, and then reused to solve linear
+	/// systems, or least squares problems for rectangular matrices,
+	/// for any number of known vectors.
+	///
+	/// @tparam Matrix The type of the matrix to store the decomposition in
+	template<typename Matrix = mat<real>>
+	class qr_factor {
+		public:
+
+			/// The type of the elements of the factorization
+			using value_type = matrix_element_t<Matrix>;
+
+			/// The upper triangular factor R and, under
+			/// the diagonal, the Householder vectors
+			Matrix QR;
+
+			/// The scalar factors of the Householder reflections
+			vec<matrix_element_t<Matrix>> tau;
+
+
+			/// Default constructor, the factorization
+			/// needs to be computed using decompose().
+			qr_factor() = default;
+
+
+			/// Construct the factorization of a matrix.
+			///
+			/// @param A The matrix to decompose
+			template<typename Matrix2>
+			qr_factor(const Matrix2& A) {
+				decompose(A);
+			}
+
+
+			/// Compute the factorization of a matrix,
+			/// overwriting any previous factorization.
+			///
+			/// @param A The matrix to decompose
+			/// @return A reference to the factorization
+			template<typename Matrix2>
+			inline qr_factor& decompose(const Matrix2& A) {
+
+				QR.resize(A.rows(), A.cols());
+				algebra::mat_copy(QR, A);
+				algebra::decompose_qr_inplace(QR, tau);
+
+				return *this;
+			}
+
+
+			/// Solve the linear system \f$A \vec x = \vec b\f$
+			/// using the factorization, overwriting the known vector.
+			/// For rectangular matrices, the least squares solution
+			/// is written to the first cols() elements of the vector.
+			///
+			/// @param b The known vector, to be overwritten with the solution
+			/// @return A reference to the overwritten vector
+			template<typename Vector>
+			inline Vector& solve_inplace(Vector& b) const {
+
+				if (b.size() != QR.rows()) {
+					TH_MATH_ERROR("qr_factor::solve_inplace", b.size(), MathError::InvalidArgument);
+					return algebra::vec_error(b);
+				}
+
+				algebra::householder_qt_inplace(QR, tau, b);
+
+				using Type = matrix_element_t<Matrix>;
+
+				// Backward elimination for R
+				for (int i = QR.cols() - 1; i >= 0; --i) {
+
+					if (abs(QR(i, i)) < MACH_EPSILON) {
+						TH_MATH_ERROR("qr_factor::solve_inplace", QR(i, i), MathError::DivByZero);
+						return algebra::vec_error(b);
+					}
+
+					Type sum = Type(0.0);
+
+					for (unsigned int j = i + 1; j < QR.cols(); ++j)
+						sum += QR(i, j) * b[j];
+
+					b[i] = (b[i] - sum) / QR(i, i);
+				}
+
+				return b;
+			}
+
+
+			/// Solve the linear system \f$A \vec x = \vec b\f$
+			/// using the factorization. For rectangular matrices,
+			/// the least squares solution is computed.
+			///
+			/// @param b The known vector
+			/// @return The solution of the linear system
+			template<typename Vector>
+			inline Vector solve(const Vector& b) const {
+				return algebra::solve_qr(QR, tau, b);
+			}
+
+
+			/// Solve the linear system \f$A X = B\f$ for many known
+			/// vectors at once, given as the columns of a matrix.
+			///
+			/// @param B The matrix of known vectors
+			/// @return The matrix whose columns are the solutions
+			template<typename Matrix2>
+			inline Matrix2 solve_many(const Matrix2& B) const {
+				return _internal::solve_columns(*this, B);
+			}
+
+
+			/// Compute the determinant of the decomposed square matrix,
+			/// as the product of the diagonal of R, with the sign
+			/// changed by each non-trivial reflection.
+			///
+			/// @return The determinant of the matrix
+			inline auto det() const {
+
+				const auto d = algebra::diagonal_product(QR);
+
+				if (QR.rows() != QR.cols()) {
+					TH_MATH_ERROR("qr_factor::det", QR.rows(), MathError::InvalidArgument);
+					return decltype(d)(nan());
+				}
+
+				unsigned int reflections = 0;
+
+				for (unsigned int i = 0; i < tau.size(); ++i)
+					if (tau[i] != 0.0)
+						reflections++;
+
+				return (reflections % 2 == 0) ? d : -d;
+			}
+
+
+			/// Compute the inverse of the decomposed square matrix,
+			/// by solving the linear system for the columns of the identity.
+			///
+			/// @return The inverse matrix
+			inline Matrix inverse() const {
+
+				Matrix I;
+				I.resize(QR.rows(), QR.cols());
+
+				if (QR.rows() != QR.cols()) {
+					TH_MATH_ERROR("qr_factor::inverse", QR.rows(), MathError::InvalidArgument);
+					return algebra::mat_error(I);
+				}
+
+				algebra::make_identity(I);
+				return solve_many(I);
+			}
+
+
+			/// Get the number of rows of the decomposed matrix.
+			inline unsigned int rows() const {
+				return QR.rows();
+			}
+
+
+			/// Get the number of columns of the decomposed matrix.
+			inline unsigned int cols() const {
+				return QR.cols();
+			}
+	};
+
+
+	namespace algebra {
+
+
+		/// Solve the linear system \f$A \vec x = \vec b\f$ in mixed precision.
+		/// The matrix is factorized in single precision, halving the memory
+		/// traffic and doubling the SIMD width of the factorization, and double
+		/// precision accuracy is recovered by iterative refinement, computing
+		/// the residuals in double precision. Refinement stops when the backward
+		/// error \f$\|\vec b - A \vec x\|_\infty / (\|A\|_\infty \|\vec x\|_\infty)\f$,
+		/// reported as the residual of the result, is below \f$\sqrt{n} \epsilon\f$.
+		/// For matrices too ill-conditioned for single precision refinement
+		/// stalls, as reported by the status of the result, and the system
+		/// should be solved in double precision instead, e.g. using solve().
+		///
+		/// @param A The matrix of the linear system
+		/// @param b The known vector
+		/// @param max_iter The maximum number of refinement steps
+		/// @return The solution, with the number of refinement steps
+		/// @tparam Factorization The single precision factorization,
+		/// such as cholesky_factor<mat<float>> for symmetric positive definite
+		/// matrices, defaults to lu_factor<mat<float>>
+		template<typename Factorization = lu_factor<mat<float>>, typename Matrix, typename Vector>
+		inline iter_result<Vector> solve_mixed(
+			const Matrix& A, const Vector& b,
+			unsigned int max_iter = ALGEBRA_REFINE_ITER) {
+
+			using Type = typename Factorization::value_type;
+			const unsigned int n = A.rows();
+
+			Vector x;
+			x.resize(n);
+
+			if (!is_square(A)) {
+				TH_MATH_ERROR("algebra::solve_mixed", A.rows(), MathError::InvalidArgument);
+				return iter_result<Vector>(vec_error(x), ConvergenceStatus::InvalidInput, 0, inf());
+			}
+
+			if (b.size() != n) {
+				TH_MATH_ERROR("algebra::solve_mixed", b.size(), MathError::InvalidArgument);
+				return iter_result<Vector>(vec_error(x), ConvergenceStatus::InvalidInput, 0, inf());
+			}
+
+			const Factorization F (A);
+
+			// Infinity norm of the matrix
+			real A_norm = 0.0;
+
+			for (unsigned int i = 0; i < n; ++i) {
+
+				real row = 0.0;
+
+				for (unsigned int j = 0; j < n; ++j)
+					row += abs(A(i, j));
+
+				A_norm = max(A_norm, row);
+			}
+
+			const real tol = sqrt(real(n)) * MACH_EPSILON;
+
+			// Starting from x = 0, the first correction
+			// is the single precision solution
+			vec_zeroes(x);
+
+			Vector r = algebra::clone(b);
+			vec<Type> d (n);
+			real prev_err = inf();
+
+			for (unsigned int iter = 0; iter <= max_iter; ++iter) {
+
+				// Solve for the correction in single precision
+				for (unsigned int i = 0; i < n; ++i)
+					d[i] = Type(r[i]);
+
+				F.solve_inplace(d);
+
+				for (unsigned int i = 0; i < n; ++i)
+					x[i] += d[i];
+
+				// Compute the residual in double precision
+				real r_norm = 0.0;
+				real x_norm = 0.0;
+
+				for (unsigned int i = 0; i < n; ++i) {
+
+					real sum = b[i];
+
+					for (unsigned int j = 0; j < n; ++j)
+						sum -= A(i, j) * x[j];
+
+					r[i] = sum;
+					r_norm = max(r_norm, abs(sum));
+					x_norm = max(x_norm, abs(x[i]));
+				}
+
+				const real err = (r_norm == 0.0) ? 0.0 : r_norm / (A_norm * x_norm);
+
+				if (err <= tol)
+					return iter_result<Vector>(x, iter, err);
+
+				// The correction did not reduce the error
+				if (!(err < prev_err))
+					return iter_result<Vector>(x, ConvergenceStatus::Stalled, iter, err);
+
+				prev_err = err;
+			}
+
+			return iter_result<Vector>(x, ConvergenceStatus::MaxIterations, max_iter, prev_err);
+		}
+	}
+}
+
+#endif
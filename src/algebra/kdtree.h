@@ -0,0 +1,465 @@
+
+///
+/// @file kdtree.h A k-d tree index over sets of points,
+/// for nearest neighbour and radius queries.
+///
+
+#ifndef THEORETICA_KDTREE_H
+#define THEORETICA_KDTREE_H
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include "../core/error.h"
+#include "../core/constants.h"
+#include "../core/core_traits.h"
+#include "../core/real_analysis.h"
+
+
+namespace theoretica {
+
+
+	/// @class kd_tree
+	/// A k-d tree over a set of points, stored as the rows of a matrix,
+	/// which answers k-nearest neighbour and radius queries under the
+	/// Euclidean distance in logarithmic time on average, instead
+	/// of comparing the query with every point.
+	///
+	/// The set of points is recursively split at the median of
+	/// the coordinate with the largest spread, until each leaf
+	/// contains at most leaf_size points. The points are copied
+	/// contiguously in the order of the leaves, so that each leaf
+	/// is scanned linearly in memory.
+	class kd_tree {
+		public:
+
+			/// A point found by a query, with the index of its
+			/// row in the original matrix and its distance from the query.
+			struct neighbour {
+
+				/// The index of the point in the original matrix
+				unsigned int index;
+
+				/// The Euclidean distance of the point from the query
+				real distance;
+			};
+
+		private:
+
+			/// A node of the tree, which covers a range of points
+			struct node {
+
+				/// The first point of the node in tree order
+				unsigned int begin;
+
+				/// One past the last point of the node in tree order
+				unsigned int end;
+
+				/// The coordinate along which the node is split
+				unsigned int axis;
+
+				/// The value of the coordinate at which the node is split
+				real split;
+
+				/// The indices of the children nodes,
+				/// equal to zero for leaves
+				unsigned int left;
+				unsigned int right;
+			};
+
+			/// The coordinates of the points in tree order,
+			/// stored contiguously point by point
+			std::vector<real> points;
+
+			/// The index of each point in the original matrix
+			std::vector<unsigned int> indices;
+
+			/// The nodes of the tree, with the root at index zero
+			std::vector<node> nodes;
+
+			/// The number of coordinates of each point
+			unsigned int dimension {0};
+
+
+			/// Recursively build the subtree of the given range of points.
+			///
+			/// @param data The coordinates of the points in the original order
+			/// @param begin The first point of the range in tree order
+			/// @param end One past the last point of the range in tree order
+			/// @param leaf_size The maximum number of points in a leaf
+			/// @return The index of the new node
+			inline unsigned int build_node(
+				const std::vector<real>& data, unsigned int begin,
+				unsigned int end, unsigned int leaf_size) {
+
+				const unsigned int n = nodes.size();
+				nodes.push_back({begin, end, 0, 0.0, 0, 0});
+
+				if (end - begin <= leaf_size)
+					return n;
+
+				// Split along the coordinate with the largest spread
+				unsigned int axis = 0;
+				real max_spread = 0.0;
+
+				for (unsigned int k = 0; k < dimension; ++k) {
+
+					real lower = data[indices[begin] * dimension + k];
+					real upper = lower;
+
+					for (unsigned int p = begin + 1; p < end; ++p) {
+						const real x = data[indices[p] * dimension + k];
+						lower = min(lower, x);
+						upper = max(upper, x);
+					}
+
+					if (upper - lower > max_spread) {
+						max_spread = upper - lower;
+						axis = k;
+					}
+				}
+
+				// All points coincide
+				if (max_spread <= 0.0)
+					return n;
+
+				const unsigned int mid = begin + (end - begin) / 2;
+
+				std::nth_element(
+					indices.begin() + begin, indices.begin() + mid,
+					indices.begin() + end,
+					[&](unsigned int a, unsigned int b) {
+						return data[a * dimension + axis] < data[b * dimension + axis];
+					}
+				);
+
+				nodes[n].axis = axis;
+				nodes[n].split = data[indices[mid] * dimension + axis];
+
+				const unsigned int left = build_node(data, begin, mid, leaf_size);
+				const unsigned int right = build_node(data, mid, end, leaf_size);
+				nodes[n].left = left;
+				nodes[n].right = right;
+
+				return n;
+			}
+
+
+			/// Compute the squared distance between the query
+			/// and the point at the given position in tree order.
+			inline real sqr_distance(const real* x, unsigned int p) const {
+
+				const real* y = &points[p * dimension];
+				real sum = 0.0;
+
+				for (unsigned int k = 0; k < dimension; ++k)
+					sum += square(x[k] - y[k]);
+
+				return sum;
+			}
+
+
+			/// Recursively search the k nearest neighbours of a point,
+			/// keeping the best candidates in a max-heap of squared distances.
+			inline void search_nearest(
+				unsigned int n, const real* x, unsigned int k,
+				std::vector<std::pair<real, unsigned int>>& heap) const {
+
+				const node& nd = nodes[n];
+
+				if (nd.left == 0) {
+
+					for (unsigned int p = nd.begin; p < nd.end; ++p) {
+
+						const real d = sqr_distance(x, p);
+
+						if (heap.size() < k) {
+							heap.emplace_back(d, p);
+							std::push_heap(heap.begin(), heap.end());
+						} else if (d < heap.front().first) {
+							std::pop_heap(heap.begin(), heap.end());
+							heap.back() = std::make_pair(d, p);
+							std::push_heap(heap.begin(), heap.end());
+						}
+					}
+
+					return;
+				}
+
+				// Visit the side of the query first, then the other side
+				// only if it may contain a point closer than the candidates
+				const real diff = x[nd.axis] - nd.split;
+				const unsigned int near = diff < 0.0 ? nd.left : nd.right;
+				const unsigned int far = diff < 0.0 ? nd.right : nd.left;
+
+				search_nearest(near, x, k, heap);
+
+				if (heap.size() < k || square(diff) < heap.front().first)
+					search_nearest(far, x, k, heap);
+			}
+
+
+			/// Recursively search the points inside a ball
+			/// of the given squared radius around a point.
+			inline void search_within(
+				unsigned int n, const real* x, real sqr_radius,
+				std::vector<std::pair<real, unsigned int>>& found) const {
+
+				const node& nd = nodes[n];
+
+				if (nd.left == 0) {
+
+					for (unsigned int p = nd.begin; p < nd.end; ++p) {
+
+						const real d = sqr_distance(x, p);
+
+						if (d <= sqr_radius)
+							found.emplace_back(d, p);
+					}
+
+					return;
+				}
+
+				const real diff = x[nd.axis] - nd.split;
+
+				if (diff <= 0.0 || square(diff) <= sqr_radius)
+					search_within(nd.left, x, sqr_radius, found);
+
+				if (diff >= 0.0 || square(diff) <= sqr_radius)
+					search_within(nd.right, x, sqr_radius, found);
+			}
+
+
+			/// Convert pairs of squared distances and positions
+			/// in tree order to neighbours sorted by distance.
+			inline std::vector<neighbour> to_neighbours(
+				std::vector<std::pair<real, unsigned int>>& found) const {
+
+				std::sort(found.begin(), found.end());
+				std::vector<neighbour> res (found.size());
+
+				for (unsigned int i = 0; i < found.size(); ++i)
+					res[i] = { indices[found[i].second], sqrt(found[i].first) };
+
+				return res;
+			}
+
+
+			/// Copy the coordinates of a query point contiguously,
+			/// checking that its dimension is compatible with the tree.
+			template<typename Vector>
+			inline bool read_query(
+				const Vector& x, std::vector<real>& query, const char* fname) const {
+
+				(void) fname;
+
+				if (x.size() != dimension) {
+					TH_MATH_ERROR(fname, x.size(), MathError::InvalidArgument);
+					return false;
+				}
+
+				query.resize(dimension);
+
+				for (unsigned int k = 0; k < dimension; ++k)
+					query[k] = x[k];
+
+				return true;
+			}
+
+
+		public:
+
+			/// Construct an empty tree
+			kd_tree() {}
+
+
+			/// Construct the tree over the rows of a matrix.
+			///
+			/// @param X The set of points, one for each row
+			/// @param leaf_size The maximum number of points in a leaf
+			template<typename Matrix, enable_matrix<Matrix> = true>
+			kd_tree(const Matrix& X, unsigned int leaf_size = ALGEBRA_KDTREE_LEAF) {
+				build(X, leaf_size);
+			}
+
+
+			/// Build the tree over the rows of a matrix,
+			/// discarding any previous content.
+			///
+			/// @param X The set of points, one for each row
+			/// @param leaf_size The maximum number of points in a leaf
+			/// @return A reference to the tree
+			template<typename Matrix, enable_matrix<Matrix> = true>
+			inline kd_tree& build(const Matrix& X, unsigned int leaf_size = ALGEBRA_KDTREE_LEAF) {
+
+				const unsigned int N = X.rows();
+				dimension = X.cols();
+				nodes.clear();
+
+				if (leaf_size == 0) {
+					TH_MATH_ERROR("kd_tree::build", leaf_size, MathError::InvalidArgument);
+					leaf_size = 1;
+				}
+
+				std::vector<real> data (N * dimension);
+
+				for (unsigned int i = 0; i < N; ++i)
+					for (unsigned int k = 0; k < dimension; ++k)
+						data[i * dimension + k] = X(i, k);
+
+				indices.resize(N);
+				std::iota(indices.begin(), indices.end(), 0);
+
+				if (N > 0)
+					build_node(data, 0, N, leaf_size);
+
+				// Store the points contiguously in tree order
+				points.resize(N * dimension);
+
+				for (unsigned int p = 0; p < N; ++p)
+					std::copy(
+						data.begin() + indices[p] * dimension,
+						data.begin() + (indices[p] + 1) * dimension,
+						points.begin() + p * dimension
+					);
+
+				return *this;
+			}
+
+
+			/// Find the k nearest neighbours of a point.
+			///
+			/// @param x The query point
+			/// @param k The number of neighbours to find
+			/// @return The min(k, size()) nearest points,
+			/// sorted by increasing distance from x
+			template<typename Vector, enable_vector<Vector> = true, disable_matrix<Vector> = true>
+			inline std::vector<neighbour> nearest(const Vector& x, unsigned int k) const {
+
+				std::vector<real> query;
+				std::vector<std::pair<real, unsigned int>> heap;
+
+				if (!read_query(x, query, "kd_tree::nearest") || !nodes.size() || !k)
+					return {};
+
+				heap.reserve(k);
+				search_nearest(0, query.data(), k, heap);
+
+				return to_neighbours(heap);
+			}
+
+
+			/// Find the k nearest neighbours of each row of a matrix.
+			/// The queries are answered in parallel.
+			///
+			/// @param Q The query points, one for each row
+			/// @param k The number of neighbours to find
+			/// @return A list with the nearest neighbours of each query,
+			/// each sorted by increasing distance
+			template<typename Matrix, enable_matrix<Matrix> = true>
+			inline std::vector<std::vector<neighbour>> nearest(
+				const Matrix& Q, unsigned int k) const {
+
+				std::vector<std::vector<neighbour>> res (Q.rows());
+
+				if (Q.cols() != dimension) {
+					TH_MATH_ERROR("kd_tree::nearest", Q.cols(), MathError::InvalidArgument);
+					return res;
+				}
+
+				if (!nodes.size() || !k)
+					return res;
+
+				#pragma omp parallel for schedule(dynamic)
+				for (unsigned int i = 0; i < Q.rows(); ++i) {
+
+					std::vector<real> query (dimension);
+					std::vector<std::pair<real, unsigned int>> heap;
+					heap.reserve(k);
+
+					for (unsigned int j = 0; j < dimension; ++j)
+						query[j] = Q(i, j);
+
+					search_nearest(0, query.data(), k, heap);
+					res[i] = to_neighbours(heap);
+				}
+
+				return res;
+			}
+
+
+			/// Find all points inside a ball around a point.
+			///
+			/// @param x The query point
+			/// @param radius The radius of the ball, inclusive
+			/// @return The points at a distance from x less than
+			/// or equal to the radius, sorted by increasing distance
+			template<typename Vector, enable_vector<Vector> = true, disable_matrix<Vector> = true>
+			inline std::vector<neighbour> within(const Vector& x, real radius) const {
+
+				std::vector<real> query;
+				std::vector<std::pair<real, unsigned int>> found;
+
+				if (!read_query(x, query, "kd_tree::within") || !nodes.size() || radius < 0.0)
+					return {};
+
+				search_within(0, query.data(), square(radius), found);
+
+				return to_neighbours(found);
+			}
+
+
+			/// Find all points inside a ball around each row of a matrix.
+			/// The queries are answered in parallel.
+			///
+			/// @param Q The query points, one for each row
+			/// @param radius The radius of the balls, inclusive
+			/// @return A list with the points inside the ball of each query,
+			/// each sorted by increasing distance
+			template<typename Matrix, enable_matrix<Matrix> = true>
+			inline std::vector<std::vector<neighbour>> within(
+				const Matrix& Q, real radius) const {
+
+				std::vector<std::vector<neighbour>> res (Q.rows());
+
+				if (Q.cols() != dimension) {
+					TH_MATH_ERROR("kd_tree::within", Q.cols(), MathError::InvalidArgument);
+					return res;
+				}
+
+				if (!nodes.size() || radius < 0.0)
+					return res;
+
+				#pragma omp parallel for schedule(dynamic)
+				for (unsigned int i = 0; i < Q.rows(); ++i) {
+
+					std::vector<real> query (dimension);
+					std::vector<std::pair<real, unsigned int>> found;
+
+					for (unsigned int j = 0; j < dimension; ++j)
+						query[j] = Q(i, j);
+
+					search_within(0, query.data(), square(radius), found);
+					res[i] = to_neighbours(found);
+				}
+
+				return res;
+			}
+
+
+			/// Get the number of points in the tree
+			inline unsigned int size() const {
+				return indices.size();
+			}
+
+
+			/// Get the number of coordinates of each point
+			inline unsigned int dim() const {
+				return dimension;
+			}
+	};
+
+}
+
+#endif
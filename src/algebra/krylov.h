@@ -0,0 +1,562 @@
+///
+/// @file krylov.h Krylov subspace iterative solvers for linear systems
+/// (conjugate gradient, BiCGSTAB and restarted GMRES) with preconditioners.
+///
+
+#ifndef THEORETICA_KRYLOV_H
+#define THEORETICA_KRYLOV_H
+
+#include <vector>
+#include "../core/error.h"
+#include "../core/constants.h"
+#include "../core/core_traits.h"
+#include "../core/iter_result.h"
+#include "./algebra.h"
+#include "./sparse.h"
+#include "./vec.h"
+
+
+namespace theoretica {
+
+
+	/// @class identity_preconditioner
+	/// Trivial preconditioner which returns its argument unchanged,
+	/// used by default by iterative solvers.
+	struct identity_preconditioner {
+
+		/// Apply the preconditioner to a vector
+		template<typename Vector>
+		inline Vector operator()(const Vector& r) const {
+			return r;
+		}
+	};
+
+
+	/// @class jacobi_preconditioner
+	/// Diagonal (Jacobi) preconditioner, which approximates
+	/// the inverse of a matrix with the inverse of its diagonal.
+	///
+	/// @tparam Type The type of the elements
+	template<typename Type = real>
+	class jacobi_preconditioner {
+		public:
+
+			/// The inverse of the diagonal elements
+			std::vector<Type> inv_diag;
+
+
+			/// Construct the preconditioner from the diagonal of a matrix.
+			///
+			/// @param A The matrix of the linear system
+			template<typename Matrix>
+			jacobi_preconditioner(const Matrix& A) {
+
+				inv_diag.resize(min(A.rows(), A.cols()));
+
+				for (unsigned int i = 0; i < inv_diag.size(); ++i) {
+
+					if (abs(A(i, i)) < MACH_EPSILON) {
+						TH_MATH_ERROR("jacobi_preconditioner", A(i, i), MathError::DivByZero);
+						inv_diag[i] = Type(nan());
+						continue;
+					}
+
+					inv_diag[i] = Type(1.0) / A(i, i);
+				}
+			}
+
+
+			/// Apply the preconditioner to a vector
+			template<typename Vector>
+			inline Vector operator()(const Vector& r) const {
+
+				Vector z = algebra::clone(r);
+
+				for (unsigned int i = 0; i < z.size(); ++i)
+					z[i] *= inv_diag[i];
+
+				return z;
+			}
+	};
+
+
+	/// @class ilu0_preconditioner
+	/// Incomplete LU factorization with zero fill-in, ILU(0), computing
+	/// triangular factors L and U with the same sparsity pattern as the
+	/// matrix, so that \f$LU \approx A\f$. The factors are stored together
+	/// in a CSR sparse matrix, omitting the unit diagonal of L.
+	///
+	/// @tparam Type The type of the elements
+	template<typename Type = real>
+	class ilu0_preconditioner {
+		public:
+
+			/// The incomplete factors L and U
+			sparse_mat<Type> LU;
+
+			/// The position of the diagonal element of each row in LU
+			std::vector<unsigned int> diag;
+
+
+			/// Compute the incomplete factorization of a square matrix,
+			/// which may be dense or sparse. The diagonal of the
+			/// matrix is expected to be non-zero.
+			///
+			/// @param A The matrix of the linear system
+			template<typename Matrix>
+			ilu0_preconditioner(const Matrix& A) : LU(A) {
+
+				const unsigned int n = LU.rows();
+				diag.assign(n, 0);
+
+				if (!algebra::is_square(A)) {
+					TH_MATH_ERROR("ilu0_preconditioner", A.rows(), MathError::InvalidArgument);
+					std::fill(LU.values.begin(), LU.values.end(), Type(nan()));
+					return;
+				}
+
+				// Map from column index to position in the current row
+				const unsigned int none = LU.values.size();
+				std::vector<unsigned int> pos (n, none);
+
+				for (unsigned int i = 0; i < n; ++i) {
+
+					const unsigned int begin = LU.offsets[i];
+					const unsigned int end = LU.offsets[i + 1];
+
+					for (unsigned int k = begin; k < end; ++k)
+						pos[LU.indices[k]] = k;
+
+					if (pos[i] == none) {
+						TH_MATH_ERROR("ilu0_preconditioner", i, MathError::DivByZero);
+						std::fill(LU.values.begin(), LU.values.end(), Type(nan()));
+						return;
+					}
+
+					diag[i] = pos[i];
+
+					// Eliminate the elements under the diagonal,
+					// updating only the existing elements of the row
+					for (unsigned int k = begin; k < end && LU.indices[k] < i; ++k) {
+
+						const unsigned int l = LU.indices[k];
+						LU.values[k] /= LU.values[diag[l]];
+
+						for (unsigned int p = diag[l] + 1; p < LU.offsets[l + 1]; ++p)
+							if (pos[LU.indices[p]] != none)
+								LU.values[pos[LU.indices[p]]] -= LU.values[k] * LU.values[p];
+					}
+
+					for (unsigned int k = begin; k < end; ++k)
+						pos[LU.indices[k]] = none;
+				}
+			}
+
+
+			/// Apply the preconditioner to a vector,
+			/// solving \f$LU \vec z = \vec r\f$.
+			template<typename Vector>
+			inline Vector operator()(const Vector& r) const {
+
+				Vector z = algebra::clone(r);
+				const unsigned int n = LU.rows();
+
+				// Forward substitution with unit lower triangular L
+				for (unsigned int i = 0; i < n; ++i)
+					for (unsigned int k = LU.offsets[i]; k < diag[i]; ++k)
+						z[i] -= LU.values[k] * z[LU.indices[k]];
+
+				// Backward substitution with U
+				for (int i = n - 1; i >= 0; --i) {
+
+					for (unsigned int k = diag[i] + 1; k < LU.offsets[i + 1]; ++k)
+						z[i] -= LU.values[k] * z[LU.indices[k]];
+
+					z[i] /= LU.values[diag[i]];
+				}
+
+				return z;
+			}
+	};
+
+
+	namespace algebra {
+
+
+		namespace _internal {
+
+
+			/// Apply a matrix to a vector inside iterative solvers.
+			template<typename Matrix, typename Vector, enable_matrix<Matrix> = true>
+			inline Vector apply_operator(const Matrix& A, const Vector& x) {
+				return transform(A, x);
+			}
+
+
+			/// Apply a matrix-free linear operator to a vector
+			/// inside iterative solvers.
+			template<typename Operator, typename Vector, disable_matrix<Operator> = true>
+			inline Vector apply_operator(const Operator& A, const Vector& x) {
+				return A(x);
+			}
+
+
+			/// Compute y = y + alpha * x for generic vectors.
+			template<typename Vector, typename Type>
+			inline void axpy(Vector& y, Type alpha, const Vector& x) {
+
+				for (unsigned int i = 0; i < y.size(); ++i)
+					y[i] += alpha * x[i];
+			}
+		}
+
+
+		/// Solve the linear system \f$A \vec x = \vec b\f$ for a symmetric
+		/// positive definite matrix using the preconditioned conjugate gradient
+		/// method, starting from the null vector. Only the product of the
+		/// matrix with vectors is needed, so A may be a dense or sparse matrix
+		/// or a matrix-free linear operator (a function taking and returning a vector).
+		///
+		/// @param A The symmetric positive definite matrix or linear operator
+		/// @param b The known vector
+		/// @param M The preconditioner, a function approximating the action
+		/// of the inverse of A (defaults to the identity)
+		/// @param tolerance The tolerance on the residual norm, relative
+		/// to the norm of b (defaults to ALGEBRA_KRYLOV_TOL)
+		/// @param max_iter The maximum number of iterations
+		/// (defaults to ALGEBRA_KRYLOV_ITER)
+		/// @return The solution with convergence information
+		template<typename Operator, typename Vector,
+			typename Preconditioner = identity_preconditioner>
+		inline iter_result<Vector> solve_cg(
+			const Operator& A, const Vector& b,
+			const Preconditioner& M = Preconditioner(),
+			real tolerance = ALGEBRA_KRYLOV_TOL,
+			unsigned int max_iter = ALGEBRA_KRYLOV_ITER) {
+
+			Vector x = algebra::clone(b);
+			vec_zeroes(x);
+
+			const real b_norm = norm(b);
+
+			if (b_norm == 0.0)
+				return iter_result<Vector>(x, 0, 0.0);
+
+			Vector r = algebra::clone(b);
+			Vector z = M(r);
+			Vector p = algebra::clone(z);
+
+			auto rz = dot(r, z);
+			real res_norm = b_norm;
+			unsigned int iter;
+
+			for (iter = 1; iter <= max_iter; ++iter) {
+
+				const Vector Ap = _internal::apply_operator(A, p);
+				const auto pAp = dot(p, Ap);
+
+				// The method breaks down when the search direction is
+				// A-orthogonal to itself, which happens when A is not
+				// positive definite
+				if (abs(pAp) <= MACH_EPSILON * norm(p) * norm(Ap)) {
+					TH_MATH_ERROR("algebra::solve_cg", abs(pAp), MathError::DivByZero);
+					vec_error(x);
+					return iter_result<Vector>(x, ConvergenceStatus::Stalled, iter, res_norm);
+				}
+
+				const auto alpha = rz / pAp;
+
+				_internal::axpy(x, alpha, p);
+				_internal::axpy(r, -alpha, Ap);
+
+				res_norm = norm(r);
+
+				if (res_norm <= tolerance * b_norm)
+					return iter_result<Vector>(x, iter, res_norm);
+
+				z = M(r);
+				const auto rz_new = dot(r, z);
+				const auto beta = rz_new / rz;
+				rz = rz_new;
+
+				for (unsigned int i = 0; i < p.size(); ++i)
+					p[i] = z[i] + beta * p[i];
+			}
+
+			TH_MATH_ERROR("algebra::solve_cg", iter, MathError::NoConvergence);
+			vec_error(x);
+			return iter_result<Vector>(x, ConvergenceStatus::MaxIterations, max_iter, res_norm);
+		}
+
+
+		/// Solve the linear system \f$A \vec x = \vec b\f$ for a general square
+		/// matrix using the right-preconditioned BiCGSTAB method, starting from
+		/// the null vector. Only the product of the matrix with vectors is needed,
+		/// so A may be a dense or sparse matrix or a matrix-free linear operator.
+		///
+		/// @param A The matrix or linear operator
+		/// @param b The known vector
+		/// @param M The preconditioner, a function approximating the action
+		/// of the inverse of A (defaults to the identity)
+		/// @param tolerance The tolerance on the residual norm, relative
+		/// to the norm of b (defaults to ALGEBRA_KRYLOV_TOL)
+		/// @param max_iter The maximum number of iterations
+		/// (defaults to ALGEBRA_KRYLOV_ITER)
+		/// @return The solution with convergence information
+		template<typename Operator, typename Vector,
+			typename Preconditioner = identity_preconditioner>
+		inline iter_result<Vector> solve_bicgstab(
+			const Operator& A, const Vector& b,
+			const Preconditioner& M = Preconditioner(),
+			real tolerance = ALGEBRA_KRYLOV_TOL,
+			unsigned int max_iter = ALGEBRA_KRYLOV_ITER) {
+
+			using Type = vector_element_t<Vector>;
+
+			Vector x = algebra::clone(b);
+			vec_zeroes(x);
+
+			const real b_norm = norm(b);
+
+			if (b_norm == 0.0)
+				return iter_result<Vector>(x, 0, 0.0);
+
+			Vector r = algebra::clone(b);
+			const Vector r_hat = b;
+
+			Vector p = algebra::clone(x);
+			Vector v = algebra::clone(x);
+
+			Type rho = 1.0;
+			Type alpha = 1.0;
+			Type omega = 1.0;
+
+			real res_norm = b_norm;
+			unsigned int iter;
+
+			for (iter = 1; iter <= max_iter; ++iter) {
+
+				const Type rho_new = dot(r_hat, r);
+
+				// The method breaks down when r becomes
+				// orthogonal to the shadow residual
+				if (abs(rho_new) < MACH_EPSILON * b_norm * b_norm) {
+					TH_MATH_ERROR("algebra::solve_bicgstab", rho_new, MathError::NoConvergence);
+					vec_error(x);
+					return iter_result<Vector>(x, ConvergenceStatus::Stalled, iter, res_norm);
+				}
+
+				const Type beta = (rho_new / rho) * (alpha / omega);
+				rho = rho_new;
+
+				for (unsigned int i = 0; i < p.size(); ++i)
+					p[i] = r[i] + beta * (p[i] - omega * v[i]);
+
+				const Vector y = M(p);
+				v = _internal::apply_operator(A, y);
+				alpha = rho / dot(r_hat, v);
+
+				// Intermediate residual
+				Vector s = algebra::clone(r);
+				_internal::axpy(s, -alpha, v);
+				_internal::axpy(x, alpha, y);
+
+				res_norm = norm(s);
+
+				if (res_norm <= tolerance * b_norm)
+					return iter_result<Vector>(x, iter, res_norm);
+
+				const Vector z = M(s);
+				const Vector t = _internal::apply_operator(A, z);
+				omega = dot(t, s) / dot(t, t);
+
+				_internal::axpy(x, omega, z);
+
+				r = s;
+				_internal::axpy(r, -omega, t);
+
+				res_norm = norm(r);
+
+				if (res_norm <= tolerance * b_norm)
+					return iter_result<Vector>(x, iter, res_norm);
+
+				if (omega == Type(0.0)) {
+					TH_MATH_ERROR("algebra::solve_bicgstab", omega, MathError::NoConvergence);
+					vec_error(x);
+					return iter_result<Vector>(x, ConvergenceStatus::Stalled, iter, res_norm);
+				}
+			}
+
+			TH_MATH_ERROR("algebra::solve_bicgstab", iter, MathError::NoConvergence);
+			vec_error(x);
+			return iter_result<Vector>(x, ConvergenceStatus::MaxIterations, max_iter, res_norm);
+		}
+
+
+		/// Solve the linear system \f$A \vec x = \vec b\f$ for a general real
+		/// square matrix using the right-preconditioned GMRES method, restarted
+		/// every given number of iterations to limit memory usage, starting from
+		/// the null vector. Only the product of the matrix with vectors is needed,
+		/// so A may be a dense or sparse matrix or a matrix-free linear operator.
+		///
+		/// @param A The matrix or linear operator
+		/// @param b The known vector
+		/// @param M The preconditioner, a function approximating the action
+		/// of the inverse of A (defaults to the identity)
+		/// @param tolerance The tolerance on the residual norm, relative
+		/// to the norm of b (defaults to ALGEBRA_KRYLOV_TOL)
+		/// @param max_iter The maximum total number of iterations
+		/// (defaults to ALGEBRA_KRYLOV_ITER)
+		/// @param restart The number of iterations between restarts,
+		/// equal to the dimension of the Krylov subspace (defaults to ALGEBRA_GMRES_RESTART)
+		/// @return The solution with convergence information
+		template<typename Operator, typename Vector,
+			typename Preconditioner = identity_preconditioner>
+		inline iter_result<Vector> solve_gmres(
+			const Operator& A, const Vector& b,
+			const Preconditioner& M = Preconditioner(),
+			real tolerance = ALGEBRA_KRYLOV_TOL,
+			unsigned int max_iter = ALGEBRA_KRYLOV_ITER,
+			unsigned int restart = ALGEBRA_GMRES_RESTART) {
+
+			using Type = vector_element_t<Vector>;
+
+			Vector x = algebra::clone(b);
+			vec_zeroes(x);
+
+			const real b_norm = norm(b);
+
+			if (b_norm == 0.0)
+				return iter_result<Vector>(x, 0, 0.0);
+
+			if (restart == 0) {
+				TH_MATH_ERROR("algebra::solve_gmres", restart, MathError::InvalidArgument);
+				vec_error(x);
+				return iter_result<Vector>(x, ConvergenceStatus::InvalidInput, 0, inf());
+			}
+
+			const unsigned int m = restart;
+
+			// Orthonormal basis of the Krylov subspace
+			std::vector<Vector> V (m + 1);
+
+			// Hessenberg matrix, stored by columns, and Givens rotations
+			std::vector<Type> H ((m + 1) * m);
+			std::vector<Type> cs (m), sn (m), g (m + 1), y (m);
+
+			real res_norm = b_norm;
+			unsigned int iter = 0;
+
+			while (iter < max_iter) {
+
+				// Compute the residual of the current solution
+				Vector r = algebra::clone(b);
+				_internal::axpy(r, Type(-1.0), _internal::apply_operator(A, M(x)));
+
+				// x holds the preconditioned variable, so the
+				// residual is computed with the actual solution
+				res_norm = norm(r);
+
+				if (res_norm <= tolerance * b_norm)
+					break;
+
+				V[0] = r;
+
+				for (unsigned int i = 0; i < r.size(); ++i)
+					V[0][i] /= res_norm;
+
+				std::fill(g.begin(), g.end(), Type(0.0));
+				g[0] = res_norm;
+
+				unsigned int k = 0;
+
+				// Arnoldi iteration
+				for (unsigned int j = 0; j < m && iter < max_iter; ++j) {
+
+					iter++;
+					k = j + 1;
+
+					Vector w = _internal::apply_operator(A, M(V[j]));
+
+					// Modified Gram-Schmidt orthogonalization
+					for (unsigned int i = 0; i <= j; ++i) {
+						H[i + j * (m + 1)] = dot(w, V[i]);
+						_internal::axpy(w, -H[i + j * (m + 1)], V[i]);
+					}
+
+					const real w_norm = norm(w);
+					H[(j + 1) + j * (m + 1)] = w_norm;
+
+					if (w_norm != 0.0) {
+
+						V[j + 1] = w;
+
+						for (unsigned int i = 0; i < w.size(); ++i)
+							V[j + 1][i] /= w_norm;
+					}
+
+					// Apply the previous rotations to the new column
+					for (unsigned int i = 0; i < j; ++i) {
+
+						const Type h_i = H[i + j * (m + 1)];
+						const Type h_next = H[(i + 1) + j * (m + 1)];
+
+						H[i + j * (m + 1)] = cs[i] * h_i + sn[i] * h_next;
+						H[(i + 1) + j * (m + 1)] = -sn[i] * h_i + cs[i] * h_next;
+					}
+
+					// Compute the rotation which eliminates H(j + 1, j)
+					const Type h_jj = H[j + j * (m + 1)];
+					const Type h_next = H[(j + 1) + j * (m + 1)];
+					const real d = sqrt(h_jj * h_jj + h_next * h_next);
+
+					cs[j] = (d == 0.0) ? Type(1.0) : h_jj / d;
+					sn[j] = (d == 0.0) ? Type(0.0) : h_next / d;
+
+					H[j + j * (m + 1)] = d;
+					H[(j + 1) + j * (m + 1)] = Type(0.0);
+
+					g[j + 1] = -sn[j] * g[j];
+					g[j] = cs[j] * g[j];
+
+					// The residual norm is given by the last element of g
+					res_norm = abs(g[j + 1]);
+
+					if (res_norm <= tolerance * b_norm || w_norm == 0.0)
+						break;
+				}
+
+				// Solve the upper triangular system H y = g
+				for (int i = k - 1; i >= 0; --i) {
+
+					Type sum = g[i];
+
+					for (unsigned int l = i + 1; l < k; ++l)
+						sum -= H[i + l * (m + 1)] * y[l];
+
+					y[i] = sum / H[i + i * (m + 1)];
+				}
+
+				// Update the preconditioned variable
+				for (unsigned int i = 0; i < k; ++i)
+					_internal::axpy(x, y[i], V[i]);
+
+				if (res_norm <= tolerance * b_norm)
+					break;
+			}
+
+			// Recover the solution from the preconditioned variable
+			x = M(x);
+
+			if (res_norm > tolerance * b_norm) {
+				TH_MATH_ERROR("algebra::solve_gmres", iter, MathError::NoConvergence);
+				vec_error(x);
+				return iter_result<Vector>(x, ConvergenceStatus::MaxIterations, iter, res_norm);
+			}
+
+			return iter_result<Vector>(x, iter, res_norm);
+		}
+	}
+}
+
+#endif
@@ -13,10 +13,12 @@
 
 #include <array>
 #include <vector>
+#include <memory>
 
 #include "../core/error.h"
 #include "../core/constants.h"
 #include "../core/real_analysis.h"
+#include "../core/allocator.h"
 #include "./algebra.h"
 #include "./transform.h"
 #include "./vec.h"
@@ -132,7 +134,10 @@ namespace theoretica {
 	/// @param Type The type of the elements
 	/// @param N The number of rows
 	/// @param K The number of columns
-	template<typename Type = real, unsigned int N = 0, unsigned int K = 0>
+	/// @param Allocator The allocator of the storage,
+	/// only used by dynamically allocated matrices
+	template<typename Type = real, unsigned int N = 0, unsigned int K = 0,
+		typename Allocator = std::allocator<Type>>
 	class mat {
 		public:
 
@@ -799,13 +804,15 @@ namespace theoretica {
 	/// A generic matrix with a variable number of rows and columns.
 	///
 	/// @param Type The type of the elements
+	/// @param Allocator The allocator of the storage,
+	/// such as aligned_allocator or arena_allocator
 	///
-	template<typename Type>
-	class mat<Type, 0, 0> {
+	template<typename Type, typename Allocator>
+	class mat<Type, 0, 0, Allocator> {
 		public:
 
 		/// Dynamically allocated array of the elements
-		std::vector<Type> elements;
+		std::vector<Type, Allocator> elements;
 
 		/// Number of rows
 		size_t row_sz {0};
@@ -826,15 +833,37 @@ namespace theoretica {
 			algebra::mat_zeroes(*this);
 		}
 
+
+		/// Constructor that initializes an empty matrix which uses the given allocator.
+		/// @param alloc The allocator of the storage.
+		explicit mat(const Allocator& alloc) : elements(alloc) {}
+
+
+		/// Constructor that initializes a matrix with the specified number
+		/// of rows and columns, which uses the given allocator.
+		/// @param n Number of rows.
+		/// @param k Number of columns.
+		/// @param alloc The allocator of the storage.
+		mat(unsigned int n, unsigned int k, const Allocator& alloc)
+			: elements(uint64_t(n) * k, Type(0), alloc), row_sz(n), col_sz(k) {}
+
 	
 		/// Copy constructor for creating a matrix from another matrix.
 		/// @tparam Matrix A compatible matrix type.
 		/// @param m The matrix to copy from.
-		template <typename Matrix, enable_matrix<Matrix>>
+		template <typename Matrix, enable_matrix<Matrix> = true>
 		mat(const Matrix& m) {
 			algebra::mat_copy(*this, m);
 		}
 
+
+		/// Constructor that evaluates a matrix expression.
+		/// @param expr The expression to evaluate.
+		template<typename Op, typename LHS, typename RHS>
+		mat(const mat_expr<Op, LHS, RHS>& expr) {
+			_internal::expr_eval(*this, expr);
+		}
+
 	
 		/// Constructor that initializes a matrix from a list of rows.
 		/// @tparam T The type of the initializer elements (default is `Type`).
@@ -871,12 +900,21 @@ namespace theoretica {
 		/// @tparam Matrix A compatible matrix type.
    		/// @param other The matrix to copy from.
 		template<typename Matrix>
-		inline mat<Type>& operator=(const Matrix& other) {
+		inline mat& operator=(const Matrix& other) {
 			resize(other.rows(), other.cols());
 			return algebra::mat_copy(*this, other);
 		}
 
 
+		/// Evaluate a matrix expression into the matrix,
+		/// reusing the existing storage when possible.
+		/// @param expr The expression to evaluate.
+		template<typename Op, typename LHS, typename RHS>
+		inline mat& operator=(const mat_expr<Op, LHS, RHS>& expr) {
+			return _internal::expr_eval(*this, expr);
+		}
+
+
 		/// Constructor that initializes a diagonal matrix with equal entries on the diagonal.
 		/// @param diagonal The value for the diagonal entries.
 		/// @param n Number of rows.
@@ -933,9 +971,9 @@ namespace theoretica {
 		/// @tparam Matrix A compatible matrix type.
 		/// @param other The matrix to add.
 		/// @return A new matrix containing the sum of the two matrices.
-		template<typename Matrix>
-		inline mat<Type> operator+(const Matrix& other) const {
-			mat<Type> res;
+		template<typename Matrix, _internal::disable_expr<Matrix> = true>
+		inline mat operator+(const Matrix& other) const {
+			mat res;
 			res.resize(rows(), cols());
 			return algebra::mat_sum(res, *this, other);
 		}
@@ -945,9 +983,9 @@ namespace theoretica {
 		/// @tparam Matrix A compatible matrix type.
 		/// @param other The matrix to subtract.
 		/// @return A new matrix containing the difference of the two matrices.
-		template<typename Matrix>
-		inline mat<Type> operator-(const Matrix& other) const {
-			mat<Type> res;
+		template<typename Matrix, _internal::disable_expr<Matrix> = true>
+		inline mat operator-(const Matrix& other) const {
+			mat res;
 			res.resize(rows(), cols());
 			return algebra::mat_diff(res, *this, other);
 		}
@@ -956,8 +994,8 @@ namespace theoretica {
 		/// Multiplies the matrix by a scalar.
 		/// @param scalar The scalar to multiply with.
 		/// @return A new matrix with each element multiplied by the scalar.
-		inline mat<Type> operator*(Type scalar) const {
-			mat<Type> res;
+		inline mat operator*(Type scalar) const {
+			mat res;
 			res.resize(rows(), cols());
 			return algebra::mat_scalmul(res, scalar, *this);
 		}
@@ -967,7 +1005,7 @@ namespace theoretica {
 		/// (T) * (mat)
 		/// @param a The scalar value.
 		/// @param B The matrix to multiply.		
-		inline friend mat<Type> operator*(Type a, const mat<Type>& B) {
+		inline friend mat operator*(Type a, const mat& B) {
 			return B * a;
 		}
 
@@ -978,9 +1016,9 @@ namespace theoretica {
    		/// @tparam M The vector size.
 		/// @param a The vector.
 		/// @param B The matrix.
-		template<typename VecType, unsigned int M>
-		inline friend vec<VecType, 0> operator*(
-			const vec<VecType, M>& a, const mat<Type, 0, 0>& B) {
+		template<typename VecType, unsigned int M, typename VecAllocator>
+		inline friend vec<VecType, 0, VecAllocator> operator*(
+			const vec<VecType, M, VecAllocator>& a, const mat& B) {
 			return B * a;
 		}
 
@@ -988,9 +1026,9 @@ namespace theoretica {
 		/// Divides each element in the matrix by a scalar.
 		/// @param scalar The scalar to divide with.
 		/// @return A new matrix with each element divided by the scalar.
-		inline mat<Type> operator/(Type scalar) const {
+		inline mat operator/(Type scalar) const {
 
-			mat<Type> res;
+			mat res;
 			res.resize(rows(), cols());
 
 			if(abs(scalar) < MACH_EPSILON) {
@@ -1023,9 +1061,10 @@ namespace theoretica {
 		/// Transforms a vector by multiplying it with the matrix.
    		/// @tparam N The number of elements in the result vector.
 		/// @tparam K The number of elements in the input vector.
+		/// @tparam VecAllocator The allocator of the vectors.
 		/// @param v The vector to transform.
-		template<unsigned int N = 0, unsigned int K = 0>
-		inline vec<Type, N> transform(const vec<Type, K>& v) const {
+		template<unsigned int N = 0, unsigned int K = 0, typename VecAllocator>
+		inline vec<Type, N, VecAllocator> transform(const vec<Type, K, VecAllocator>& v) const {
 			return algebra::transform(*this, v);
 		}
 
@@ -1033,9 +1072,10 @@ namespace theoretica {
 		/// Transforms a vector by multiplying it with the matrix.
 		/// @tparam N The number of elements in the result vector.
 		/// @tparam K The number of elements in the input vector.
+		/// @tparam VecAllocator The allocator of the vectors.
 		/// @param v The vector to transform.
-		template<unsigned int N = 0, unsigned int K = 0>
-		inline vec<Type, N> operator*(const vec<Type, K>& v) const {
+		template<unsigned int N = 0, unsigned int K = 0, typename VecAllocator>
+		inline vec<Type, N, VecAllocator> operator*(const vec<Type, K, VecAllocator>& v) const {
 			return transform(v);
 		}
 
@@ -1057,9 +1097,9 @@ namespace theoretica {
 		///
 		/// If the number of rows in `B` does not match the number of columns in the
 		/// current matrix, an error is raised and an error matrix is returned.
-		inline mat<Type> mul(const mat<Type>& B) const {
+		inline mat mul(const mat& B) const {
 
-			mat<Type> res;
+			mat res;
 			res.resize(rows(), B.cols());
 
 			if(B.rows() != cols()) {
@@ -1105,7 +1145,8 @@ namespace theoretica {
 		///
 		/// This operator overload allows the current matrix to be multiplied by
 		/// another matrix `B`. The result is obtained using the `mul` function.
-		template<typename Matrix>
+		template<typename Matrix, enable_matrix<Matrix> = true,
+			_internal::disable_expr<Matrix> = true>
 		inline auto operator*(const Matrix& B) const {
 			return mul(B);
 		}
@@ -1119,7 +1160,7 @@ namespace theoretica {
 		/// to the corresponding elements of the current matrix, modifying it
 		/// in place.
 		template<typename Matrix>
-		inline mat<Type>& operator+=(const Matrix& other) {
+		inline mat& operator+=(const Matrix& other) {
 			return algebra::mat_sum(*this, other);
 		}
 
@@ -1132,7 +1173,7 @@ namespace theoretica {
 		/// from the corresponding elements of the current matrix, modifying it
 		/// in place
 		template<typename Matrix>
-		inline mat<Type>& operator-=(const Matrix& other) {
+		inline mat& operator-=(const Matrix& other) {
 			return algebra::mat_diff(*this, other);
 		}
 
@@ -1143,7 +1184,7 @@ namespace theoretica {
 		///
 		/// This operator overload multiplies each element of the matrix by a scalar
 		/// value `scalar`, modifying the current matrix in place.
-		inline mat<Type>& operator*=(Type scalar) {
+		inline mat& operator*=(Type scalar) {
 			return algebra::mat_scalmul(scalar, *this);
 		}
 
@@ -1154,7 +1195,7 @@ namespace theoretica {
 		///
 		/// Divides each element of the matrix by `scalar`. If `scalar` is close to zero
 		/// (below the defined MACH_EPSILON), an error is thrown to prevent division by zero.
-		inline mat<Type>& operator/=(Type scalar) {
+		inline mat& operator/=(Type scalar) {
 
 			if(abs(scalar) < MACH_EPSILON) {
 				TH_MATH_ERROR("mat::operator/", scalar, MathError::DivByZero);
@@ -1173,7 +1214,7 @@ namespace theoretica {
 		/// updating its values. The result is obtained by performing matrix
 		/// multiplication and storing the outcome back into the current matrix.
 		template<typename Matrix>
-		inline mat<Type>& operator*=(const Matrix& B) {
+		inline mat& operator*=(const Matrix& B) {
 			return (*this = this->operator*(B));
 		}
 
@@ -1184,7 +1225,7 @@ namespace theoretica {
 		/// Modifies the matrix in place by transposing its elements. This operation
 		/// is only valid for square matrices. For non-square matrices, use `transposed()`
 		/// to obtain a new transposed matrix.
-		inline mat<Type>& transpose() {
+		inline mat& transpose() {
 			return algebra::make_transposed(*this);
 		}
 
@@ -1292,11 +1333,11 @@ namespace theoretica {
 
 
 		/// Iterator for dynamically allocated matrices.
-		using iterator = mat_iterator<mat<Type, 0, 0>, Type&>;
+		using iterator = mat_iterator<mat, Type&>;
 
 
 		/// Const iterator for dynamically allocated matrices.
-		using const_iterator = mat_iterator<const mat<Type, 0, 0>, const Type&>;
+		using const_iterator = mat_iterator<const mat, const Type&>;
 
 
 		/// Get an iterator to the first element of the matrix.
@@ -1373,6 +1414,12 @@ namespace theoretica {
 		}
 
 
+		/// Get the allocator of the storage of the matrix.
+		inline Allocator get_allocator() const {
+			return elements.get_allocator();
+		}
+
+
 		/// Unpack the matrix elements into a vector.
 		///
 		/// @tparam Vector The type of the vector to unpack into (default is vec<Type>).
@@ -1424,7 +1471,7 @@ namespace theoretica {
 		/// @return A reference to the modified matrix itself, now inverted.
 		///
 		/// Modifies the current matrix to become its inverse. This is only defined for square, non-singular matrices.
-		inline mat<Type>& invert() {
+		inline mat& invert() {
 			return algebra::invert(*this);
 		}
 
@@ -1432,13 +1479,14 @@ namespace theoretica {
 		/// Set or change the size of the matrix
 		/// @param rows The number of rows
 		/// @param cols The number of columns
-		inline mat<Type>& resize(unsigned int rows, unsigned int cols) {
+		inline mat& resize(unsigned int rows, unsigned int cols) {
 
 			// Do nothing if the size is already correct
 			if (row_sz == rows && col_sz == cols)
 				return *this;
 
-			std::vector<Type> new_data (uint64_t(rows) * cols);
+			std::vector<Type, Allocator> new_data (
+				uint64_t(rows) * cols, Type(), elements.get_allocator());
 
 			if (elements.size()) {
 
@@ -1449,7 +1497,7 @@ namespace theoretica {
 					new_data[i] = elements[i];
 			}
 
-			elements = new_data;
+			elements = std::move(new_data);
 			row_sz = rows;
 			col_sz = cols;
 
@@ -1497,7 +1545,7 @@ namespace theoretica {
 
 			/// Stream the matrix in string representation to an output stream (std::ostream)
 			inline friend std::ostream& operator<<(
-				std::ostream& out, const mat<Type>& obj) {
+				std::ostream& out, const mat& obj) {
 				return out << obj.to_string();
 			}
 
@@ -0,0 +1,549 @@
+///
+/// @file matrix_function.h Functions of square matrices, such as the matrix
+/// exponential, logarithm and square root, and the action of the matrix
+/// exponential on a vector for big or sparse matrices.
+///
+
+#ifndef THEORETICA_MATRIX_FUNCTION_H
+#define THEORETICA_MATRIX_FUNCTION_H
+
+#include <vector>
+#include "../core/error.h"
+#include "../core/constants.h"
+#include "../core/core_traits.h"
+#include "../core/real_analysis.h"
+#include "../calculus/gauss.h"
+#include "./algebra.h"
+#include "./distance.h"
+#include "./factorization.h"
+#include "./sparse.h"
+#include "./banded.h"
+
+
+namespace theoretica {
+
+	namespace algebra {
+
+
+		namespace _internal {
+
+
+			/// Compute the sum of the absolute values of the
+			/// elements of each column of a matrix.
+			template<typename Matrix>
+			inline std::vector<real> column_abs_sums(const Matrix& A) {
+
+				std::vector<real> sums (A.cols(), 0.0);
+
+				for (unsigned int i = 0; i < A.rows(); ++i)
+					for (unsigned int j = 0; j < A.cols(); ++j)
+						sums[j] += abs(A(i, j));
+
+				return sums;
+			}
+
+
+			/// Compute the sum of the absolute values of the elements
+			/// of each column of a sparse matrix, visiting only its non-zero elements.
+			template<typename Type, SparseFormat Format>
+			inline std::vector<real> column_abs_sums(const sparse_mat<Type, Format>& A) {
+
+				std::vector<real> sums (A.cols(), 0.0);
+				const unsigned int major_sz = (Format == SparseFormat::CSR) ? A.rows() : A.cols();
+
+				for (unsigned int i = 0; i < major_sz; ++i) {
+					for (unsigned int k = A.offsets[i]; k < A.offsets[i + 1]; ++k) {
+
+						const unsigned int j = (Format == SparseFormat::CSR) ? A.indices[k] : i;
+						sums[j] += abs(A.values[k]);
+					}
+				}
+
+				return sums;
+			}
+
+
+			/// Compute the sum of the absolute values of the elements
+			/// of each column of a banded matrix, visiting only the band.
+			template<typename Type>
+			inline std::vector<real> column_abs_sums(const banded_mat<Type>& A) {
+
+				const unsigned int n = A.rows();
+				std::vector<real> sums (n, 0.0);
+
+				for (unsigned int i = 0; i < n; ++i) {
+
+					const unsigned int j_begin = i > A.lower() ? i - A.lower() : 0;
+					const unsigned int j_end = std::min(n, i + A.upper() + 1);
+
+					for (unsigned int j = j_begin; j < j_end; ++j)
+						sums[j] += abs(A.at(i, j));
+				}
+
+				return sums;
+			}
+
+
+			/// Compute the sum of the absolute values of the elements
+			/// of each column of a tridiagonal matrix.
+			template<typename Type>
+			inline std::vector<real> column_abs_sums(const tridiag_mat<Type>& A) {
+
+				std::vector<real> sums (A.rows(), 0.0);
+
+				for (unsigned int j = 0; j < A.rows(); ++j)
+					sums[j] = abs(A.diag[j]);
+
+				for (unsigned int j = 0; j + 1 < A.rows(); ++j) {
+					sums[j] += abs(A.lower[j]);
+					sums[j + 1] += abs(A.upper[j]);
+				}
+
+				return sums;
+			}
+
+
+			/// Compute the 1-norm of a square matrix shifted along the
+			/// diagonal, \f$||A - \mu I||_1\f$, as its maximum column sum.
+			///
+			/// @param A The square matrix
+			/// @param shift The shift of the diagonal
+			/// @return The 1-norm of the shifted matrix
+			template<typename Matrix>
+			inline real mat_norm_1(const Matrix& A, real shift = 0.0) {
+
+				const std::vector<real> sums = column_abs_sums(A);
+				real res = 0.0;
+
+				for (unsigned int j = 0; j < sums.size(); ++j) {
+
+					const real a_jj = A(j, j);
+					res = max(res, sums[j] - abs(a_jj) + abs(a_jj - shift));
+				}
+
+				return res;
+			}
+
+
+			/// Compute the diagonal Padé approximant of degree m of the
+			/// exponential of a square matrix, with m equal to 3, 5, 7, 9 or 13,
+			/// as in Higham's scaling and squaring algorithm (2005).
+			/// The approximant is \f$q_m(A)^{-1} p_m(A)\f$, with \f$p_m(A) = V + U\f$
+			/// and \f$q_m(A) = V - U\f$, where U holds the odd powers of A.
+			///
+			/// @param A The matrix to compute the exponential of
+			/// @param m The degree of the approximant
+			/// @return The approximated exponential of the matrix
+			template<typename Matrix>
+			inline Matrix expm_pade(const Matrix& A, unsigned int m) {
+
+				// Coefficients of the numerator of the Padé approximants
+				static constexpr real b3[] = {120.0, 60.0, 12.0, 1.0};
+				static constexpr real b5[] = {30240.0, 15120.0, 3360.0, 420.0, 30.0, 1.0};
+				static constexpr real b7[] = {
+					17297280.0, 8648640.0, 1995840.0, 277200.0,
+					25200.0, 1512.0, 56.0, 1.0
+				};
+				static constexpr real b9[] = {
+					17643225600.0, 8821612800.0, 2075673600.0, 302702400.0,
+					30270240.0, 2162160.0, 110880.0, 3960.0, 90.0, 1.0
+				};
+				static constexpr real b13[] = {
+					64764752532480000.0, 32382376266240000.0, 7771770303897600.0,
+					1187353796428800.0, 129060195264000.0, 10559470521600.0,
+					670442572800.0, 33522128640.0, 1323241920.0, 40840800.0,
+					960960.0, 16380.0, 182.0, 1.0
+				};
+
+				const unsigned int n = A.rows();
+
+				Matrix I;
+				I.resize(n, n);
+				make_identity(I);
+
+				Matrix W, V;
+				W.resize(n, n);
+				V.resize(n, n);
+
+				const Matrix A2 = mat_mul(A, A);
+
+				if (m == 13) {
+
+					const Matrix A4 = mat_mul(A2, A2);
+					const Matrix A6 = mat_mul(A4, A2);
+					const real* b = b13;
+
+					Matrix W1, W2;
+					W1.resize(n, n);
+					W2.resize(n, n);
+
+					for (unsigned int i = 0; i < n; ++i) {
+						for (unsigned int j = 0; j < n; ++j) {
+							W1(i, j) = b[13] * A6(i, j) + b[11] * A4(i, j) + b[9] * A2(i, j);
+							W2(i, j) = b[12] * A6(i, j) + b[10] * A4(i, j) + b[8] * A2(i, j);
+						}
+					}
+
+					mat_mul(W, A6, W1);
+					mat_mul(V, A6, W2);
+
+					for (unsigned int i = 0; i < n; ++i) {
+						for (unsigned int j = 0; j < n; ++j) {
+
+							W(i, j) += b[7] * A6(i, j) + b[5] * A4(i, j)
+								+ b[3] * A2(i, j) + b[1] * I(i, j);
+
+							V(i, j) += b[6] * A6(i, j) + b[4] * A4(i, j)
+								+ b[2] * A2(i, j) + b[0] * I(i, j);
+						}
+					}
+
+				} else {
+
+					const real* b = (m == 3) ? b3 : (m == 5) ? b5 : (m == 7) ? b7 : b9;
+
+					// Even powers of the matrix, up to A^(m - 1)
+					std::vector<Matrix> P;
+					P.push_back(I);
+					P.push_back(A2);
+
+					while (2 * P.size() <= m)
+						P.push_back(mat_mul(P.back(), A2));
+
+					mat_zeroes(W);
+					mat_zeroes(V);
+
+					for (unsigned int k = 0; k < P.size(); ++k) {
+						for (unsigned int i = 0; i < n; ++i) {
+							for (unsigned int j = 0; j < n; ++j) {
+								W(i, j) += b[2 * k + 1] * P[k](i, j);
+								V(i, j) += b[2 * k] * P[k](i, j);
+							}
+						}
+					}
+				}
+
+				// Odd part of the approximant
+				const Matrix U = mat_mul(A, W);
+
+				Matrix Q = algebra::clone(V);
+				mat_diff(Q, U);
+				mat_sum(V, U);
+
+				// Solve q_m(A) X = p_m(A)
+				return lu_factor<Matrix>(Q).solve_many(V);
+			}
+		}
+
+
+		/// Compute the exponential of a square matrix, \f$e^A\f$, using
+		/// scaling and squaring with diagonal Padé approximants (Higham, 2005).
+		/// The degree of the approximant is chosen from the 1-norm of the
+		/// matrix, so that small matrices only need a few matrix products,
+		/// while bigger matrices are scaled by a power of two \f$2^s\f$ and
+		/// the result is squared s times. The solution of the linear system
+		/// of ODEs \f$x' = A x\f$ is then \f$x(t) = e^{t A} x(0)\f$.
+		///
+		/// @param A The square matrix
+		/// @return The exponential of the matrix
+		template<typename Matrix>
+		inline Matrix expm(const Matrix& A) {
+
+			Matrix E;
+			E.resize(A.rows(), A.cols());
+
+			if (!is_square(A)) {
+				TH_MATH_ERROR("algebra::expm", A.rows(), MathError::InvalidArgument);
+				return mat_error(E);
+			}
+
+			const real norm = _internal::mat_norm_1(A);
+
+			if (is_nan(norm) || norm == inf()) {
+				TH_MATH_ERROR("algebra::expm", norm, MathError::InvalidArgument);
+				return mat_error(E);
+			}
+
+			// Maximum norm for which each approximant
+			// is accurate to machine precision
+			constexpr unsigned int degrees[] = {3, 5, 7, 9};
+			constexpr real theta[] = {
+				1.495585217958292e-2, 2.539398330063230e-1,
+				9.504178996162932e-1, 2.097847961257068e0
+			};
+			constexpr real theta_13 = 5.371920351148152e0;
+
+			for (unsigned int k = 0; k < 4; ++k)
+				if (norm <= theta[k])
+					return _internal::expm_pade(A, degrees[k]);
+
+			// Scale the matrix so that its norm is below theta_13
+			unsigned int s = 0;
+			real scale = 1.0;
+
+			while (norm * scale > theta_13) {
+				scale *= 0.5;
+				s++;
+			}
+
+			Matrix A_s = algebra::clone(A);
+			mat_scalmul(scale, A_s);
+			E = _internal::expm_pade(A_s, 13);
+
+			// Undo the scaling by repeated squaring
+			for (unsigned int i = 0; i < s; ++i)
+				E = mat_mul(E, E);
+
+			return E;
+		}
+
+
+		/// Compute the principal square root of a square matrix with
+		/// no eigenvalues on the closed negative real axis, using the product
+		/// form of the Denman-Beavers iteration with determinant scaling,
+		/// which needs one matrix inversion per iteration and converges
+		/// quadratically.
+		///
+		/// @param A The square matrix
+		/// @param tolerance The tolerance on the 1-norm of the
+		/// difference between the auxiliary matrix and the identity
+		/// @param max_iter The maximum number of iterations
+		/// @return The principal square root of the matrix
+		template<typename Matrix>
+		inline Matrix sqrtm(
+			const Matrix& A,
+			real tolerance = ALGEBRA_ELEMENT_TOL,
+			unsigned int max_iter = ALGEBRA_SQRTM_ITER) {
+
+			Matrix Y = algebra::clone(A);
+
+			if (!is_square(A)) {
+				TH_MATH_ERROR("algebra::sqrtm", A.rows(), MathError::InvalidArgument);
+				return mat_error(Y);
+			}
+
+			const unsigned int n = A.rows();
+			Matrix M = algebra::clone(A);
+
+			for (unsigned int iter = 0; iter < max_iter; ++iter) {
+
+				const lu_factor<Matrix> F (M);
+
+				// Scale by the determinant while far from convergence,
+				// computing its logarithm to avoid overflow
+				real log_det = 0.0;
+
+				for (unsigned int i = 0; i < n; ++i)
+					log_det += ln(abs(F.LU(i, i)));
+
+				if (is_nan(log_det) || abs(log_det) == inf()) {
+					TH_MATH_ERROR("algebra::sqrtm", log_det, MathError::DivByZero);
+					return mat_error(Y);
+				}
+
+				real mu = 1.0;
+
+				if (_internal::mat_norm_1(M, 1.0) > 0.01)
+					mu = exp(-log_det / (2.0 * n));
+
+				const Matrix M_inv = F.inverse();
+				const real mu2 = mu * mu;
+
+				// N = (I + M^-1 / mu^2) / 2
+				Matrix N = algebra::clone(M_inv);
+				mat_scalmul(0.5 / mu2, N);
+
+				for (unsigned int i = 0; i < n; ++i)
+					N(i, i) += 0.5;
+
+				Y = mat_mul(Y, N);
+				mat_scalmul(mu, Y);
+
+				// M = (I + (mu^2 M + M^-1 / mu^2) / 2) / 2
+				mat_lincomb(0.25 * mu2, M, 0.25 / mu2, M_inv);
+
+				for (unsigned int i = 0; i < n; ++i)
+					M(i, i) += 0.5;
+
+				if (_internal::mat_norm_1(M, 1.0) <= tolerance)
+					return Y;
+			}
+
+			TH_MATH_ERROR("algebra::sqrtm", max_iter, MathError::NoConvergence);
+			return mat_error(Y);
+		}
+
+
+		/// Compute the principal logarithm of a square matrix with
+		/// no eigenvalues on the closed negative real axis, using inverse
+		/// scaling and squaring. Square roots of the matrix are taken
+		/// until it is close to the identity, \f$||A^{1/2^k} - I||_1 \leq 1/4\f$,
+		/// then \f$\log(I + X) = \int_0^1 X (I + t X)^{-1} dt\f$ is computed
+		/// with 8-point Gauss-Legendre quadrature, which is equivalent to the
+		/// diagonal Padé approximant of degree 8, and the result is
+		/// multiplied by \f$2^k\f$.
+		///
+		/// @param A The square matrix
+		/// @return The principal logarithm of the matrix
+		template<typename Matrix>
+		inline Matrix logm(const Matrix& A) {
+
+			Matrix L;
+			L.resize(A.rows(), A.cols());
+
+			if (!is_square(A)) {
+				TH_MATH_ERROR("algebra::logm", A.rows(), MathError::InvalidArgument);
+				return mat_error(L);
+			}
+
+			const unsigned int n = A.rows();
+			Matrix X = algebra::clone(A);
+			real scale = 1.0;
+
+			while (_internal::mat_norm_1(X, 1.0) > 0.25) {
+
+				X = sqrtm(X);
+				scale *= 2.0;
+
+				if (is_nan(X(0, 0)) || scale > 1E+20) {
+					TH_MATH_ERROR("algebra::logm", scale, MathError::NoConvergence);
+					return mat_error(L);
+				}
+			}
+
+			// X = A^(1/2^k) - I
+			for (unsigned int i = 0; i < n; ++i)
+				X(i, i) -= 1.0;
+
+			mat_zeroes(L);
+
+			for (unsigned int k = 0; k < 8; ++k) {
+
+				// Map the nodes and weights from [-1, 1] to [0, 1]
+				const real t = (tables::legendre_roots_8[k] + 1.0) * 0.5;
+				const real w = tables::legendre_weights_8[k] * 0.5;
+
+				// (I + t X)^-1 X commutes with X
+				Matrix Q = algebra::clone(X);
+				mat_scalmul(t, Q);
+
+				for (unsigned int i = 0; i < n; ++i)
+					Q(i, i) += 1.0;
+
+				mat_lincomb(1.0, L, w, lu_factor<Matrix>(Q).solve_many(X));
+			}
+
+			return mat_scalmul(scale, L);
+		}
+
+
+		/// Compute the action of the exponential of a matrix on a vector,
+		/// \f$e^{t A} \vec v\f$, without computing the exponential itself, using
+		/// the truncated Taylor series algorithm of Al-Mohy and Higham (2011).
+		/// The series is evaluated in s steps of degree m, with the cost of
+		/// \f$m s\f$ matrix-vector products, chosen from the 1-norm of the
+		/// matrix shifted by its mean eigenvalue. Only the product A * v
+		/// and element access on the diagonal are needed, so that the
+		/// function may be used with big sparse or banded matrices.
+		///
+		/// @param A The square matrix
+		/// @param v The vector to apply the exponential to
+		/// @param t The scalar factor of the matrix in the exponential
+		/// @return The vector \f$e^{t A} \vec v\f$
+		template<typename Matrix, typename Vector>
+		inline Vector expm_multiply(const Matrix& A, const Vector& v, real t = 1.0) {
+
+			Vector F = algebra::clone(v);
+
+			if (!is_square(A)) {
+				TH_MATH_ERROR("algebra::expm_multiply", A.rows(), MathError::InvalidArgument);
+				return vec_error(F);
+			}
+
+			if (v.size() != A.rows()) {
+				TH_MATH_ERROR("algebra::expm_multiply", v.size(), MathError::InvalidArgument);
+				return vec_error(F);
+			}
+
+			const unsigned int n = A.rows();
+
+			if (n == 0)
+				return F;
+
+			// Shift the matrix by the mean of its eigenvalues
+			const real mu = trace(A) / n;
+			const real norm = abs(t) * _internal::mat_norm_1(A, mu);
+
+			if (is_nan(norm) || norm == inf()) {
+				TH_MATH_ERROR("algebra::expm_multiply", norm, MathError::InvalidArgument);
+				return vec_error(F);
+			}
+
+			// Maximum norm for which the Taylor series of degree
+			// 5, 10, ..., 55 is accurate to machine precision
+			constexpr real theta[] = {
+				2.40e-3, 1.44e-1, 6.41e-1, 1.44, 2.43, 3.54,
+				4.7, 6.0, 7.2, 8.5, 9.9
+			};
+
+			// Choose the degree and number of steps with minimum cost
+			unsigned int m = 0;
+			unsigned int s = 1;
+
+			if (norm > 0.0) {
+
+				unsigned int cost = 0;
+
+				for (unsigned int k = 0; k < 11; ++k) {
+
+					unsigned int steps = floor(norm / theta[k]);
+
+					if (steps == 0 || steps * theta[k] < norm)
+						steps++;
+
+					if (m == 0 || 5 * (k + 1) * steps < cost) {
+						m = 5 * (k + 1);
+						s = steps;
+						cost = m * s;
+					}
+				}
+			}
+
+			const real eta = exp(t * mu / s);
+			Vector b = algebra::clone(v);
+
+			for (unsigned int i = 0; i < s; ++i) {
+
+				real c1 = linf_norm(b);
+
+				for (unsigned int j = 1; j <= m; ++j) {
+
+					Vector Ab = A * b;
+					const real coeff = t / (s * j);
+
+					for (unsigned int l = 0; l < n; ++l) {
+						b[l] = (Ab[l] - mu * b[l]) * coeff;
+						F[l] += b[l];
+					}
+
+					const real c2 = linf_norm(b);
+
+					// Stop the series early when its terms are negligible
+					if (c1 + c2 <= MACH_EPSILON * linf_norm(F))
+						break;
+
+					c1 = c2;
+				}
+
+				for (unsigned int l = 0; l < n; ++l)
+					F[l] *= eta;
+
+				b = F;
+			}
+
+			return F;
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,582 @@
+///
+/// @file packed.h Symmetric and triangular matrices in packed storage,
+/// which only store the \f$n (n + 1) / 2\f$ elements of one triangle,
+/// with Cholesky decomposition, triangular solvers, matrix-vector
+/// products and rank-k updates operating directly on the packed elements.
+///
+
+#ifndef THEORETICA_PACKED_H
+#define THEORETICA_PACKED_H
+
+#include <vector>
+#include <algorithm>
+#include "../core/error.h"
+#include "../core/constants.h"
+#include "../core/core_traits.h"
+#include "../core/real_analysis.h"
+#include "../complex/complex_analysis.h"
+#include "./algebra.h"
+#include "./vec.h"
+
+
+namespace theoretica {
+
+
+	/// @enum PackedFormat
+	/// Storage formats for packed matrices
+	enum class PackedFormat {
+
+		/// Symmetric matrix, storing the lower triangle by rows
+		Symmetric,
+
+		/// Lower triangular matrix, storing the lower triangle by rows
+		Lower,
+
+		/// Upper triangular matrix, storing the upper triangle by rows
+		Upper
+	};
+
+
+	/// @class packed_mat
+	/// A square symmetric or triangular matrix in packed storage,
+	/// which only stores the elements of one triangle by rows,
+	/// halving the memory needed by a dense matrix.
+	///
+	/// For the Symmetric and Lower formats, the element at row i
+	/// and column \f$j \leq i\f$ is stored at position \f$i (i + 1) / 2 + j\f$,
+	/// so that the rows of the lower triangle are contiguous. For the
+	/// Upper format, the element at row i and column \f$j \geq i\f$ is stored
+	/// at position \f$i n - i (i - 1) / 2 + j - i\f$.
+	///
+	/// Elements are read-only through operator() for triangular formats,
+	/// which makes packed matrices usable as input to generic routines of
+	/// the algebra namespace, while symmetric matrices may also be written
+	/// through operator(), so that they can be filled by generic routines.
+	///
+	/// @tparam Type The type of the elements
+	/// @tparam Format The storage format
+	template<typename Type = real, PackedFormat Format = PackedFormat::Symmetric>
+	class packed_mat {
+		public:
+
+			/// The elements of the stored triangle, by rows
+			std::vector<Type> data;
+
+
+		private:
+
+			/// Number of rows and columns
+			unsigned int n {0};
+
+
+		public:
+
+			/// Default constructor, creates an empty matrix
+			packed_mat() = default;
+
+
+			/// Construct a zero matrix of the given size.
+			///
+			/// @param n The number of rows and columns
+			packed_mat(unsigned int n) {
+				resize(n);
+			}
+
+
+			/// Construct a packed matrix from the elements of
+			/// the stored triangle of a square matrix, ignoring all
+			/// other elements. For the Symmetric format, the lower
+			/// triangle is used.
+			///
+			/// @param A The matrix to convert
+			template<typename Matrix, enable_matrix<Matrix> = true>
+			packed_mat(const Matrix& A) {
+
+				resize(A.rows());
+
+				if (!algebra::is_square(A)) {
+					TH_MATH_ERROR("packed_mat::packed_mat", A.cols(), MathError::InvalidArgument);
+					std::fill(data.begin(), data.end(), make_error<Type>());
+					return;
+				}
+
+				for (unsigned int i = 0; i < n; ++i) {
+
+					const unsigned int j_begin = (Format == PackedFormat::Upper) ? i : 0;
+					const unsigned int j_end = (Format == PackedFormat::Upper) ? n : i + 1;
+
+					for (unsigned int j = j_begin; j < j_end; ++j)
+						at(i, j) = A(i, j);
+				}
+			}
+
+
+			/// Resize the matrix, setting all elements to zero.
+			///
+			/// @param n The number of rows and columns
+			inline void resize(unsigned int n) {
+
+				this->n = n;
+				data.assign(size_t(n) * (n + 1) / 2, Type(0.0));
+			}
+
+
+			/// Resize the matrix, setting all elements to zero.
+			/// Packed matrices are square, so an error is raised
+			/// if the number of rows and columns differ.
+			///
+			/// @param rows The number of rows
+			/// @param cols The number of columns
+			inline void resize(unsigned int rows, unsigned int cols) {
+
+				resize(rows);
+
+				if (rows != cols) {
+					TH_MATH_ERROR("packed_mat::resize", cols, MathError::InvalidArgument);
+					std::fill(data.begin(), data.end(), make_error<Type>());
+				}
+			}
+
+
+			/// Get the position in data of the element at the given
+			/// row and column, which must be inside the stored triangle
+			/// (no check on the indices is performed).
+			///
+			/// @param i The row index
+			/// @param j The column index
+			/// @return The position of the element in data
+			inline size_t index(unsigned int i, unsigned int j) const {
+
+				if (Format == PackedFormat::Upper)
+					return size_t(i) * n - size_t(i) * (i - 1) / 2 + j - i;
+
+				return size_t(i) * (i + 1) / 2 + j;
+			}
+
+
+			/// Get a reference to a stored element. For symmetric
+			/// matrices, any row and column may be given, while for
+			/// triangular matrices the element must be inside the
+			/// stored triangle (no check on the indices is performed).
+			///
+			/// @param i The row index
+			/// @param j The column index
+			/// @return A reference to the element
+			inline Type& at(unsigned int i, unsigned int j) {
+
+				if (Format == PackedFormat::Symmetric && j > i)
+					std::swap(i, j);
+
+				return data[index(i, j)];
+			}
+
+
+			/// Get a stored element. For symmetric matrices, any row
+			/// and column may be given, while for triangular matrices
+			/// the element must be inside the stored triangle
+			/// (no check on the indices is performed).
+			///
+			/// @param i The row index
+			/// @param j The column index
+			/// @return The value of the element
+			inline const Type& at(unsigned int i, unsigned int j) const {
+
+				if (Format == PackedFormat::Symmetric && j > i)
+					std::swap(i, j);
+
+				return data[index(i, j)];
+			}
+
+
+			/// Get the element at the given row and column,
+			/// or zero if it lies outside of the stored triangle
+			/// of a triangular matrix.
+			///
+			/// @param i The row index
+			/// @param j The column index
+			/// @return The value of the element
+			inline Type operator()(unsigned int i, unsigned int j) const {
+
+				if ((Format == PackedFormat::Lower && j > i) ||
+					(Format == PackedFormat::Upper && j < i))
+					return Type(0.0);
+
+				return at(i, j);
+			}
+
+
+			/// Get a reference to the element at the given row and
+			/// column of a symmetric matrix, where the elements at
+			/// (i, j) and (j, i) share the same storage.
+			///
+			/// @param i The row index
+			/// @param j The column index
+			/// @return A reference to the element
+			template<PackedFormat F = Format, std::enable_if_t<F == PackedFormat::Symmetric, int> = 0>
+			inline Type& operator()(unsigned int i, unsigned int j) {
+				return at(i, j);
+			}
+
+
+			/// Get the number of rows of the matrix
+			inline unsigned int rows() const {
+				return n;
+			}
+
+
+			/// Get the number of columns of the matrix
+			inline unsigned int cols() const {
+				return n;
+			}
+
+
+			/// Apply the matrix to a vector, visiting each stored
+			/// element once, so that symmetric matrices use each
+			/// element of the lower triangle for both of its positions.
+			///
+			/// @param v The vector to transform
+			/// @return The transformed vector
+			template<typename Vector>
+			inline Vector transform(const Vector& v) const {
+
+				Vector res;
+				res.resize(n);
+
+				if (v.size() != n) {
+					TH_MATH_ERROR("packed_mat::transform", v.size(), MathError::InvalidArgument);
+					return algebra::vec_error(res);
+				}
+
+				algebra::vec_zeroes(res);
+
+				for (unsigned int i = 0; i < n; ++i) {
+
+					const Type* row = &data[index(i, Format == PackedFormat::Upper ? i : 0)];
+
+					if (Format == PackedFormat::Upper) {
+
+						Type sum = Type(0.0);
+
+						for (unsigned int j = i; j < n; ++j)
+							sum += row[j - i] * v[j];
+
+						res[i] = sum;
+
+					} else {
+
+						Type sum = Type(0.0);
+
+						for (unsigned int j = 0; j < i; ++j) {
+
+							sum += row[j] * v[j];
+
+							// Scatter the symmetric element to row j
+							if (Format == PackedFormat::Symmetric)
+								res[j] += row[j] * v[i];
+						}
+
+						res[i] += sum + row[i] * v[i];
+					}
+				}
+
+				return res;
+			}
+
+
+			/// Apply the matrix to a vector, visiting each stored element once.
+			///
+			/// @param v The vector to transform
+			/// @return The transformed vector
+			template<typename Vector, enable_vector<Vector> = true>
+			inline Vector operator*(const Vector& v) const {
+				return transform(v);
+			}
+	};
+
+
+	namespace algebra {
+
+
+		/// Returns the matrix transformation of a vector by a packed
+		/// matrix, visiting each stored element once.
+		/// Equivalent to the operation A * v
+		///
+		/// @param A The packed matrix transformation
+		/// @param v The vector to transform
+		/// @return The transformed vector
+		template<typename Type, PackedFormat Format, typename Vector>
+		inline Vector transform(const packed_mat<Type, Format>& A, const Vector& v) {
+			return A.transform(v);
+		}
+
+
+		/// Decompose a symmetric positive definite matrix in packed storage
+		/// in-place, so that \f$A = L L^T\f$, where the lower triangle of
+		/// the matrix is stored by rows in a lower triangular packed matrix.
+		/// The elements of each row are contiguous, so that the
+		/// inner products of the Cholesky-Banachiewicz algorithm
+		/// are computed over contiguous memory.
+		///
+		/// @param A The lower triangle of the symmetric matrix to decompose,
+		/// overwritten with the lower triangular factor
+		/// @return A reference to the overwritten matrix
+		template<typename Type>
+		inline packed_mat<Type, PackedFormat::Lower>& decompose_cholesky_inplace(
+			packed_mat<Type, PackedFormat::Lower>& A) {
+
+			const unsigned int n = A.rows();
+
+			for (unsigned int i = 0; i < n; ++i) {
+
+				Type* L_i = &A.data[A.index(i, 0)];
+
+				for (unsigned int j = 0; j <= i; ++j) {
+
+					const Type* L_j = &A.data[A.index(j, 0)];
+					Type sum = L_i[j];
+
+					for (unsigned int k = 0; k < j; ++k)
+						sum -= pair_inner_product(L_i[k], L_j[k]);
+
+					if (i != j) {
+						L_i[j] = sum / L_j[j];
+						continue;
+					}
+
+					// Check that the matrix is positive definite, which may
+					// fail because of rounding for ill-conditioned matrices
+					if (!(sum > Type(0.0))) {
+						TH_MATH_ERROR("algebra::decompose_cholesky_inplace", sum, MathError::InvalidArgument);
+						std::fill(A.data.begin(), A.data.end(), make_error<Type>());
+						return A;
+					}
+
+					L_i[i] = Type(sqrt(sum));
+				}
+			}
+
+			return A;
+		}
+
+
+		/// Decompose a symmetric positive definite matrix in packed
+		/// storage into a lower triangular matrix in packed storage,
+		/// so that \f$A = L L^T\f$, using Cholesky decomposition.
+		///
+		/// @param A The symmetric matrix to decompose
+		/// @return The lower triangular factor
+		template<typename Type>
+		inline packed_mat<Type, PackedFormat::Lower> decompose_cholesky(
+			const packed_mat<Type, PackedFormat::Symmetric>& A) {
+
+			packed_mat<Type, PackedFormat::Lower> L (A.rows());
+			L.data = A.data;
+
+			return decompose_cholesky_inplace(L);
+		}
+
+
+		/// Solve the linear system \f$L \vec x = \vec b\f$ for a lower
+		/// triangular matrix in packed storage, visiting its rows contiguously.
+		///
+		/// @param L The lower triangular packed matrix
+		/// @param b The known vector
+		/// @return The unknown vector
+		template<typename Type, typename Vector>
+		inline Vector solve_triangular_lower(
+			const packed_mat<Type, PackedFormat::Lower>& L, const Vector& b) {
+
+			Vector x = algebra::clone(b);
+
+			if (b.size() != L.rows()) {
+				TH_MATH_ERROR("algebra::solve_triangular_lower", b.size(), MathError::InvalidArgument);
+				return vec_error(x);
+			}
+
+			for (unsigned int i = 0; i < L.rows(); ++i) {
+
+				const Type* L_i = &L.data[L.index(i, 0)];
+
+				if (abs(L_i[i]) < MACH_EPSILON) {
+					TH_MATH_ERROR("algebra::solve_triangular_lower", L_i[i], MathError::DivByZero);
+					return vec_error(x);
+				}
+
+				auto sum = x[i];
+
+				for (unsigned int j = 0; j < i; ++j)
+					sum -= L_i[j] * x[j];
+
+				x[i] = sum / L_i[i];
+			}
+
+			return x;
+		}
+
+
+		/// Solve the linear system \f$U \vec x = \vec b\f$ for an upper
+		/// triangular matrix in packed storage, visiting its rows contiguously.
+		///
+		/// @param U The upper triangular packed matrix
+		/// @param b The known vector
+		/// @return The unknown vector
+		template<typename Type, typename Vector>
+		inline Vector solve_triangular_upper(
+			const packed_mat<Type, PackedFormat::Upper>& U, const Vector& b) {
+
+			Vector x = algebra::clone(b);
+			const unsigned int n = U.rows();
+
+			if (b.size() != n) {
+				TH_MATH_ERROR("algebra::solve_triangular_upper", b.size(), MathError::InvalidArgument);
+				return vec_error(x);
+			}
+
+			for (unsigned int i = n; i > 0; --i) {
+
+				const unsigned int r = i - 1;
+				const Type* U_r = &U.data[U.index(r, r)];
+
+				if (abs(U_r[0]) < MACH_EPSILON) {
+					TH_MATH_ERROR("algebra::solve_triangular_upper", U_r[0], MathError::DivByZero);
+					return vec_error(x);
+				}
+
+				auto sum = x[r];
+
+				for (unsigned int j = r + 1; j < n; ++j)
+					sum -= U_r[j - r] * x[j];
+
+				x[r] = sum / U_r[0];
+			}
+
+			return x;
+		}
+
+
+		/// Solve the linear system \f$A \vec x = \vec b\f$ given the
+		/// Cholesky decomposition \f$A = L L^T\f$ in packed storage,
+		/// by solving the two triangular systems \f$L \vec y = \vec b\f$
+		/// and \f$L^T \vec x = \vec y\f$. The second system is solved by
+		/// columns of \f$L^T\f$, so that only rows of L are visited.
+		///
+		/// @param L The lower triangular packed matrix of the decomposition
+		/// @param b The known vector
+		/// @return The unknown vector
+		template<typename Type, typename Vector>
+		inline Vector solve_cholesky(
+			const packed_mat<Type, PackedFormat::Lower>& L, const Vector& b) {
+
+			Vector x = algebra::clone(b);
+
+			if (b.size() != L.rows()) {
+				TH_MATH_ERROR("algebra::solve_cholesky", b.size(), MathError::InvalidArgument);
+				return vec_error(x);
+			}
+
+			// Forward elimination for L
+			for (unsigned int i = 0; i < L.rows(); ++i) {
+
+				const Type* L_i = &L.data[L.index(i, 0)];
+				Type sum = Type(0.0);
+
+				for (unsigned int j = 0; j < i; ++j)
+					sum += L_i[j] * x[j];
+
+				x[i] = (x[i] - sum) / L_i[i];
+			}
+
+			// Backward elimination for L transpose,
+			// scattering each solved element over the rows above
+			for (unsigned int i = L.rows(); i > 0; --i) {
+
+				const unsigned int r = i - 1;
+				const Type* L_r = &L.data[L.index(r, 0)];
+
+				x[r] /= L_r[r];
+
+				for (unsigned int j = 0; j < r; ++j)
+					x[j] -= L_r[j] * x[r];
+			}
+
+			return x;
+		}
+
+
+		/// Update a symmetric matrix in packed storage with the
+		/// outer product of a vector, so that
+		/// \f$A \leftarrow A + \alpha \vec v \vec v^T\f$.
+		///
+		/// @param A The symmetric packed matrix to update
+		/// @param v The vector of the update
+		/// @param alpha The scalar factor of the update
+		/// @return A reference to the updated matrix
+		template<typename Type, typename Vector, enable_vector<Vector> = true>
+		inline packed_mat<Type, PackedFormat::Symmetric>& rank_update(
+			packed_mat<Type, PackedFormat::Symmetric>& A, const Vector& v, Type alpha = Type(1.0)) {
+
+			if (v.size() != A.rows()) {
+				TH_MATH_ERROR("algebra::rank_update", v.size(), MathError::InvalidArgument);
+				std::fill(A.data.begin(), A.data.end(), make_error<Type>());
+				return A;
+			}
+
+			for (unsigned int i = 0; i < A.rows(); ++i) {
+
+				Type* A_i = &A.data[A.index(i, 0)];
+				const Type alpha_v = alpha * v[i];
+
+				for (unsigned int j = 0; j <= i; ++j)
+					A_i[j] += pair_inner_product(alpha_v, v[j]);
+			}
+
+			return A;
+		}
+
+
+		/// Update a symmetric matrix in packed storage with the
+		/// product of a matrix and its transpose, so that
+		/// \f$A \leftarrow A + \alpha B B^T\f$, as in BLAS's syrk.
+		/// The rows of the result are updated in parallel
+		/// from ALGEBRA_PACKED_PARALLEL_MIN rows.
+		///
+		/// @param A The symmetric packed matrix to update
+		/// @param B The matrix of the update, with as many rows as A
+		/// and k columns, one for each rank-one term
+		/// @param alpha The scalar factor of the update
+		/// @return A reference to the updated matrix
+		template<typename Type, typename Matrix, enable_matrix<Matrix> = true>
+		inline packed_mat<Type, PackedFormat::Symmetric>& rank_update(
+			packed_mat<Type, PackedFormat::Symmetric>& A, const Matrix& B, Type alpha = Type(1.0)) {
+
+			if (B.rows() != A.rows()) {
+				TH_MATH_ERROR("algebra::rank_update", B.rows(), MathError::InvalidArgument);
+				std::fill(A.data.begin(), A.data.end(), make_error<Type>());
+				return A;
+			}
+
+			const unsigned int n = A.rows();
+			const unsigned int k = B.cols();
+
+			#pragma omp parallel for schedule(dynamic) if(n >= ALGEBRA_PACKED_PARALLEL_MIN)
+			for (unsigned int i = 0; i < n; ++i) {
+
+				Type* A_i = &A.data[A.index(i, 0)];
+
+				for (unsigned int j = 0; j <= i; ++j) {
+
+					Type sum = Type(0.0);
+
+					for (unsigned int l = 0; l < k; ++l)
+						sum += pair_inner_product(B(i, l), B(j, l));
+
+					A_i[j] += alpha * sum;
+				}
+			}
+
+			return A;
+		}
+	}
+}
+
+#endif
@@ -1,12 +1,14 @@
 
 ///
-/// @file parallel.h Parallelized methods to evaluate a function over a vector element-wise.
+/// @file parallel.h Parallelized methods to evaluate a function over a vector element-wise
+/// and parallelized dense linear algebra routines.
 ///
 
 #ifndef THEORETICA_PARALLEL_H
 #define THEORETICA_PARALLEL_H
 
 #include "./vec.h"
+#include "./algebra.h"
 #include "../core/dataset.h"
 #include "../core/real_analysis.h"
 #include "../complex/complex_analysis.h"
@@ -18,7 +20,8 @@
 namespace theoretica {
 
 
-	/// @namespace theoretica::parallel Parallelized element-wise evaluation of functions.
+	/// @namespace theoretica::parallel Parallelized element-wise evaluation of functions
+	/// and dense linear algebra routines.
 	namespace parallel {
 
 
@@ -52,7 +55,7 @@ namespace theoretica {
 		/// @param f The function to evaluate
 		/// @param v The vector of inputs
 		/// @return A reference to the input vector which has been modified
-		template<typename Function, typename Vector>
+		template<typename Function, typename Vector, disable_matrix<Function> = true>
 		inline Vector& transform(Function f, Vector& v) {
 
 			#pragma omp parallel for
@@ -459,6 +462,615 @@ namespace theoretica {
 
 			return res;
 		}
+
+		// Linear algebra
+
+
+		namespace _internal {
+
+
+			/// Accumulate the product of two matrices into C,
+			/// equivalent to \f$C = C + A B\f$, distributing the tiles
+			/// of the blocked kernel of algebra::mat_mul over multiple threads.
+			/// The operands are packed once per block and shared between threads,
+			/// while each thread updates a disjoint set of tiles of C.
+			///
+			/// @param C The matrix to accumulate the result into
+			/// @param A A function returning the element of the left operand at (i, k)
+			/// @param B A function returning the element of the right operand at (k, j)
+			/// @param m The number of rows of the result
+			/// @param n The number of columns of the result
+			/// @param k The inner size of the product
+			template<typename Matrix, typename AccessA, typename AccessB>
+			inline Matrix& gemm(
+				Matrix& C, AccessA A, AccessB B,
+				unsigned int m, unsigned int n, unsigned int k) {
+
+				using namespace algebra::_internal;
+
+				// Split small products by rows
+				if (uint64_t(m) * n * k < ALGEBRA_GEMM_THRESHOLD) {
+
+					#pragma omp parallel for
+					for (unsigned int i = 0; i < m; ++i)
+						for (unsigned int j = 0; j < n; ++j)
+							for (unsigned int l = 0; l < k; ++l)
+								C(i, j) += A(i, l) * B(l, j);
+
+					return C;
+				}
+
+				using TypeA = std::decay_t<decltype(A(0, 0))>;
+				using TypeB = std::decay_t<decltype(B(0, 0))>;
+
+				const unsigned int kc_max = min(ALGEBRA_GEMM_KC, k);
+				const unsigned int nc_max = min(ALGEBRA_GEMM_NC, n);
+				const unsigned int mc_blocks = (m + ALGEBRA_GEMM_MC - 1) / ALGEBRA_GEMM_MC;
+				const unsigned int a_panels = (m + GEMM_MR - 1) / GEMM_MR;
+
+				// The whole column block of A is packed and shared
+				std::vector<TypeA> a_pack (a_panels * GEMM_MR * kc_max);
+				std::vector<TypeB> b_pack (
+					((nc_max + GEMM_NR - 1) / GEMM_NR) * GEMM_NR * kc_max);
+
+				for (unsigned int jc = 0; jc < n; jc += ALGEBRA_GEMM_NC) {
+
+					const unsigned int nc = min(ALGEBRA_GEMM_NC, n - jc);
+					const unsigned int b_panels = (nc + GEMM_NR - 1) / GEMM_NR;
+
+					for (unsigned int pc = 0; pc < k; pc += ALGEBRA_GEMM_KC) {
+
+						const unsigned int kc = min(ALGEBRA_GEMM_KC, k - pc);
+
+						#pragma omp parallel for
+						for (unsigned int q = 0; q < b_panels; ++q) {
+							const unsigned int j = q * GEMM_NR;
+							gemm_pack_b(b_pack.data() + j * kc, B, pc, jc + j, kc, min(GEMM_NR, nc - j));
+						}
+
+						#pragma omp parallel for
+						for (unsigned int p = 0; p < a_panels; ++p) {
+							const unsigned int i = p * GEMM_MR;
+							gemm_pack_a(a_pack.data() + i * kc, A, i, pc, min(GEMM_MR, m - i), kc);
+						}
+
+						// Each task multiplies a row block of A by a panel of B
+						#pragma omp parallel for collapse(2)
+						for (unsigned int b = 0; b < mc_blocks; ++b) {
+							for (unsigned int q = 0; q < b_panels; ++q) {
+
+								const unsigned int ic = b * ALGEBRA_GEMM_MC;
+								const unsigned int mc = min(ALGEBRA_GEMM_MC, m - ic);
+								const unsigned int jr = q * GEMM_NR;
+
+								for (unsigned int ir = 0; ir < mc; ir += GEMM_MR)
+									gemm_micro_kernel(
+										C, a_pack.data() + (ic + ir) * kc,
+										b_pack.data() + jr * kc, kc,
+										ic + ir, jc + jr,
+										min(GEMM_MR, mc - ir), min(GEMM_NR, nc - jr)
+									);
+							}
+						}
+					}
+				}
+
+				return C;
+			}
+		}
+
+
+		/// Multiply two matrices in parallel, equivalent to the
+		/// operation \f$R = A B\f$.
+		///
+		/// @param A The first matrix to multiply
+		/// @param B The second matrix to multiply
+		/// @return The resulting matrix
+		template<typename Matrix1, typename Matrix2, typename Matrix3 = Matrix1>
+		inline Matrix3 mat_mul(const Matrix1& A, const Matrix2& B) {
+
+			Matrix3 R;
+			R.resize(A.rows(), B.cols());
+
+			if(A.cols() != B.rows()) {
+				TH_MATH_ERROR("parallel::mat_mul", A.cols(), MathError::InvalidArgument);
+				return algebra::mat_error(R);
+			}
+
+			algebra::mat_zeroes(R);
+
+			return _internal::gemm(
+				R,
+				[&A](unsigned int i, unsigned int k) { return A(i, k); },
+				[&B](unsigned int k, unsigned int j) { return B(k, j); },
+				A.rows(), B.cols(), A.cols()
+			);
+		}
+
+
+		/// Multiply two matrices in parallel and store the result
+		/// in another matrix, equivalent to the operation \f$R = A B\f$.
+		///
+		/// @param R The matrix to overwrite with the result
+		/// @param A The first matrix to multiply
+		/// @param B The second matrix to multiply
+		/// @return A reference to the modified matrix
+		template<typename Matrix1, typename Matrix2, typename Matrix3>
+		inline Matrix1& mat_mul(Matrix1& R, const Matrix2& A, const Matrix3& B) {
+
+			if(R.rows() != A.rows()) {
+				TH_MATH_ERROR("parallel::mat_mul", R.rows(), MathError::InvalidArgument);
+				return algebra::mat_error(R);
+			}
+
+			if(R.cols() != B.cols()) {
+				TH_MATH_ERROR("parallel::mat_mul", R.cols(), MathError::InvalidArgument);
+				return algebra::mat_error(R);
+			}
+
+			if(A.cols() != B.rows()) {
+				TH_MATH_ERROR("parallel::mat_mul", A.cols(), MathError::InvalidArgument);
+				return algebra::mat_error(R);
+			}
+
+			algebra::mat_zeroes(R);
+
+			return _internal::gemm(
+				R,
+				[&A](unsigned int i, unsigned int k) { return A(i, k); },
+				[&B](unsigned int k, unsigned int j) { return B(k, j); },
+				A.rows(), B.cols(), A.cols()
+			);
+		}
+
+
+		/// Multiply the transpose of a matrix by another matrix in parallel,
+		/// equivalent to the operation \f$R = A^T B\f$.
+		///
+		/// @param A The matrix to transpose and then multiply
+		/// @param B The second matrix to multiply by
+		/// @return The result of the multiplication by the transpose of the first
+		/// matrix and the second matrix.
+		template<typename Matrix1, typename Matrix2, typename Matrix3 = Matrix1>
+		inline Matrix3 mat_transpose_mul(const Matrix1& A, const Matrix2& B) {
+
+			Matrix3 R;
+			R.resize(A.cols(), B.cols());
+
+			if(A.rows() != B.rows()) {
+				TH_MATH_ERROR("parallel::mat_transpose_mul", A.rows(), MathError::InvalidArgument);
+				return algebra::mat_error(R);
+			}
+
+			algebra::mat_zeroes(R);
+
+			return _internal::gemm(
+				R,
+				[&A](unsigned int i, unsigned int k) { return A(k, i); },
+				[&B](unsigned int k, unsigned int j) { return B(k, j); },
+				A.cols(), B.cols(), A.rows()
+			);
+		}
+
+
+		/// Returns the matrix transformation of a vector,
+		/// computing the rows of the result in parallel.
+		/// Equivalent to the operation A * v
+		///
+		/// @param A The matrix transformation
+		/// @param v The vector to transform
+		/// @return The transformed vector
+		template<typename Matrix, typename Vector, enable_matrix<Matrix> = true>
+		inline Vector transform(const Matrix& A, const Vector& v) {
+
+			Vector res;
+			res.resize(A.rows());
+
+			if(v.size() != A.cols()) {
+				TH_MATH_ERROR("parallel::transform", v.size(), MathError::InvalidArgument);
+				return algebra::vec_error(res);
+			}
+
+			using Type = vector_element_t<Vector>;
+
+			#pragma omp parallel for
+			for (unsigned int i = 0; i < A.rows(); ++i) {
+
+				Type sum = Type(0.0);
+
+				for (unsigned int j = 0; j < A.cols(); ++j)
+					sum += A(i, j) * v[j];
+
+				res[i] = sum;
+			}
+
+			return res;
+		}
+
+
+		/// Apply a matrix transformation to a vector, computing the
+		/// rows of the result in parallel, and store the result in another vector.
+		/// Equivalent to the operation res = A * v
+		///
+		/// @param res The vector to overwrite with the result
+		/// @param A The matrix transformation
+		/// @param v The vector to transform
+		/// @return A reference to the overwritten vector
+		template<typename Matrix, typename Vector1, typename Vector2,
+			enable_matrix<Matrix> = true>
+		inline Vector1& transform(Vector1& res, const Matrix& A, const Vector2& v) {
+
+			if(v.size() != A.cols()) {
+				TH_MATH_ERROR("parallel::transform", v.size(), MathError::InvalidArgument);
+				return algebra::vec_error(res);
+			}
+
+			if(res.size() != A.rows()) {
+				TH_MATH_ERROR("parallel::transform", res.size(), MathError::InvalidArgument);
+				return algebra::vec_error(res);
+			}
+
+			using Type = vector_element_t<Vector1>;
+
+			#pragma omp parallel for
+			for (unsigned int i = 0; i < A.rows(); ++i) {
+
+				Type sum = Type(0.0);
+
+				for (unsigned int j = 0; j < A.cols(); ++j)
+					sum += A(i, j) * v[j];
+
+				res[i] = sum;
+			}
+
+			return res;
+		}
+
+
+		/// Decompose a square matrix in-place to two triangular matrices,
+		/// L and U, so that \f$A = LU\f$, updating the rows below the pivot
+		/// in parallel at each elimination step. The diagonal of L,
+		/// equal to all ones, is omitted, as in algebra::decompose_lu_inplace.
+		///
+		/// @param A The matrix to decompose and overwrite
+		/// @return A reference to the overwritten matrix A
+		template<typename Matrix>
+		inline Matrix& decompose_lu_inplace(Matrix& A) {
+
+			if (!algebra::is_square(A)) {
+				TH_MATH_ERROR("parallel::decompose_lu_inplace", A.rows(), MathError::InvalidArgument);
+				return algebra::mat_error(A);
+			}
+
+			const unsigned int n = A.rows();
+
+			for (unsigned int j = 0; j < n; ++j) {
+
+				#pragma omp parallel for
+				for (unsigned int i = j + 1; i < n; ++i) {
+
+					A(i, j) /= A(j, j);
+
+					for (unsigned int k = j + 1; k < n; ++k)
+						A(i, k) -= algebra::pair_inner_product(A(i, j), A(j, k));
+				}
+			}
+
+			return A;
+		}
+
+
+		/// Decompose a square matrix in-place to two triangular matrices
+		/// using partial pivoting, so that \f$PA = LU\f$ where \f$P\f$ is
+		/// a permutation matrix, updating the rows below the pivot in parallel
+		/// at each elimination step. The matrix A is overwritten with the
+		/// elements of both L and U, omitting the diagonal of L, and the
+		/// permutation is stored as in algebra::decompose_lu_pivot_inplace.
+		/// Singular matrices are decomposed without errors, leaving
+		/// zero elements on the diagonal of U.
+		///
+		/// @param A The matrix to decompose and overwrite
+		/// @param perm The vector of indices to overwrite with the row permutation
+		/// @return A reference to the overwritten matrix A
+		template<typename Matrix, typename Permutation>
+		inline Matrix& decompose_lu_pivot_inplace(Matrix& A, Permutation& perm) {
+
+			using Type = matrix_element_t<Matrix>;
+			const unsigned int n = A.rows();
+
+			perm.resize(n);
+
+			if (!algebra::is_square(A)) {
+				TH_MATH_ERROR("parallel::decompose_lu_pivot_inplace", A.rows(), MathError::InvalidArgument);
+				return algebra::mat_error(A);
+			}
+
+			for (unsigned int i = 0; i < n; ++i)
+				perm[i] = i;
+
+			for (unsigned int j = 0; j < n; ++j) {
+
+				// Find the pivot with the largest absolute value
+				unsigned int p = j;
+				real max_abs = theoretica::abs(A(j, j));
+
+				for (unsigned int i = j + 1; i < n; ++i) {
+
+					const real a = theoretica::abs(A(i, j));
+
+					if (a > max_abs) {
+						max_abs = a;
+						p = i;
+					}
+				}
+
+				if (p != j) {
+
+					for (unsigned int k = 0; k < n; ++k) {
+						const Type tmp = A(j, k);
+						A(j, k) = A(p, k);
+						A(p, k) = tmp;
+					}
+
+					const auto tmp = perm[j];
+					perm[j] = perm[p];
+					perm[p] = tmp;
+				}
+
+				// Skip the elimination for a null column
+				if (A(j, j) == Type(0.0))
+					continue;
+
+				const Type inv_pivot = Type(1.0) / A(j, j);
+
+				#pragma omp parallel for
+				for (unsigned int i = j + 1; i < n; ++i) {
+
+					A(i, j) *= inv_pivot;
+
+					for (unsigned int k = j + 1; k < n; ++k)
+						A(i, k) -= A(i, j) * A(j, k);
+				}
+			}
+
+			return A;
+		}
+
+
+		/// Decompose a square matrix to two triangular matrices in parallel,
+		/// L and U where L is lower and U is upper, so that \f$A = LU\f$.
+		///
+		/// @param A The matrix to decompose
+		/// @param L The matrix to overwrite with the lower triangular one
+		/// @param U The matrix to overwrite with the upper triangular one
+		template<typename Matrix1, typename Matrix2, typename Matrix3>
+		inline void decompose_lu(const Matrix1& A, Matrix2& L, Matrix3& U) {
+
+			L.resize(A.rows(), A.cols());
+			U.resize(A.rows(), A.cols());
+
+			if (!algebra::is_square(A)) {
+				TH_MATH_ERROR("parallel::decompose_lu", A.rows(), MathError::InvalidArgument);
+				algebra::mat_error(L); algebra::mat_error(U);
+				return;
+			}
+
+			if (L.rows() != A.rows() || U.rows() != A.rows()) {
+				TH_MATH_ERROR("parallel::decompose_lu", L.rows(), MathError::InvalidArgument);
+				algebra::mat_error(L); algebra::mat_error(U);
+				return;
+			}
+
+			using Type = matrix_element_t<Matrix2>;
+
+			// Factor U in-place and move the lower part to L
+			algebra::mat_copy(U, A);
+			decompose_lu_inplace(U);
+
+			#pragma omp parallel for
+			for (unsigned int i = 0; i < A.rows(); ++i) {
+
+				for (unsigned int j = 0; j < A.cols(); ++j) {
+
+					if (j < i) {
+						L(i, j) = U(i, j);
+						U(i, j) = Type(0.0);
+					} else {
+						L(i, j) = Type(i == j ? 1.0 : 0.0);
+					}
+				}
+			}
+		}
+
+
+		/// Decompose a symmetric positive definite matrix in-place
+		/// into a triangular matrix so that \f$A = L L^T\f$, updating
+		/// the trailing submatrix in parallel at each step.
+		///
+		/// @param A The symmetric, positive definite matrix to decompose and overwrite
+		/// with the lower triangular matrix.
+		/// @return A reference to the overwritten matrix
+		template<typename Matrix>
+		inline Matrix& decompose_cholesky_inplace(Matrix& A) {
+
+			using Type = matrix_element_t<Matrix>;
+
+			if (!algebra::is_square(A)) {
+				TH_MATH_ERROR("parallel::decompose_cholesky_inplace", A.rows(), MathError::InvalidArgument);
+				return algebra::mat_error(A);
+			}
+
+			if (!algebra::is_symmetric(A)) {
+				TH_MATH_ERROR("parallel::decompose_cholesky_inplace", false, MathError::InvalidArgument);
+				return algebra::mat_error(A);
+			}
+
+			const unsigned int n = A.rows();
+
+			for (unsigned int k = 0; k < n; ++k) {
+
+				A(k, k) = theoretica::sqrt(A(k, k));
+
+				for (unsigned int i = k + 1; i < n; ++i)
+					A(i, k) /= A(k, k);
+
+				// Update the columns of the trailing submatrix in parallel
+				#pragma omp parallel for
+				for (unsigned int j = k + 1; j < n; ++j)
+					for (unsigned int i = j; i < n; ++i)
+						A(i, j) -= algebra::pair_inner_product(A(i, k), A(j, k));
+			}
+
+			// Zero out elements over the diagonal
+			#pragma omp parallel for
+			for (unsigned int i = 0; i < n; ++i)
+				for (unsigned int j = i + 1; j < n; ++j)
+					A(i, j) = Type(0.0);
+
+			return A;
+		}
+
+
+		/// Decompose a symmetric positive definite matrix in parallel into
+		/// a triangular matrix so that \f$A = L L^T\f$ using Cholesky decomposition.
+		///
+		/// @param A The matrix to decompose
+		/// @return The Cholesky decomposition of the matrix
+		template<typename Matrix>
+		inline Matrix decompose_cholesky(const Matrix& A) {
+
+			Matrix L;
+			L.resize(A.rows(), A.cols());
+			algebra::mat_copy(L, A);
+
+			return decompose_cholesky_inplace(L);
+		}
+
+
+		/// Invert the given matrix in parallel using Gauss-Jordan elimination,
+		/// eliminating the other rows in parallel for each pivot.
+		/// Equivalent to the operation dest = src^-1
+		///
+		/// @param dest The matrix to overwrite
+		/// @param src The matrix to invert
+		/// @return A reference to the inverted matrix
+		template<typename Matrix1, typename Matrix2>
+		inline Matrix1& inverse(Matrix1& dest, const Matrix2& src) {
+
+			if(src.rows() != src.cols()) {
+				TH_MATH_ERROR("parallel::inverse", src.rows(), MathError::InvalidArgument);
+				return algebra::mat_error(dest);
+			}
+
+			if(dest.rows() != src.rows()) {
+				TH_MATH_ERROR("parallel::inverse", dest.rows(), MathError::InvalidArgument);
+				return algebra::mat_error(dest);
+			}
+
+			if(dest.cols() != src.cols()) {
+				TH_MATH_ERROR("parallel::inverse", dest.cols(), MathError::InvalidArgument);
+				return algebra::mat_error(dest);
+			}
+
+			using Type = matrix_element_t<Matrix2>;
+			const unsigned int n = src.rows();
+
+			// Prepare extended matrix (A|B)
+			Matrix1 A;
+			A.resize(n, n);
+			algebra::mat_copy(A, src);
+			algebra::make_identity(dest);
+
+			for (unsigned int i = 0; i < n; ++i) {
+
+				// Make sure the element on the diagonal
+				// is non-zero by adding the first non-zero row
+				if(A(i, i) == (Type) 0) {
+
+					bool flag = false;
+
+					for (unsigned int j = i + 1; j < n; ++j) {
+
+						if(A(j, i) != (Type) 0) {
+
+							for (unsigned int k = 0; k < n; ++k) {
+								A(i, k) += A(j, k);
+								dest(i, k) += dest(j, k);
+							}
+
+							flag = true;
+							break;
+						}
+					}
+
+					if(!flag) {
+						TH_MATH_ERROR("parallel::inverse", flag, MathError::ImpossibleOperation);
+						return algebra::mat_error(dest);
+					}
+				}
+
+				const auto inv_pivot = ((Type) 1.0) / A(i, i);
+
+				// Divide the current row by the pivot
+				for (unsigned int k = 0; k < n; ++k) {
+					A(i, k) *= inv_pivot;
+					dest(i, k) *= inv_pivot;
+				}
+
+				// Use the current row to make all other
+				// elements of the column equal to zero
+				#pragma omp parallel for
+				for (unsigned int j = 0; j < n; ++j) {
+
+					if(j == i)
+						continue;
+
+					const auto coeff = A(j, i);
+
+					for (unsigned int k = 0; k < n; ++k) {
+						A(j, k) -= coeff * A(i, k);
+						dest(j, k) -= coeff * dest(i, k);
+					}
+				}
+			}
+
+			return dest;
+		}
+
+
+		/// Returns the inverse of the given matrix, computed in parallel.
+		/// Equivalent to the operation \f$m^-1\f$
+		///
+		/// @param m The matrix to invert
+		/// @return The inverted matrix
+		template<typename Matrix, typename MatrixInv = Matrix>
+		inline MatrixInv inverse(const Matrix& m) {
+			MatrixInv res;
+			res.resize(m.rows(), m.cols());
+			inverse(res, m);
+			return res;
+		}
+
+
+		/// Compute the determinant of a square matrix,
+		/// using parallel in-place LU decomposition with
+		/// partial pivoting to reduce the matrix to triangular form.
+		///
+		/// @param A The matrix to compute the determinant of
+		/// @return The determinant of the matrix
+		template<typename Matrix>
+		inline auto det(const Matrix& A) {
+
+			Matrix LU = algebra::clone(A);
+			std::vector<unsigned int> perm;
+			decompose_lu_pivot_inplace(LU, perm);
+
+			// The determinant of a triangular matrix
+			// is the product of the elements on its diagonal,
+			// while each row swap changes its sign
+			const auto d = algebra::diagonal_product(LU);
+			return algebra::permutation_sign(perm) > 0 ? d : -d;
+		}
 	}
 }
 
@@ -0,0 +1,506 @@
+///
+/// @file sparse.h Sparse matrices in compressed row (CSR) or compressed
+/// column (CSC) storage, with matrix-vector products and triangular solvers.
+///
+
+#ifndef THEORETICA_SPARSE_H
+#define THEORETICA_SPARSE_H
+
+#include <vector>
+#include <algorithm>
+#include "../core/error.h"
+#include "../core/constants.h"
+#include "../core/core_traits.h"
+#include "../core/real_analysis.h"
+#include "../complex/complex_analysis.h"
+#include "./algebra.h"
+#include "./vec.h"
+
+
+namespace theoretica {
+
+
+	/// @enum SparseFormat
+	/// Storage formats for sparse matrices
+	enum class SparseFormat {
+
+		/// Compressed Sparse Row, the non-zero elements
+		/// of each row are stored contiguously
+		CSR,
+
+		/// Compressed Sparse Column, the non-zero elements
+		/// of each column are stored contiguously
+		CSC
+	};
+
+
+	/// @class sparse_triplet
+	/// An element of a matrix in coordinate format,
+	/// used to construct sparse matrices.
+	template<typename Type = real>
+	struct sparse_triplet {
+
+		/// Row index
+		unsigned int row;
+
+		/// Column index
+		unsigned int col;
+
+		/// Value of the element
+		Type value;
+	};
+
+
+	/// @class sparse_mat
+	/// A sparse matrix which only stores its non-zero elements,
+	/// in compressed row (CSR) or compressed column (CSC) format.
+	/// The elements along the major dimension (rows for CSR, columns
+	/// for CSC) are stored contiguously and sorted by their minor index.
+	///
+	/// Elements are read-only through operator(), which makes sparse
+	/// matrices usable as input to generic routines of the algebra
+	/// namespace, while matrix-vector products and triangular solvers
+	/// have dedicated implementations which only visit the non-zero elements.
+	///
+	/// @tparam Type The type of the elements
+	/// @tparam Format The storage format
+	template<typename Type = real, SparseFormat Format = SparseFormat::CSR>
+	class sparse_mat {
+		public:
+
+			/// An element of the matrix in coordinate format
+			using triplet = sparse_triplet<Type>;
+
+
+			/// The non-zero elements, ordered by major and then minor index
+			std::vector<Type> values;
+
+			/// The minor index (column for CSR, row for CSC) of each element
+			std::vector<unsigned int> indices;
+
+			/// The offsets of the first element of each row (for CSR)
+			/// or column (for CSC) in values, with a final entry
+			/// equal to the number of non-zero elements
+			std::vector<unsigned int> offsets;
+
+
+		private:
+
+			/// Number of rows
+			unsigned int row_sz {0};
+
+			/// Number of columns
+			unsigned int col_sz {0};
+
+
+			/// Build the compressed storage from a list of triplets,
+			/// summing together the values of repeated entries.
+			inline void build(std::vector<triplet> entries) {
+
+				const bool row_major = (Format == SparseFormat::CSR);
+				const unsigned int major_sz = row_major ? row_sz : col_sz;
+
+				for (const auto& t : entries) {
+
+					if (t.row >= row_sz || t.col >= col_sz) {
+						TH_MATH_ERROR("sparse_mat::sparse_mat", t.row >= row_sz ? t.row : t.col,
+							MathError::InvalidArgument);
+						values.clear();
+						indices.clear();
+						offsets.assign(major_sz + 1, 0);
+						return;
+					}
+				}
+
+				// Sort by major and then minor index
+				std::sort(entries.begin(), entries.end(),
+					[row_major](const triplet& a, const triplet& b) {
+						return row_major
+							? (a.row < b.row || (a.row == b.row && a.col < b.col))
+							: (a.col < b.col || (a.col == b.col && a.row < b.row));
+					}
+				);
+
+				values.clear();
+				indices.clear();
+				values.reserve(entries.size());
+				indices.reserve(entries.size());
+				offsets.assign(major_sz + 1, 0);
+
+				for (unsigned int k = 0; k < entries.size(); ++k) {
+
+					const unsigned int major = row_major ? entries[k].row : entries[k].col;
+					const unsigned int minor = row_major ? entries[k].col : entries[k].row;
+
+					// Sum repeated entries
+					if (k > 0 && entries[k].row == entries[k - 1].row
+						&& entries[k].col == entries[k - 1].col) {
+						values.back() += entries[k].value;
+						continue;
+					}
+
+					values.push_back(entries[k].value);
+					indices.push_back(minor);
+					offsets[major + 1]++;
+				}
+
+				for (unsigned int i = 0; i < major_sz; ++i)
+					offsets[i + 1] += offsets[i];
+			}
+
+
+		public:
+
+			/// Default constructor, creates an empty matrix
+			sparse_mat() : offsets(1, 0) {}
+
+
+			/// Construct a matrix with the given number of
+			/// rows and columns and no non-zero elements.
+			///
+			/// @param rows The number of rows
+			/// @param cols The number of columns
+			sparse_mat(unsigned int rows, unsigned int cols)
+				: row_sz(rows), col_sz(cols) {
+
+				offsets.assign((Format == SparseFormat::CSR ? rows : cols) + 1, 0);
+			}
+
+
+			/// Construct a matrix from a list of its non-zero
+			/// elements in coordinate format. The values of
+			/// repeated entries are summed together.
+			///
+			/// @param rows The number of rows
+			/// @param cols The number of columns
+			/// @param entries The list of (row, column, value) triplets
+			sparse_mat(unsigned int rows, unsigned int cols, const std::vector<triplet>& entries)
+				: row_sz(rows), col_sz(cols) {
+
+				build(entries);
+			}
+
+
+			/// Construct a sparse matrix from any other matrix, storing all
+			/// of its nonzero elements or, if a tolerance is given, only
+			/// the elements which are bigger in module than the tolerance.
+			///
+			/// @param A The matrix to convert
+			/// @param tolerance The maximum absolute value of the elements
+			/// to drop, defaults to zero to keep all nonzero elements
+			template<typename Matrix, enable_matrix<Matrix> = true>
+			sparse_mat(const Matrix& A, real tolerance = 0.0)
+				: row_sz(A.rows()), col_sz(A.cols()) {
+
+				const bool row_major = (Format == SparseFormat::CSR);
+				const unsigned int major_sz = row_major ? row_sz : col_sz;
+				const unsigned int minor_sz = row_major ? col_sz : row_sz;
+
+				offsets.assign(major_sz + 1, 0);
+
+				for (unsigned int i = 0; i < major_sz; ++i) {
+
+					for (unsigned int j = 0; j < minor_sz; ++j) {
+
+						const Type x = row_major ? A(i, j) : A(j, i);
+
+						// NaN elements are kept, as they compare false
+						if (x != Type(0.0) && !(abs(x) <= tolerance)) {
+							values.push_back(x);
+							indices.push_back(j);
+						}
+					}
+
+					offsets[i + 1] = values.size();
+				}
+			}
+
+
+			/// Get the element at the given row and column, or zero
+			/// if it is not stored, using binary search over the
+			/// elements of the row (for CSR) or column (for CSC).
+			///
+			/// @param i The row index
+			/// @param j The column index
+			/// @return The value of the element
+			inline Type operator()(unsigned int i, unsigned int j) const {
+
+				const unsigned int major = (Format == SparseFormat::CSR) ? i : j;
+				const unsigned int minor = (Format == SparseFormat::CSR) ? j : i;
+
+				const auto begin = indices.begin() + offsets[major];
+				const auto end = indices.begin() + offsets[major + 1];
+				const auto it = std::lower_bound(begin, end, minor);
+
+				if (it == end || *it != minor)
+					return Type(0.0);
+
+				return values[it - indices.begin()];
+			}
+
+
+			/// Get the number of rows of the matrix
+			inline unsigned int rows() const {
+				return row_sz;
+			}
+
+
+			/// Get the number of columns of the matrix
+			inline unsigned int cols() const {
+				return col_sz;
+			}
+
+
+			/// Get the number of stored (non-zero) elements
+			inline unsigned int nonzeros() const {
+				return values.size();
+			}
+
+
+			/// Get the transpose of the matrix, which shares the same compressed
+			/// storage in the opposite format, without reordering any element.
+			///
+			/// @return The transposed matrix, in CSC format for a CSR matrix
+			/// and in CSR format for a CSC matrix
+			inline auto transpose() const {
+
+				constexpr SparseFormat Other = (Format == SparseFormat::CSR)
+					? SparseFormat::CSC : SparseFormat::CSR;
+
+				sparse_mat<Type, Other> T (col_sz, row_sz);
+				T.values = values;
+				T.indices = indices;
+				T.offsets = offsets;
+
+				return T;
+			}
+
+
+			/// Apply the matrix to a vector, visiting only the non-zero elements.
+			/// For CSR matrices, the rows of the result are computed in parallel.
+			///
+			/// @param v The vector to transform
+			/// @return The transformed vector
+			template<typename Vector>
+			inline Vector transform(const Vector& v) const {
+
+				Vector res;
+				res.resize(row_sz);
+
+				if (v.size() != col_sz) {
+					TH_MATH_ERROR("sparse_mat::transform", v.size(), MathError::InvalidArgument);
+					return algebra::vec_error(res);
+				}
+
+				if (Format == SparseFormat::CSR) {
+
+					#pragma omp parallel for
+					for (unsigned int i = 0; i < row_sz; ++i) {
+
+						Type sum = Type(0.0);
+
+						for (unsigned int k = offsets[i]; k < offsets[i + 1]; ++k)
+							sum += values[k] * v[indices[k]];
+
+						res[i] = sum;
+					}
+
+				} else {
+
+					// Scatter the contribution of each column
+					algebra::vec_zeroes(res);
+
+					for (unsigned int j = 0; j < col_sz; ++j)
+						for (unsigned int k = offsets[j]; k < offsets[j + 1]; ++k)
+							res[indices[k]] += values[k] * v[j];
+				}
+
+				return res;
+			}
+
+
+			/// Apply the matrix to a vector, visiting only the non-zero elements.
+			///
+			/// @param v The vector to transform
+			/// @return The transformed vector
+			template<typename Vector, enable_vector<Vector> = true>
+			inline Vector operator*(const Vector& v) const {
+				return transform(v);
+			}
+	};
+
+
+	namespace algebra {
+
+
+		/// Returns the matrix transformation of a vector by a sparse matrix,
+		/// visiting only its non-zero elements.
+		/// Equivalent to the operation A * v
+		///
+		/// @param A The sparse matrix transformation
+		/// @param v The vector to transform
+		/// @return The transformed vector
+		template<typename Type, SparseFormat Format, typename Vector>
+		inline Vector transform(const sparse_mat<Type, Format>& A, const Vector& v) {
+			return A.transform(v);
+		}
+
+
+		/// Solve the linear system \f$L \vec x = b\f$ for a lower
+		/// triangular sparse matrix, visiting only its non-zero elements.
+		/// Elements over the diagonal are ignored.
+		///
+		/// @param L The lower triangular sparse matrix
+		/// @param b The known vector
+		/// @return The unknown vector
+		template<typename Type, SparseFormat Format, typename Vector>
+		inline Vector solve_triangular_lower(const sparse_mat<Type, Format>& L, const Vector& b) {
+
+			Vector x = algebra::clone(b);
+
+			if (!is_square(L)) {
+				TH_MATH_ERROR("algebra::solve_triangular_lower", L.rows(), MathError::InvalidArgument);
+				return vec_error(x);
+			}
+
+			if (L.rows() != b.size()) {
+				TH_MATH_ERROR("algebra::solve_triangular_lower", b.size(), MathError::InvalidArgument);
+				return vec_error(x);
+			}
+
+			const unsigned int n = L.rows();
+
+			if (Format == SparseFormat::CSR) {
+
+				// Row-oriented forward substitution
+				for (unsigned int i = 0; i < n; ++i) {
+
+					Type sum = Type(0.0);
+					Type diag = Type(0.0);
+
+					for (unsigned int k = L.offsets[i]; k < L.offsets[i + 1]; ++k) {
+
+						const unsigned int j = L.indices[k];
+
+						if (j < i)
+							sum += L.values[k] * x[j];
+						else if (j == i)
+							diag = L.values[k];
+					}
+
+					if (abs(diag) < MACH_EPSILON) {
+						TH_MATH_ERROR("algebra::solve_triangular_lower", diag, MathError::DivByZero);
+						return vec_error(x);
+					}
+
+					x[i] = (x[i] - sum) / diag;
+				}
+
+			} else {
+
+				// Column-oriented forward substitution
+				for (unsigned int j = 0; j < n; ++j) {
+
+					Type diag = Type(0.0);
+
+					for (unsigned int k = L.offsets[j]; k < L.offsets[j + 1]; ++k)
+						if (L.indices[k] == j)
+							diag = L.values[k];
+
+					if (abs(diag) < MACH_EPSILON) {
+						TH_MATH_ERROR("algebra::solve_triangular_lower", diag, MathError::DivByZero);
+						return vec_error(x);
+					}
+
+					x[j] /= diag;
+
+					for (unsigned int k = L.offsets[j]; k < L.offsets[j + 1]; ++k)
+						if (L.indices[k] > j)
+							x[L.indices[k]] -= L.values[k] * x[j];
+				}
+			}
+
+			return x;
+		}
+
+
+		/// Solve the linear system \f$U \vec x = b\f$ for an upper
+		/// triangular sparse matrix, visiting only its non-zero elements.
+		/// Elements under the diagonal are ignored.
+		///
+		/// @param U The upper triangular sparse matrix
+		/// @param b The known vector
+		/// @return The unknown vector
+		template<typename Type, SparseFormat Format, typename Vector>
+		inline Vector solve_triangular_upper(const sparse_mat<Type, Format>& U, const Vector& b) {
+
+			Vector x = algebra::clone(b);
+
+			if (!is_square(U)) {
+				TH_MATH_ERROR("algebra::solve_triangular_upper", U.rows(), MathError::InvalidArgument);
+				return vec_error(x);
+			}
+
+			if (U.rows() != b.size()) {
+				TH_MATH_ERROR("algebra::solve_triangular_upper", b.size(), MathError::InvalidArgument);
+				return vec_error(x);
+			}
+
+			const int n = U.rows();
+
+			if (Format == SparseFormat::CSR) {
+
+				// Row-oriented backward substitution
+				for (int i = n - 1; i >= 0; --i) {
+
+					Type sum = Type(0.0);
+					Type diag = Type(0.0);
+
+					for (unsigned int k = U.offsets[i]; k < U.offsets[i + 1]; ++k) {
+
+						const int j = U.indices[k];
+
+						if (j > i)
+							sum += U.values[k] * x[j];
+						else if (j == i)
+							diag = U.values[k];
+					}
+
+					if (abs(diag) < MACH_EPSILON) {
+						TH_MATH_ERROR("algebra::solve_triangular_upper", diag, MathError::DivByZero);
+						return vec_error(x);
+					}
+
+					x[i] = (x[i] - sum) / diag;
+				}
+
+			} else {
+
+				// Column-oriented backward substitution
+				for (int j = n - 1; j >= 0; --j) {
+
+					Type diag = Type(0.0);
+
+					for (unsigned int k = U.offsets[j]; k < U.offsets[j + 1]; ++k)
+						if (int(U.indices[k]) == j)
+							diag = U.values[k];
+
+					if (abs(diag) < MACH_EPSILON) {
+						TH_MATH_ERROR("algebra::solve_triangular_upper", diag, MathError::DivByZero);
+						return vec_error(x);
+					}
+
+					x[j] /= diag;
+
+					for (unsigned int k = U.offsets[j]; k < U.offsets[j + 1]; ++k)
+						if (int(U.indices[k]) < j)
+							x[U.indices[k]] -= U.values[k] * x[j];
+				}
+			}
+
+			return x;
+		}
+	}
+}
+
+#endif
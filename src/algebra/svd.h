@@ -0,0 +1,468 @@
+///
+/// @file svd.h Singular value decomposition of real and complex matrices
+/// using the one-sided Jacobi method, with the pseudo-inverse and
+/// numerical rank built on it.
+///
+
+#ifndef THEORETICA_SVD_H
+#define THEORETICA_SVD_H
+
+#include <vector>
+#include "../core/error.h"
+#include "../core/constants.h"
+#include "../core/core_traits.h"
+#include "../core/real_analysis.h"
+#include "../complex/complex_analysis.h"
+#include "./algebra.h"
+#include "./vec.h"
+#include "./mat.h"
+
+
+namespace theoretica {
+
+	namespace algebra {
+
+
+		namespace _internal {
+
+
+			/// Orthogonalize the columns of a matrix with at least as many
+			/// rows as columns using one-sided Jacobi rotations, so that
+			/// \f$W V\f$ has orthogonal columns, whose norms are the singular values.
+			///
+			/// @param W The matrix to orthogonalize in-place
+			/// @param V The matrix to accumulate the rotations into,
+			/// which should be initialized to the identity (unused if accumulate is false)
+			/// @param accumulate Whether to accumulate the rotations into V
+			/// @return Whether the algorithm converged
+			template<typename Matrix1, typename Matrix2>
+			inline bool svd_jacobi(Matrix1& W, Matrix2& V, bool accumulate) {
+
+				using Type = matrix_element_t<Matrix1>;
+
+				const unsigned int m = W.rows();
+				const unsigned int n = W.cols();
+
+				for (unsigned int sweep = 0; sweep < ALGEBRA_EIGEN_ITER; ++sweep) {
+
+					bool rotated = false;
+
+					for (unsigned int p = 0; p < n; ++p) {
+
+						for (unsigned int q = p + 1; q < n; ++q) {
+
+							real alpha = 0.0;
+							real beta = 0.0;
+							Type gamma = Type(0.0);
+
+							for (unsigned int i = 0; i < m; ++i) {
+
+								const real abs_p = abs(W(i, p));
+								const real abs_q = abs(W(i, q));
+
+								alpha += abs_p * abs_p;
+								beta += abs_q * abs_q;
+								gamma += conjugate(W(i, p)) * W(i, q);
+							}
+
+							const real abs_gamma = abs(gamma);
+
+							// Skip columns which are already orthogonal
+							if (abs_gamma <= MACH_EPSILON * sqrt(alpha * beta))
+								continue;
+
+							rotated = true;
+
+							// Compute the rotation which annihilates gamma
+							const real zeta = (beta - alpha) / (2.0 * abs_gamma);
+							const real t = (zeta >= 0.0 ? 1.0 : -1.0)
+								/ (abs(zeta) + sqrt(1.0 + zeta * zeta));
+							const real c = 1.0 / sqrt(1.0 + t * t);
+
+							// Unit phase of gamma (its sign for real matrices)
+							const Type phase = gamma / abs_gamma;
+							const Type s_p = phase * (c * t);
+							const Type s_q = conjugate(phase) * (c * t);
+
+							for (unsigned int i = 0; i < m; ++i) {
+
+								const Type w_p = W(i, p);
+								const Type w_q = W(i, q);
+
+								W(i, p) = w_p * c - s_q * w_q;
+								W(i, q) = s_p * w_p + w_q * c;
+							}
+
+							if (!accumulate)
+								continue;
+
+							for (unsigned int i = 0; i < n; ++i) {
+
+								const Type v_p = V(i, p);
+								const Type v_q = V(i, q);
+
+								V(i, p) = v_p * c - s_q * v_q;
+								V(i, q) = s_p * v_p + v_q * c;
+							}
+						}
+					}
+
+					if (!rotated)
+						return true;
+				}
+
+				return false;
+			}
+
+
+			/// Complete a set of orthonormal columns of a matrix to an
+			/// orthonormal basis, overwriting the columns which are not
+			/// marked as valid using Gram-Schmidt orthogonalization
+			/// of the canonical basis vectors.
+			///
+			/// @param U The matrix whose invalid columns are overwritten
+			/// @param valid Whether each column of U is already part of the basis
+			template<typename Matrix>
+			inline void complete_orthonormal(Matrix& U, std::vector<bool>& valid) {
+
+				using Type = matrix_element_t<Matrix>;
+				const unsigned int m = U.rows();
+
+				// Rejected canonical vectors have a residual under the threshold,
+				// so the remaining ones always contain at least one with a greater residual
+				const real threshold = 0.5 / sqrt(real(m));
+
+				unsigned int e = 0;
+
+				for (unsigned int j = 0; j < U.cols(); ++j) {
+
+					if (valid[j])
+						continue;
+
+					// Try canonical vectors until one is independent
+					for (; e < m; ++e) {
+
+						for (unsigned int i = 0; i < m; ++i)
+							U(i, j) = Type(i == e ? 1.0 : 0.0);
+
+						// Orthogonalize twice for numerical stability
+						for (unsigned int pass = 0; pass < 2; ++pass) {
+
+							for (unsigned int l = 0; l < U.cols(); ++l) {
+
+								if (!valid[l])
+									continue;
+
+								Type proj = Type(0.0);
+
+								for (unsigned int i = 0; i < m; ++i)
+									proj += conjugate(U(i, l)) * U(i, j);
+
+								for (unsigned int i = 0; i < m; ++i)
+									U(i, j) -= proj * U(i, l);
+							}
+						}
+
+						real norm = 0.0;
+
+						for (unsigned int i = 0; i < m; ++i)
+							norm += abs(U(i, j)) * abs(U(i, j));
+
+						norm = sqrt(norm);
+
+						if (norm > threshold) {
+
+							for (unsigned int i = 0; i < m; ++i)
+								U(i, j) *= 1.0 / norm;
+
+							valid[j] = true;
+							e++;
+							break;
+						}
+					}
+				}
+			}
+
+
+			/// Compute the singular value decomposition of a matrix with the
+			/// one-sided Jacobi method, working on the matrix or on its conjugate
+			/// transpose so that the working matrix has at least as many rows
+			/// as columns.
+			///
+			/// @param A The matrix to decompose
+			/// @param W The matrix to overwrite with the left singular vectors
+			/// of the working matrix (normalized only if accumulate is true)
+			/// @param V The matrix to overwrite with the right singular
+			/// vectors of the working matrix
+			/// @param S The vector to overwrite with the singular values,
+			/// sorted in descending order
+			/// @param accumulate Whether to compute the singular vectors
+			/// @return Whether the algorithm converged
+			template<typename Matrix, typename Type, typename Vector>
+			inline bool svd_work(
+				const Matrix& A, mat<Type>& W, mat<Type>& V, Vector& S, bool accumulate) {
+
+				const bool transposed = A.rows() < A.cols();
+
+				if (!transposed) {
+
+					W.resize(A.rows(), A.cols());
+					mat_copy(W, A);
+
+				} else {
+
+					W.resize(A.cols(), A.rows());
+
+					for (unsigned int i = 0; i < A.cols(); ++i)
+						for (unsigned int j = 0; j < A.rows(); ++j)
+							W(i, j) = conjugate(A(j, i));
+				}
+
+				const unsigned int k = W.cols();
+
+				if (accumulate) {
+					V.resize(k, k);
+					make_identity(V);
+				}
+
+				if (!svd_jacobi(W, V, accumulate))
+					return false;
+
+				S.resize(k);
+
+				for (unsigned int j = 0; j < k; ++j) {
+
+					real sqr_norm = 0.0;
+
+					for (unsigned int i = 0; i < W.rows(); ++i)
+						sqr_norm += abs(W(i, j)) * abs(W(i, j));
+
+					S[j] = sqrt(sqr_norm);
+				}
+
+				// Sort the singular values in descending order
+				for (unsigned int i = 0; i < k; ++i) {
+
+					unsigned int max_j = i;
+
+					for (unsigned int j = i + 1; j < k; ++j)
+						if (S[j] > S[max_j])
+							max_j = j;
+
+					if (max_j == i)
+						continue;
+
+					const real tmp = S[i];
+					S[i] = S[max_j];
+					S[max_j] = tmp;
+
+					if (!accumulate)
+						continue;
+
+					for (unsigned int l = 0; l < W.rows(); ++l) {
+						const Type w = W(l, i);
+						W(l, i) = W(l, max_j);
+						W(l, max_j) = w;
+					}
+
+					for (unsigned int l = 0; l < V.rows(); ++l) {
+						const Type v = V(l, i);
+						V(l, i) = V(l, max_j);
+						V(l, max_j) = v;
+					}
+				}
+
+				if (accumulate) {
+
+					for (unsigned int j = 0; j < k; ++j) {
+
+						if (S[j] == 0.0)
+							continue;
+
+						const real inv_s = 1.0 / S[j];
+
+						for (unsigned int i = 0; i < W.rows(); ++i)
+							W(i, j) *= inv_s;
+					}
+				}
+
+				return true;
+			}
+		}
+
+
+		/// Compute the singular values of a real or complex matrix
+		/// using the one-sided Jacobi method, without computing the
+		/// singular vectors.
+		///
+		/// @param A The matrix to compute the singular values of
+		/// @return The vector of the min(rows, cols) singular values,
+		/// sorted in descending order
+		template<typename Matrix, typename Vector = vec<real>>
+		inline Vector singular_values(const Matrix& A) {
+
+			using Type = matrix_element_t<Matrix>;
+
+			Vector S;
+			mat<Type> W, V;
+
+			if (!_internal::svd_work(A, W, V, S, false)) {
+				TH_MATH_ERROR("algebra::singular_values", false, MathError::NoConvergence);
+				return vec_error(S);
+			}
+
+			return S;
+		}
+
+
+		/// Compute the singular value decomposition of a real or complex
+		/// matrix, \f$A = U \Sigma V^H\f$, using the one-sided Jacobi method.
+		/// In thin (economy) mode, only the first \f$k = min(m, n)\f$ columns
+		/// of U and V are computed, so that U is \f$m \times k\f$ and V is
+		/// \f$n \times k\f$, otherwise U is \f$m \times m\f$ and V is \f$n \times n\f$.
+		/// Singular vectors of null singular values are completed
+		/// to an orthonormal basis.
+		///
+		/// @param A The matrix to decompose
+		/// @param U The matrix to overwrite with the left singular vectors as columns
+		/// @param S The vector to overwrite with the k singular values,
+		/// sorted in descending order
+		/// @param V The matrix to overwrite with the right singular vectors as columns
+		/// @param thin Whether to compute the thin decomposition (defaults to true)
+		template<typename Matrix, typename Matrix1, typename Vector, typename Matrix2>
+		inline void decompose_svd(
+			const Matrix& A, Matrix1& U, Vector& S, Matrix2& V, bool thin = true) {
+
+			using Type = matrix_element_t<Matrix>;
+
+			const unsigned int m = A.rows();
+			const unsigned int n = A.cols();
+			const unsigned int k = min(m, n);
+			const bool transposed = m < n;
+
+			mat<Type> W, Vw;
+
+			if (!_internal::svd_work(A, W, Vw, S, true)) {
+				TH_MATH_ERROR("algebra::decompose_svd", false, MathError::NoConvergence);
+				U.resize(m, thin ? k : m);
+				V.resize(n, thin ? k : n);
+				mat_error(U); mat_error(V); vec_error(S);
+				return;
+			}
+
+			// Extend the left singular vectors of the working
+			// matrix, completing the basis where needed
+			const unsigned int p = W.rows();
+			mat<Type> Wc (p, thin ? k : p);
+			std::vector<bool> valid (Wc.cols(), false);
+
+			for (unsigned int j = 0; j < k; ++j) {
+
+				if (S[j] == 0.0)
+					continue;
+
+				for (unsigned int i = 0; i < p; ++i)
+					Wc(i, j) = W(i, j);
+
+				valid[j] = true;
+			}
+
+			_internal::complete_orthonormal(Wc, valid);
+
+			// The conjugate transpose exchanges the
+			// left and right singular vectors
+			const mat<Type>& U_work = transposed ? Vw : Wc;
+			const mat<Type>& V_work = transposed ? Wc : Vw;
+
+			U.resize(U_work.rows(), U_work.cols());
+			V.resize(V_work.rows(), V_work.cols());
+			mat_copy(U, U_work);
+			mat_copy(V, V_work);
+		}
+
+
+		/// Compute the Moore-Penrose pseudo-inverse of a real or complex
+		/// matrix using its singular value decomposition,
+		/// \f$A^+ = V \Sigma^+ U^H\f$, where singular values smaller
+		/// than the tolerance are treated as zero.
+		///
+		/// @param A The matrix to compute the pseudo-inverse of
+		/// @param tolerance The threshold under which singular values
+		/// are ignored (if negative, defaults to max(m, n) times the
+		/// largest singular value times MACH_EPSILON).
+		/// @return The pseudo-inverse, with as many rows as the columns of A
+		/// and as many columns as the rows of A
+		template<typename Matrix, typename MatrixInv = mat<matrix_element_t<Matrix>>>
+		inline MatrixInv pinv(const Matrix& A, real tolerance = -1.0) {
+
+			using Type = matrix_element_t<Matrix>;
+
+			mat<Type> U, V;
+			vec<real> S;
+
+			decompose_svd(A, U, S, V);
+
+			MatrixInv P;
+			P.resize(A.cols(), A.rows());
+
+			if (S.size() && is_nan(S[0])) {
+				TH_MATH_ERROR("algebra::pinv", S[0], MathError::NoConvergence);
+				return mat_error(P);
+			}
+
+			if (tolerance < 0.0)
+				tolerance = max(A.rows(), A.cols()) * (S.size() ? S[0] : 0.0) * MACH_EPSILON;
+
+			mat_zeroes(P);
+
+			for (unsigned int l = 0; l < S.size(); ++l) {
+
+				if (S[l] <= tolerance)
+					continue;
+
+				const real inv_s = 1.0 / S[l];
+
+				for (unsigned int j = 0; j < P.cols(); ++j) {
+
+					const Type u = conjugate(U(j, l)) * inv_s;
+
+					for (unsigned int i = 0; i < P.rows(); ++i)
+						P(i, j) += V(i, l) * u;
+				}
+			}
+
+			return P;
+		}
+
+
+		/// Estimate the numerical rank of a real or complex matrix,
+		/// as the number of its singular values greater than the tolerance.
+		///
+		/// @param A The matrix to compute the rank of
+		/// @param tolerance The threshold under which singular values
+		/// are considered null (if negative, defaults to max(m, n) times the
+		/// largest singular value times MACH_EPSILON).
+		/// @return The numerical rank of the matrix
+		template<typename Matrix>
+		inline unsigned int rank(const Matrix& A, real tolerance = -1.0) {
+
+			const vec<real> S = singular_values(A);
+
+			if (S.size() == 0)
+				return 0;
+
+			if (tolerance < 0.0)
+				tolerance = max(A.rows(), A.cols()) * S[0] * MACH_EPSILON;
+
+			unsigned int r = 0;
+
+			for (unsigned int i = 0; i < S.size(); ++i)
+				if (S[i] > tolerance)
+					r++;
+
+			return r;
+		}
+	}
+}
+
+#endif
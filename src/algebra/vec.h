@@ -13,8 +13,11 @@
 
 #include "../core/error.h"
 #include "../core/real_analysis.h"
+#include "../core/allocator.h"
 #include "./algebra.h"
+#include "./expression.h"
 #include <vector>
+#include <memory>
 
 
 namespace theoretica {
@@ -87,8 +90,11 @@ namespace theoretica {
 	/// @class vec
 	/// A statically allocated N-dimensional vector
 	/// with elements of the given type.
+	/// The Allocator parameter is only used by
+	/// dynamically allocated vectors.
 	/// 
-	template<typename Type = real, unsigned int N = 0>
+	template<typename Type = real, unsigned int N = 0,
+		typename Allocator = std::allocator<Type>>
 	class vec {
 		
 		private:
@@ -551,12 +557,16 @@ namespace theoretica {
 	/// A dynamically allocated vector
 	/// with elements of the given type.
 	///
-	template<typename Type>
-	class vec<Type, 0> {
+	/// @param Type The type of the elements
+	/// @param Allocator The allocator of the storage,
+	/// such as aligned_allocator or arena_allocator
+	template<typename Type, typename Allocator>
+	class vec<Type, 0, Allocator> {
 
 		// Container type for storage (alias for std::vector)
 		template<typename T>
-		using Container = std::vector<T>;
+		using Container = std::vector<T,
+			typename std::allocator_traits<Allocator>::template rebind_alloc<T>>;
 
 	private:
 			Container<Type> elements;
@@ -569,6 +579,9 @@ namespace theoretica {
 		/// Construct an empty vector.
 		vec() = default;
 
+		/// Construct an empty vector which uses the given allocator.
+		explicit vec(const Allocator& alloc) : elements(alloc) {}
+
 		/// Construct a vector with the given size
 		/// and all elements equal to zero.
 		vec(unsigned int n) {
@@ -579,9 +592,13 @@ namespace theoretica {
 		/// Construct a vector with the given size
 		/// and all elements equal to the given value
 		vec(unsigned int n, Type a) {
-			elements = std::vector<Type>(n, a);
+			elements.assign(n, a);
 		}
 
+		/// Construct a vector with the given size and all elements
+		/// equal to zero, which uses the given allocator.
+		vec(unsigned int n, const Allocator& alloc) : elements(n, Type(0), alloc) {}
+
 		/// Copy constructor
 		template <
 			typename Vector,
@@ -591,6 +608,22 @@ namespace theoretica {
 			algebra::vec_copy(*this, other);
 		}
 
+
+		/// Construct a vector by evaluating an expression
+		template<typename Op, typename LHS, typename RHS>
+		vec(const vec_expr<Op, LHS, RHS>& expr) {
+			_internal::expr_eval(*this, expr);
+		}
+
+
+		/// Evaluate an expression into the vector,
+		/// reusing the existing storage when possible.
+		template<typename Op, typename LHS, typename RHS>
+		inline vec& operator=(const vec_expr<Op, LHS, RHS>& expr) {
+			return _internal::expr_eval(*this, expr);
+		}
+
+
 		/// Construct a vector from its elements, provided they are more than two
 		/// (to avoid conflict with other constructors).
 		template<typename... Args>
@@ -605,16 +638,16 @@ namespace theoretica {
 
 
 		/// Identity
-		inline vec<Type> operator+() const {
+		inline vec operator+() const {
 			return *this;
 		}
 
 
 		/// Vector sum (v + w = (v.x + w.x, ...))
-		template<typename Vector>
-		inline vec<Type> operator+(const Vector& other) const {
+		template<typename Vector, _internal::disable_expr<Vector> = true>
+		inline vec operator+(const Vector& other) const {
 			
-			vec<Type> result;
+			vec result;
 			result.resize(size());
 			algebra::vec_sum(result, *this, other);
 			return result;
@@ -622,16 +655,16 @@ namespace theoretica {
 
 
 		/// Opposite vector
-		inline vec<Type> operator-() const {
+		inline vec operator-() const {
 			return *this * (Type) -1;
 		}
 
 
 		/// Vector subtraction
-		template<typename Vector>
-		inline vec<Type> operator-(const Vector& other) const {
+		template<typename Vector, _internal::disable_expr<Vector> = true>
+		inline vec operator-(const Vector& other) const {
 			
-			vec<Type> result;
+			vec result;
 			result.resize(size());
 			algebra::vec_diff(result, *this, other);
 			return result;
@@ -639,9 +672,9 @@ namespace theoretica {
 
 
 		/// Scalar multiplication (av = (v.x * a, ...))
-		inline vec<Type> operator*(Type scalar) const {
+		inline vec operator*(Type scalar) const {
 
-			vec<Type> result;
+			vec result;
 			result.resize(size());
 
 			for (unsigned int i = 0; i < size(); ++i)
@@ -652,9 +685,9 @@ namespace theoretica {
 
 
 		/// Scalar division (v / a = (v.x / a, ...))
-		inline vec<Type> operator/(Type scalar) const {
+		inline vec operator/(Type scalar) const {
 
-			vec<Type> result;
+			vec result;
 			result.resize(size());
 
 			for (unsigned int i = 0; i < size(); ++i)
@@ -680,14 +713,14 @@ namespace theoretica {
 
 		/// Cross product between vectors
 		template<typename Vector>
-		inline vec<Type> cross(const Vector& other) const {
+		inline vec cross(const Vector& other) const {
 			return algebra::cross(*this, other);
 		}
 
 
 		/// Sum a vector to the vector itself
 		template<typename Vector>
-		inline vec<Type>& operator+=(const Vector& other) {
+		inline vec& operator+=(const Vector& other) {
 
 			// If the vector is uninitialized,
 			// initialize it to be a zero vector
@@ -697,11 +730,11 @@ namespace theoretica {
 
 			if(size() != other.size()) {
 				TH_MATH_ERROR("vec::operator+=", size(), MathError::InvalidArgument);
-				return (*this = vec<Type>(max(size(), 1), nan()));
+				return (*this = vec(max(size(), 1), nan()));
 			}
 
 			for (unsigned int i = 0; i < size(); ++i)
-				elements[i] += other.elements[i];
+				elements[i] += other[i];
 		
 			return *this;
 		}
@@ -709,22 +742,22 @@ namespace theoretica {
 
 		/// Subtract a vector from the vector itself
 		template<typename Vector>
-		inline vec<Type>& operator-=(const Vector& other) {
+		inline vec& operator-=(const Vector& other) {
 
 			if(size() != other.size()) {
 				TH_MATH_ERROR("vec::operator-=", size(), MathError::InvalidArgument);
-				return (*this = vec<Type>(max(size(), 1), nan()));
+				return (*this = vec(max(size(), 1), nan()));
 			}
 
 			for (unsigned int i = 0; i < size(); ++i)
-				elements[i] -= other.elements[i];
+				elements[i] -= other[i];
 		
 			return *this;
 		}
 
 
 		/// Multiply the vector itself by a scalar
-		inline vec<Type>& operator*=(Type scalar) {
+		inline vec& operator*=(Type scalar) {
 
 			for (unsigned int i = 0; i < size(); ++i)
 				elements[i] *= scalar;
@@ -734,11 +767,11 @@ namespace theoretica {
 
 
 		/// Divide the vector itself by a scalar
-		inline vec<Type>& operator/=(Type scalar) {
+		inline vec& operator/=(Type scalar) {
 
 			if(abs(scalar) < MACH_EPSILON) {
 				TH_MATH_ERROR("vec::operator/=", scalar, MathError::DivByZero);
-				*this = vec<Type>(max(size(), 1), nan());
+				*this = vec(max(size(), 1), nan());
 				return *this;
 			}
 
@@ -834,6 +867,12 @@ namespace theoretica {
 		}
 
 
+		/// Get the allocator of the storage of the vector.
+		inline Allocator get_allocator() const {
+			return elements.get_allocator();
+		}
+
+
 		/// Vector normalization (v / |v|)
 		inline void normalize() {
 			algebra::make_normalized(*this);
@@ -841,7 +880,7 @@ namespace theoretica {
 
 
 		/// Return the normalized vector (v / |v|)
-		inline vec<Type> normalized() const {
+		inline vec normalized() const {
 			return algebra::normalize(*this);
 		}
 
@@ -902,15 +941,15 @@ namespace theoretica {
 
 		/// Returns an euclidean base unit vector
 		/// with the i-th element set to 1 and size n.
-		inline static vec<Type> euclidean_base(
+		inline static vec euclidean_base(
 			unsigned int i, unsigned int n) {
 
 			if(i >= n) {
 				TH_MATH_ERROR("vec::euclidean_base", i, MathError::InvalidArgument);
-				return vec<Type>(n, nan());
+				return vec(n, nan());
 			}
 
-			vec<Type> e_i = vec<Type>(n, Type(0.0));
+			vec e_i = vec(n, Type(0.0));
 			e_i.resize(n);
 			e_i[i] = 1;
 
@@ -920,7 +959,7 @@ namespace theoretica {
 
 		/// Friend operator to enable equations of the form
 		/// (Type) * (vec)
-		inline friend vec<Type> operator*(Type a, const vec<Type>& v) {
+		inline friend vec operator*(Type a, const vec& v) {
 			return v * a;
 		}
 
@@ -957,7 +996,7 @@ namespace theoretica {
 
 
 		/// Stream the vector in string representation to an output stream (std::ostream)
-		inline friend std::ostream& operator<<(std::ostream& out, const vec<Type>& obj) {
+		inline friend std::ostream& operator<<(std::ostream& out, const vec& obj) {
 			return out << obj.to_string();
 		}
 
@@ -0,0 +1,739 @@
+///
+/// @file view.h Non-owning views over the elements of vectors and matrices,
+/// such as submatrices, rows, columns and strided slices, and over externally
+/// owned buffers (e.g. memory of a NumPy array or an HDF5 dataset).
+/// Views satisfy the vector and matrix traits, so they may be passed to the
+/// generic routines of algebra.h, and writing to a view modifies the referenced
+/// elements. A view must not outlive the memory it references.
+///
+/// Copying a view, moving it or taking a sub-view references the same
+/// elements without copying them, while algebra::clone copies the referenced
+/// elements into new storage owned by the returned view. Assigning a vector
+/// or matrix of another type writes its elements into the referenced memory.
+/// A default constructed view is unbound and allocates its own storage when
+/// resized, so that routines returning a new vector or matrix of the same
+/// type as their argument may be used with views.
+///
+
+#ifndef THEORETICA_VIEW_H
+#define THEORETICA_VIEW_H
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include "../core/error.h"
+#include "../core/constants.h"
+#include "../core/core_traits.h"
+#include "./algebra.h"
+#include "./vec.h"
+#include "./mat.h"
+
+
+namespace theoretica {
+
+
+	template<typename Type> class vec_view;
+	template<typename Type> class mat_view;
+
+
+	namespace _internal {
+
+
+		/// Check whether a type is a mat, whose elements
+		/// are stored contiguously in the library's storage order.
+		template<typename Structure>
+		struct is_mat_storage : std::false_type {};
+
+		template<typename Type, unsigned int N, unsigned int K, typename Allocator>
+		struct is_mat_storage<mat<Type, N, K, Allocator>> : std::true_type {};
+
+
+		/// Check whether a structure has a data() method
+		/// returning a pointer convertible to Type*.
+		template<typename Structure, typename Type, typename = _internal::void_t<>>
+		struct has_data_of : std::false_type {};
+
+		template<typename Structure, typename Type>
+		struct has_data_of
+		<Structure, Type, _internal::void_t<decltype(std::declval<Structure&>().data())>>
+		: std::is_convertible<decltype(std::declval<Structure&>().data()), Type*> {};
+
+
+		/// Check whether a type is a vector whose elements are stored
+		/// contiguously and accessed through a data() method.
+		template<typename Structure, typename = _internal::void_t<>>
+		struct is_contiguous_vector : std::false_type {};
+
+		template<typename Structure>
+		struct is_contiguous_vector
+		<Structure, _internal::void_t<decltype(std::declval<Structure&>().data())>>
+		: std::integral_constant<bool,
+			is_vector<Structure>::value && !is_matrix<Structure>::value> {};
+
+
+		/// Allocate zero initialized storage for the elements of a view.
+		template<typename Type>
+		inline std::shared_ptr<std::remove_cv_t<Type>> view_storage(size_t n) {
+
+			using T = std::remove_cv_t<Type>;
+			return std::shared_ptr<T>(new T[n ? n : 1](), std::default_delete<T[]>());
+		}
+	}
+
+
+	/// @class vec_view
+	/// A view over equally spaced elements in memory,
+	/// which may be used wherever a vector is expected.
+	/// A view over constant elements has a const Type.
+	///
+	/// @param Type The type of the elements, possibly const
+	template<typename Type>
+	class vec_view {
+
+		template<typename T>
+		friend class vec_view;
+
+		template<typename T>
+		friend class mat_view;
+
+		private:
+
+			/// Pointer to the first element
+			Type* first {nullptr};
+
+			/// Number of elements
+			unsigned int sz {0};
+
+			/// Distance in memory between consecutive elements
+			std::ptrdiff_t step {1};
+
+			/// Storage owned by the view, if it is not a view
+			/// over memory owned by another container
+			std::shared_ptr<std::remove_cv_t<Type>> storage;
+
+		public:
+
+			/// Construct an unbound view, which allocates
+			/// its own storage when it is resized.
+			vec_view() = default;
+
+
+			/// Construct a view over elements in memory.
+			///
+			/// @param data A pointer to the first element
+			/// @param size The number of elements
+			/// @param stride The distance in memory between
+			/// consecutive elements, defaults to 1
+			vec_view(Type* data, unsigned int size, std::ptrdiff_t stride = 1)
+				: first(data), sz(size), step(stride) {}
+
+
+			/// Construct a view over all the elements of a vector
+			/// stored contiguously, such as vec or std::vector.
+			template<typename Vector, std::enable_if_t<
+				is_vector<Vector>::value
+				&& _internal::has_data_of<Vector, Type>::value, bool> = true>
+			vec_view(Vector& v) : first(v.data()), sz(v.size()), step(1) {}
+
+
+			/// Construct a view over constant elements
+			/// from a view over modifiable elements.
+			template<typename T, std::enable_if_t<
+				!std::is_same<T, Type>::value
+				&& std::is_convertible<T*, Type*>::value, bool> = true>
+			vec_view(const vec_view<T>& other)
+				: first(other.first), sz(other.sz), step(other.step),
+				storage(other.storage) {}
+
+
+			/// Copy a view, referencing the same elements.
+			vec_view(const vec_view& other) = default;
+
+
+			/// Move a view, referencing the same elements.
+			vec_view(vec_view&& other) = default;
+
+
+			/// Copy a view, referencing the same elements.
+			vec_view& operator=(const vec_view& other) = default;
+
+
+			/// Move a view, referencing the same elements.
+			vec_view& operator=(vec_view&& other) = default;
+
+
+			/// Write the elements of a vector into the referenced elements.
+			template<typename Vector, enable_vector<Vector> = true>
+			inline vec_view& operator=(const Vector& other) {
+				return algebra::vec_copy(*this, other);
+			}
+
+
+			/// Access the i-th referenced element.
+			inline Type& operator[](unsigned int i) const {
+				return first[i * step];
+			}
+
+
+			/// Get the number of elements.
+			inline unsigned int size() const {
+				return sz;
+			}
+
+
+			/// Get the distance in memory between consecutive elements.
+			inline std::ptrdiff_t stride() const {
+				return step;
+			}
+
+
+			/// Get a pointer to the first referenced element.
+			inline Type* ptr() const {
+				return first;
+			}
+
+
+			/// Allocate storage for an unbound view, or check that
+			/// the size of a bound view is equal to the given one,
+			/// as views over other memory cannot change size.
+			inline vec_view& resize(unsigned int n) {
+
+				if (first == nullptr && sz == 0) {
+
+					storage = _internal::view_storage<Type>(n);
+					first = storage.get();
+					sz = n;
+					step = 1;
+
+				} else if (n != sz) {
+					TH_MATH_ERROR("vec_view::resize", n, MathError::InvalidArgument);
+					algebra::vec_error(*this);
+				}
+
+				return *this;
+			}
+
+
+			/// Get a view over a strided slice of the view.
+			///
+			/// @param begin The index of the first element of the slice
+			/// @param size The number of elements of the slice
+			/// @param stride The distance between consecutive elements
+			/// of the slice, in units of elements of the view
+			inline vec_view slice(
+				unsigned int begin, unsigned int size, std::ptrdiff_t stride = 1) const {
+
+				vec_view res (first + begin * step, size, stride * step);
+				res.storage = storage;
+				return res;
+			}
+
+
+			/// Sum a vector to the referenced elements.
+			template<typename Vector>
+			inline vec_view& operator+=(const Vector& other) {
+				return algebra::vec_sum(*this, other);
+			}
+
+
+			/// Subtract a vector from the referenced elements.
+			template<typename Vector>
+			inline vec_view& operator-=(const Vector& other) {
+				return algebra::vec_diff(*this, other);
+			}
+
+
+			/// Multiply the referenced elements by a scalar.
+			inline vec_view& operator*=(std::remove_cv_t<Type> scalar) {
+				return algebra::vec_scalmul(scalar, *this);
+			}
+
+
+			/// Divide the referenced elements by a scalar.
+			inline vec_view& operator/=(std::remove_cv_t<Type> scalar) {
+
+				if (abs(scalar) < MACH_EPSILON) {
+					TH_MATH_ERROR("vec_view::operator/=", scalar, MathError::DivByZero);
+					return algebra::vec_error(*this);
+				}
+
+				return algebra::vec_scalmul(1.0 / scalar, *this);
+			}
+
+
+			/// Get an iterator to the first element.
+			inline auto begin() const {
+				return vec_iterator<const vec_view, Type&>(*this, 0);
+			}
+
+
+			/// Get an iterator to one plus the last element.
+			inline auto end() const {
+				return vec_iterator<const vec_view, Type&>(*this, sz);
+			}
+	};
+
+
+	/// @class mat_view
+	/// A view over the elements of a matrix in memory, with arbitrary
+	/// distances between consecutive rows and columns, which may be used
+	/// wherever a matrix is expected. A view over constant elements
+	/// has a const Type.
+	///
+	/// @param Type The type of the elements, possibly const
+	template<typename Type>
+	class mat_view {
+
+		template<typename T>
+		friend class mat_view;
+
+		private:
+
+			/// Pointer to the first element
+			Type* first {nullptr};
+
+			/// Number of rows
+			unsigned int row_sz {0};
+
+			/// Number of columns
+			unsigned int col_sz {0};
+
+			/// Distance in memory between consecutive rows
+			std::ptrdiff_t row_step {0};
+
+			/// Distance in memory between consecutive columns
+			std::ptrdiff_t col_step {0};
+
+			/// Storage owned by the view, if it is not a view
+			/// over memory owned by another container
+			std::shared_ptr<std::remove_cv_t<Type>> storage;
+
+		public:
+
+			/// Construct an unbound view, which allocates
+			/// its own storage when it is resized.
+			mat_view() = default;
+
+
+			/// Construct a view over the elements of a matrix in memory.
+			/// For example, a C-ordered array with n rows and k columns
+			/// has a row stride of k and a column stride of 1.
+			///
+			/// @param data A pointer to the first element
+			/// @param rows The number of rows
+			/// @param cols The number of columns
+			/// @param row_stride The distance in memory between consecutive rows
+			/// @param col_stride The distance in memory between consecutive columns
+			mat_view(
+				Type* data, unsigned int rows, unsigned int cols,
+				std::ptrdiff_t row_stride, std::ptrdiff_t col_stride)
+			: first(data), row_sz(rows), col_sz(cols),
+				row_step(row_stride), col_step(col_stride) {}
+
+
+			/// Construct a view over the elements of a matrix in memory,
+			/// stored contiguously in the same order as mat.
+			///
+			/// @param data A pointer to the first element
+			/// @param rows The number of rows
+			/// @param cols The number of columns
+			mat_view(Type* data, unsigned int rows, unsigned int cols)
+			: first(data), row_sz(rows), col_sz(cols) {
+
+#ifdef THEORETICA_ROW_FIRST
+				row_step = cols;
+				col_step = 1;
+#else
+				row_step = 1;
+				col_step = rows;
+#endif
+			}
+
+
+			/// Construct a view over all the elements of a mat.
+			template<typename Matrix, std::enable_if_t<
+				_internal::is_mat_storage<std::remove_cv_t<Matrix>>::value
+				&& _internal::has_data_of<Matrix, Type>::value, bool> = true>
+			mat_view(Matrix& A) : mat_view(A.data(), A.rows(), A.cols()) {}
+
+
+			/// Construct a view over constant elements
+			/// from a view over modifiable elements.
+			template<typename T, std::enable_if_t<
+				!std::is_same<T, Type>::value
+				&& std::is_convertible<T*, Type*>::value, bool> = true>
+			mat_view(const mat_view<T>& other)
+				: first(other.first), row_sz(other.row_sz), col_sz(other.col_sz),
+				row_step(other.row_step), col_step(other.col_step),
+				storage(other.storage) {}
+
+
+			/// Copy a view, referencing the same elements.
+			mat_view(const mat_view& other) = default;
+
+
+			/// Move a view, referencing the same elements.
+			mat_view(mat_view&& other) = default;
+
+
+			/// Copy a view, referencing the same elements.
+			mat_view& operator=(const mat_view& other) = default;
+
+
+			/// Move a view, referencing the same elements.
+			mat_view& operator=(mat_view&& other) = default;
+
+
+			/// Write the elements of a matrix into the referenced elements.
+			template<typename Matrix, enable_matrix<Matrix> = true>
+			inline mat_view& operator=(const Matrix& other) {
+				return algebra::mat_copy(*this, other);
+			}
+
+
+			/// Access the referenced element at the given row and column.
+			inline Type& operator()(unsigned int i, unsigned int j) const {
+				return first[i * row_step + j * col_step];
+			}
+
+
+			/// Get the number of rows.
+			inline unsigned int rows() const {
+				return row_sz;
+			}
+
+
+			/// Get the number of columns.
+			inline unsigned int cols() const {
+				return col_sz;
+			}
+
+
+			/// Get the total number of elements (rows * columns).
+			inline unsigned int size() const {
+				return row_sz * col_sz;
+			}
+
+
+			/// Get the distance in memory between consecutive rows.
+			inline std::ptrdiff_t row_stride() const {
+				return row_step;
+			}
+
+
+			/// Get the distance in memory between consecutive columns.
+			inline std::ptrdiff_t col_stride() const {
+				return col_step;
+			}
+
+
+			/// Get a pointer to the first referenced element.
+			inline Type* ptr() const {
+				return first;
+			}
+
+
+			/// Allocate storage for an unbound view, or check that
+			/// the size of a bound view is equal to the given one,
+			/// as views over other memory cannot change size.
+			inline mat_view& resize(unsigned int rows, unsigned int cols) {
+
+				if (first == nullptr && row_sz == 0 && col_sz == 0) {
+
+					storage = _internal::view_storage<Type>(size_t(rows) * cols);
+					first = storage.get();
+					row_sz = rows;
+					col_sz = cols;
+
+#ifdef THEORETICA_ROW_FIRST
+					row_step = cols;
+					col_step = 1;
+#else
+					row_step = 1;
+					col_step = rows;
+#endif
+
+				} else if (rows != row_sz) {
+					TH_MATH_ERROR("mat_view::resize", rows, MathError::InvalidArgument);
+					algebra::mat_error(*this);
+				} else if (cols != col_sz) {
+					TH_MATH_ERROR("mat_view::resize", cols, MathError::InvalidArgument);
+					algebra::mat_error(*this);
+				}
+
+				return *this;
+			}
+
+
+			/// Get a view over a block of the matrix.
+			///
+			/// @param i The row of the first element of the block
+			/// @param j The column of the first element of the block
+			/// @param rows The number of rows of the block
+			/// @param cols The number of columns of the block
+			inline mat_view block(
+				unsigned int i, unsigned int j,
+				unsigned int rows, unsigned int cols) const {
+
+				mat_view res (&(*this)(i, j), rows, cols, row_step, col_step);
+				res.storage = storage;
+				return res;
+			}
+
+
+			/// Get a view over the i-th row of the matrix.
+			inline vec_view<Type> row(unsigned int i) const {
+
+				vec_view<Type> res (&(*this)(i, 0), col_sz, col_step);
+				res.storage = storage;
+				return res;
+			}
+
+
+			/// Get a view over the j-th column of the matrix.
+			inline vec_view<Type> col(unsigned int j) const {
+
+				vec_view<Type> res (&(*this)(0, j), row_sz, row_step);
+				res.storage = storage;
+				return res;
+			}
+
+
+			/// Get a view over the diagonal of the matrix.
+			inline vec_view<Type> diagonal() const {
+
+				vec_view<Type> res (
+					first, row_sz < col_sz ? row_sz : col_sz, row_step + col_step);
+				res.storage = storage;
+				return res;
+			}
+
+
+			/// Get a view over the transpose of the matrix.
+			inline mat_view transposed() const {
+
+				mat_view res (first, col_sz, row_sz, col_step, row_step);
+				res.storage = storage;
+				return res;
+			}
+
+
+			/// Sum a matrix to the referenced elements.
+			template<typename Matrix>
+			inline mat_view& operator+=(const Matrix& other) {
+				return algebra::mat_sum(*this, other);
+			}
+
+
+			/// Subtract a matrix from the referenced elements.
+			template<typename Matrix>
+			inline mat_view& operator-=(const Matrix& other) {
+				return algebra::mat_diff(*this, other);
+			}
+
+
+			/// Multiply the referenced elements by a scalar.
+			inline mat_view& operator*=(std::remove_cv_t<Type> scalar) {
+				return algebra::mat_scalmul(scalar, *this);
+			}
+
+
+			/// Divide the referenced elements by a scalar.
+			inline mat_view& operator/=(std::remove_cv_t<Type> scalar) {
+
+				if (abs(scalar) < MACH_EPSILON) {
+					TH_MATH_ERROR("mat_view::operator/=", scalar, MathError::DivByZero);
+					return algebra::mat_error(*this);
+				}
+
+				return algebra::mat_scalmul(1.0 / scalar, *this);
+			}
+
+
+			/// Get an iterator to the first element.
+			inline auto begin() const {
+				return mat_iterator<const mat_view, Type&>(*this, 0, 0);
+			}
+
+
+			/// Get an iterator to one plus the last element.
+			inline auto end() const {
+				return mat_iterator<const mat_view, Type&>(*this, row_sz, 0);
+			}
+	};
+
+
+	namespace algebra {
+
+
+		namespace _internal {
+
+
+			/// Copy the elements referenced by a vector view
+			/// into new storage owned by the returned view.
+			template<typename Type>
+			struct clone_helper<vec_view<Type>> {
+
+				static inline vec_view<Type> clone(const vec_view<Type>& v) {
+
+					vec_view<std::remove_cv_t<Type>> res;
+					vec_copy(res, v);
+					return res;
+				}
+			};
+
+
+			/// Copy the elements referenced by a matrix view
+			/// into new storage owned by the returned view.
+			template<typename Type>
+			struct clone_helper<mat_view<Type>> {
+
+				static inline mat_view<Type> clone(const mat_view<Type>& A) {
+
+					mat_view<std::remove_cv_t<Type>> res;
+					mat_copy(res, A);
+					return res;
+				}
+			};
+		}
+
+
+		/// Get a view over all the elements of a vector stored
+		/// contiguously, such as vec or std::vector.
+		///
+		/// @param v The vector to reference
+		/// @return A view over the elements of the vector
+		template<typename Vector, std::enable_if_t<
+			theoretica::_internal::is_contiguous_vector<Vector>::value, bool> = true>
+		inline auto view(Vector& v) {
+			return vec_view<std::remove_reference_t<decltype(*v.data())>>(v);
+		}
+
+
+		/// Get a view over all the elements of a mat.
+		///
+		/// @param A The matrix to reference
+		/// @return A view over the elements of the matrix
+		template<typename Matrix, std::enable_if_t<
+			theoretica::_internal::is_mat_storage<std::remove_cv_t<Matrix>>::value, bool> = true>
+		inline auto view(Matrix& A) {
+			return mat_view<std::remove_reference_t<decltype(*A.data())>>(A);
+		}
+
+
+		/// Get a view over a block of a mat.
+		///
+		/// @param A The matrix to reference
+		/// @param i The row of the first element of the block
+		/// @param j The column of the first element of the block
+		/// @param rows The number of rows of the block
+		/// @param cols The number of columns of the block
+		/// @return A view over the block
+		template<typename Matrix, std::enable_if_t<
+			theoretica::_internal::is_mat_storage<std::remove_cv_t<Matrix>>::value, bool> = true>
+		inline auto submatrix(
+			Matrix& A, unsigned int i, unsigned int j,
+			unsigned int rows, unsigned int cols) {
+			return view(A).block(i, j, rows, cols);
+		}
+
+
+		/// Get a view over a block of a matrix view.
+		///
+		/// @param A The view to reference
+		/// @param i The row of the first element of the block
+		/// @param j The column of the first element of the block
+		/// @param rows The number of rows of the block
+		/// @param cols The number of columns of the block
+		/// @return A view over the block
+		template<typename Type>
+		inline mat_view<Type> submatrix(
+			const mat_view<Type>& A, unsigned int i, unsigned int j,
+			unsigned int rows, unsigned int cols) {
+			return A.block(i, j, rows, cols);
+		}
+
+
+		/// Get a view over a row of a mat.
+		///
+		/// @param A The matrix to reference
+		/// @param i The index of the row
+		/// @return A view over the row
+		template<typename Matrix, std::enable_if_t<
+			theoretica::_internal::is_mat_storage<std::remove_cv_t<Matrix>>::value, bool> = true>
+		inline auto row(Matrix& A, unsigned int i) {
+			return view(A).row(i);
+		}
+
+
+		/// Get a view over a row of a matrix view.
+		///
+		/// @param A The view to reference
+		/// @param i The index of the row
+		/// @return A view over the row
+		template<typename Type>
+		inline vec_view<Type> row(const mat_view<Type>& A, unsigned int i) {
+			return A.row(i);
+		}
+
+
+		/// Get a view over a column of a mat.
+		///
+		/// @param A The matrix to reference
+		/// @param j The index of the column
+		/// @return A view over the column
+		template<typename Matrix, std::enable_if_t<
+			theoretica::_internal::is_mat_storage<std::remove_cv_t<Matrix>>::value, bool> = true>
+		inline auto col(Matrix& A, unsigned int j) {
+			return view(A).col(j);
+		}
+
+
+		/// Get a view over a column of a matrix view.
+		///
+		/// @param A The view to reference
+		/// @param j The index of the column
+		/// @return A view over the column
+		template<typename Type>
+		inline vec_view<Type> col(const mat_view<Type>& A, unsigned int j) {
+			return A.col(j);
+		}
+
+
+		/// Get a view over a strided slice of a vector
+		/// stored contiguously, such as vec or std::vector.
+		///
+		/// @param v The vector to reference
+		/// @param begin The index of the first element of the slice
+		/// @param size The number of elements of the slice
+		/// @param stride The distance between consecutive elements
+		/// of the slice, defaults to 1
+		/// @return A view over the slice
+		template<typename Vector, std::enable_if_t<
+			theoretica::_internal::is_contiguous_vector<Vector>::value, bool> = true>
+		inline auto slice(
+			Vector& v, unsigned int begin,
+			unsigned int size, std::ptrdiff_t stride = 1) {
+			return view(v).slice(begin, size, stride);
+		}
+
+
+		/// Get a view over a strided slice of a vector view.
+		///
+		/// @param v The view to reference
+		/// @param begin The index of the first element of the slice
+		/// @param size The number of elements of the slice
+		/// @param stride The distance between consecutive elements
+		/// of the slice, defaults to 1
+		/// @return A view over the slice
+		template<typename Type>
+		inline vec_view<Type> slice(
+			const vec_view<Type>& v, unsigned int begin,
+			unsigned int size, std::ptrdiff_t stride = 1) {
+			return v.slice(begin, size, stride);
+		}
+	}
+
+}
+
+#endif
@@ -0,0 +1,311 @@
+///
+/// @file allocator.h Memory allocators for the storage of dynamically
+/// allocated vectors and matrices, such as `vec<Type, 0, Allocator>`
+/// and `mat<Type, 0, 0, Allocator>`. The aligned allocator guarantees
+/// the alignment of the elements for SIMD kernels, while the arena
+/// allocator provides fast scratch memory which is released all at once.
+///
+
+#ifndef THEORETICA_ALLOCATOR_H
+#define THEORETICA_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+#include <type_traits>
+#include "./constants.h"
+
+
+namespace theoretica {
+
+
+	/// @class aligned_allocator
+	/// An allocator which aligns the allocated memory to the given
+	/// boundary, such as the width of SIMD registers or a cache line.
+	/// Memory is obtained from the global `operator new`.
+	///
+	/// @param Type The type of the elements
+	/// @param Alignment The alignment in bytes, which must be a power
+	/// of two, defaults to CORE_ALIGNMENT
+	template<typename Type, size_t Alignment = CORE_ALIGNMENT>
+	class aligned_allocator {
+
+		static_assert(
+			Alignment >= alignof(void*) && (Alignment & (Alignment - 1)) == 0,
+			"The alignment must be a power of two not smaller than a pointer");
+
+	public:
+
+		using value_type = Type;
+
+		/// The alignment in bytes of the allocated memory
+		static constexpr size_t alignment = Alignment;
+
+		template<typename T>
+		struct rebind {
+			using other = aligned_allocator<T, Alignment>;
+		};
+
+
+		/// Construct the allocator
+		aligned_allocator() noexcept = default;
+
+
+		/// Construct the allocator from an allocator of another type
+		template<typename T>
+		aligned_allocator(const aligned_allocator<T, Alignment>&) noexcept {}
+
+
+		/// Allocate memory for the given number of elements.
+		/// The address of the memory block returned by `operator new`
+		/// is stored right before the aligned address.
+		///
+		/// @param n The number of elements
+		/// @return A pointer to the aligned memory
+		inline Type* allocate(size_t n) {
+
+			if (n > (SIZE_MAX - Alignment) / sizeof(Type))
+				throw std::bad_alloc();
+
+			void* raw = ::operator new(n * sizeof(Type) + Alignment);
+
+			const uintptr_t addr = (reinterpret_cast<uintptr_t>(raw) + Alignment)
+				& ~(uintptr_t(Alignment) - 1);
+
+			reinterpret_cast<void**>(addr)[-1] = raw;
+			return reinterpret_cast<Type*>(addr);
+		}
+
+
+		/// Deallocate memory obtained from allocate().
+		///
+		/// @param p A pointer to the aligned memory
+		inline void deallocate(Type* p, size_t) noexcept {
+
+			if (p != nullptr)
+				::operator delete(reinterpret_cast<void**>(p)[-1]);
+		}
+
+
+		/// All aligned allocators with the same alignment are equivalent
+		template<typename T>
+		inline bool operator==(const aligned_allocator<T, Alignment>&) const noexcept {
+			return true;
+		}
+
+
+		/// All aligned allocators with the same alignment are equivalent
+		template<typename T>
+		inline bool operator!=(const aligned_allocator<T, Alignment>&) const noexcept {
+			return false;
+		}
+	};
+
+
+	/// @class arena
+	/// A bump allocator which serves memory from large blocks by advancing
+	/// an offset, so that each allocation costs a few instructions.
+	/// Memory is not released on deallocation but all at once when
+	/// the arena is reset or destroyed, which makes it suited for
+	/// scratch vectors and matrices inside solvers.
+	/// New blocks are allocated when the current one is exhausted.
+	/// An arena must outlive the containers using it and is not thread-safe,
+	/// so that a separate arena should be used for each thread.
+	class arena {
+
+		/// A block of memory owned by the arena
+		struct block {
+			unsigned char* data;
+			size_t size;
+		};
+
+		/// The blocks of memory owned by the arena
+		std::vector<block> blocks;
+
+		/// Index of the block currently in use
+		size_t current {0};
+
+		/// Offset of the first free byte in the current block
+		size_t offset {0};
+
+		/// Minimum size in bytes of new blocks
+		size_t block_size;
+
+	public:
+
+		/// Construct an arena which allocates
+		/// blocks of at least the given size.
+		///
+		/// @param block_size The minimum size in bytes of each block,
+		/// defaults to CORE_ARENA_BLOCK
+		arena(size_t block_size = CORE_ARENA_BLOCK) : block_size(block_size) {}
+
+		arena(const arena&) = delete;
+		arena& operator=(const arena&) = delete;
+
+		/// Release all memory owned by the arena
+		~arena() {
+			release();
+		}
+
+
+		/// Allocate memory with the given size and alignment.
+		///
+		/// @param bytes The number of bytes to allocate
+		/// @param align The alignment in bytes, which must be a power of two
+		/// @return A pointer to the allocated memory
+		inline void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+
+			// Try the current and any following block
+			// which was kept after a reset
+			while (current < blocks.size()) {
+
+				const uintptr_t base = reinterpret_cast<uintptr_t>(blocks[current].data);
+				const size_t start = ((base + offset + align - 1) & ~(uintptr_t(align) - 1)) - base;
+
+				if (start + bytes <= blocks[current].size) {
+					offset = start + bytes;
+					return blocks[current].data + start;
+				}
+
+				current++;
+				offset = 0;
+			}
+
+			// Allocate a new block large enough for the request
+			const size_t size = bytes + align > block_size ? bytes + align : block_size;
+			blocks.push_back({ static_cast<unsigned char*>(::operator new(size)), size });
+			current = blocks.size() - 1;
+			offset = 0;
+
+			return allocate(bytes, align);
+		}
+
+
+		/// Make all memory of the arena available again, keeping
+		/// the blocks for reuse. All containers using the arena
+		/// must have been destroyed or not be used anymore.
+		inline void reset() noexcept {
+			current = 0;
+			offset = 0;
+		}
+
+
+		/// Return all memory of the arena to the system.
+		/// All containers using the arena must have been destroyed
+		/// or not be used anymore.
+		inline void release() noexcept {
+
+			for (const block& b : blocks)
+				::operator delete(b.data);
+
+			blocks.clear();
+			current = 0;
+			offset = 0;
+		}
+
+
+		/// Get the total size in bytes of the blocks owned by the arena
+		inline size_t capacity() const {
+
+			size_t total = 0;
+
+			for (const block& b : blocks)
+				total += b.size;
+
+			return total;
+		}
+	};
+
+
+	/// @class arena_allocator
+	/// An allocator which serves memory from an arena, aligning
+	/// elements to CORE_ALIGNMENT. Deallocation is a no-op, as memory
+	/// is reclaimed by resetting the arena. A default constructed
+	/// allocator is not bound to any arena and uses the global
+	/// `operator new`, so that temporaries created by generic routines
+	/// are still valid.
+	///
+	/// @param Type The type of the elements
+	template<typename Type>
+	class arena_allocator {
+
+		template<typename T>
+		friend class arena_allocator;
+
+		/// The arena to allocate from, or null to use operator new
+		arena* source {nullptr};
+
+	public:
+
+		using value_type = Type;
+
+		/// The alignment in bytes of the memory allocated from an arena
+		static constexpr size_t alignment =
+			alignof(Type) > CORE_ALIGNMENT ? alignof(Type) : CORE_ALIGNMENT;
+
+
+		/// Construct an allocator which uses the global operator new
+		arena_allocator() noexcept = default;
+
+
+		/// Construct an allocator which uses the given arena
+		arena_allocator(arena& a) noexcept : source(&a) {}
+
+
+		/// Construct the allocator from an allocator of another type
+		template<typename T>
+		arena_allocator(const arena_allocator<T>& other) noexcept
+			: source(other.source) {}
+
+
+		/// Allocate memory for the given number of elements.
+		///
+		/// @param n The number of elements
+		/// @return A pointer to the allocated memory
+		inline Type* allocate(size_t n) {
+
+			if (n > SIZE_MAX / sizeof(Type))
+				throw std::bad_alloc();
+
+			if (source == nullptr)
+				return static_cast<Type*>(::operator new(n * sizeof(Type)));
+
+			return static_cast<Type*>(source->allocate(n * sizeof(Type), alignment));
+		}
+
+
+		/// Deallocate memory, which only has an effect
+		/// if the allocator is not bound to an arena.
+		inline void deallocate(Type* p, size_t) noexcept {
+
+			if (source == nullptr)
+				::operator delete(p);
+		}
+
+
+		/// Get the arena used by the allocator,
+		/// or null if it uses the global operator new.
+		inline arena* get_arena() const noexcept {
+			return source;
+		}
+
+
+		/// Two allocators are equal if they use the same arena
+		template<typename T>
+		inline bool operator==(const arena_allocator<T>& other) const noexcept {
+			return source == other.source;
+		}
+
+
+		/// Two allocators are equal if they use the same arena
+		template<typename T>
+		inline bool operator!=(const arena_allocator<T>& other) const noexcept {
+			return source != other.source;
+		}
+	};
+
+}
+
+#endif
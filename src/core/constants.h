@@ -11,6 +11,7 @@
 
 #include <limits>
 #include <cstdint>
+#include <cstddef>
 
 /// THEORETICA_DISABLE_X86 Define this macro to disable Assembly x86 optimizations.
 #ifndef THEORETICA_DISABLE_X86
@@ -30,6 +31,33 @@
 #endif
 
 
+/// THEORETICA_DISABLE_SIMD Define this macro to disable explicit SIMD kernels.
+#ifndef THEORETICA_DISABLE_SIMD
+
+#if !defined(THEORETICA_AVX512) && defined(__AVX512F__)
+/// THEORETICA_AVX512 This macro is automatically defined when compiling
+/// with AVX-512 support (e.g. -mavx512f) to enable AVX-512 kernels.
+/// @see THEORETICA_DISABLE_SIMD
+#define THEORETICA_AVX512
+#endif
+
+#if !defined(THEORETICA_AVX2) && defined(__AVX2__)
+/// THEORETICA_AVX2 This macro is automatically defined when compiling
+/// with AVX2 support (e.g. -mavx2) to enable AVX2 kernels.
+/// @see THEORETICA_DISABLE_SIMD
+#define THEORETICA_AVX2
+#endif
+
+#if !defined(THEORETICA_SSE2) && defined(__SSE2__)
+/// THEORETICA_SSE2 This macro is automatically defined when compiling
+/// with SSE2 support (the default on x86-64) to enable SSE2 kernels.
+/// @see THEORETICA_DISABLE_SIMD
+#define THEORETICA_SSE2
+#endif
+
+#endif
+
+
 /// THEORETICA_DISABLE_CPP20 Define this macro to disable C++20 features.
 #ifndef THEORETICA_DISABLE_CPP20
 #ifndef THEORETICA_HAS_CPP20
@@ -59,11 +87,129 @@
 #endif
 
 
+/// Number of rows of the left operand packed together
+/// by the blocked matrix multiplication kernel
+#ifndef THEORETICA_ALGEBRA_GEMM_MC
+#define THEORETICA_ALGEBRA_GEMM_MC 128
+#endif
+
+/// Number of columns of the left operand (and rows of the right operand)
+/// packed together by the blocked matrix multiplication kernel
+#ifndef THEORETICA_ALGEBRA_GEMM_KC
+#define THEORETICA_ALGEBRA_GEMM_KC 256
+#endif
+
+/// Number of columns of the right operand packed together
+/// by the blocked matrix multiplication kernel
+#ifndef THEORETICA_ALGEBRA_GEMM_NC
+#define THEORETICA_ALGEBRA_GEMM_NC 2048
+#endif
+
+/// Minimum number of scalar multiplications (rows * cols * inner size)
+/// for which matrix products use the blocked kernel
+#ifndef THEORETICA_ALGEBRA_GEMM_THRESHOLD
+#define THEORETICA_ALGEBRA_GEMM_THRESHOLD 32768
+#endif
+
+/// Number of columns factorized together in each panel
+/// of the blocked LU decomposition
+#ifndef THEORETICA_ALGEBRA_LU_BLOCK
+#define THEORETICA_ALGEBRA_LU_BLOCK 64
+#endif
+
+/// Number of columns factorized together in each panel
+/// of the blocked QR decomposition
+#ifndef THEORETICA_ALGEBRA_QR_BLOCK
+#define THEORETICA_ALGEBRA_QR_BLOCK 32
+#endif
+
+/// Relative residual tolerance of Krylov iterative solvers
+#ifndef THEORETICA_ALGEBRA_KRYLOV_TOL
+#define THEORETICA_ALGEBRA_KRYLOV_TOL 1E-10
+#endif
+
+/// Maximum number of iterations of Krylov iterative solvers
+#ifndef THEORETICA_ALGEBRA_KRYLOV_ITER
+#define THEORETICA_ALGEBRA_KRYLOV_ITER 1000
+#endif
+
+/// Number of iterations between restarts of GMRES
+#ifndef THEORETICA_ALGEBRA_GMRES_RESTART
+#define THEORETICA_ALGEBRA_GMRES_RESTART 30
+#endif
+
+/// Maximum number of steps of iterative refinement
+/// of mixed precision solvers
+#ifndef THEORETICA_ALGEBRA_REFINE_ITER
+#define THEORETICA_ALGEBRA_REFINE_ITER 30
+#endif
+
+/// Maximum number of iterations of the matrix square root
+#ifndef THEORETICA_ALGEBRA_SQRTM_ITER
+#define THEORETICA_ALGEBRA_SQRTM_ITER 100
+#endif
+
+/// Number of points in each block of pairwise distance kernels
+#ifndef THEORETICA_ALGEBRA_DISTANCE_BLOCK
+#define THEORETICA_ALGEBRA_DISTANCE_BLOCK 64
+#endif
+
+/// Maximum number of points in a leaf of a k-d tree
+#ifndef THEORETICA_ALGEBRA_KDTREE_LEAF
+#define THEORETICA_ALGEBRA_KDTREE_LEAF 16
+#endif
+
+/// Minimum number of elements inside the band of a banded
+/// matrix for its product with a vector to be computed in parallel
+#ifndef THEORETICA_ALGEBRA_BANDED_PARALLEL_MIN
+#define THEORETICA_ALGEBRA_BANDED_PARALLEL_MIN 65536
+#endif
+
+/// Minimum number of rows of a symmetric packed matrix
+/// for its rank updates to be computed in parallel
+#ifndef THEORETICA_ALGEBRA_PACKED_PARALLEL_MIN
+#define THEORETICA_ALGEBRA_PACKED_PARALLEL_MIN 128
+#endif
+
+/// Minimum size of power of 2 Fast Fourier Transforms
+/// which use the vectorized radix-4 kernel
+#ifndef THEORETICA_SIGNAL_FFT_SOA_MIN
+#define THEORETICA_SIGNAL_FFT_SOA_MIN 1024
+#endif
+
+/// Number of elements of the blocks on which the first stages
+/// of the radix-4 Fast Fourier Transform are computed in cache
+#ifndef THEORETICA_SIGNAL_FFT_BLOCK
+#define THEORETICA_SIGNAL_FFT_BLOCK 4096
+#endif
+
+/// Minimum size of Fast Fourier Transforms computed in parallel
+#ifndef THEORETICA_SIGNAL_FFT_PARALLEL_MIN
+#define THEORETICA_SIGNAL_FFT_PARALLEL_MIN 65536
+#endif
+
+/// Number of lines gathered together by multidimensional
+/// Fast Fourier Transforms along non-contiguous axes
+#ifndef THEORETICA_SIGNAL_FFT_TILE
+#define THEORETICA_SIGNAL_FFT_TILE 16
+#endif
+
+
 /// Order of Taylor series approximations
 #ifndef THEORETICA_CORE_TAYLOR_ORDER
 #define THEORETICA_CORE_TAYLOR_ORDER 12
 #endif
 
+/// Alignment in bytes of memory from aligned and arena allocators
+#ifndef THEORETICA_CORE_ALIGNMENT
+#define THEORETICA_CORE_ALIGNMENT 64
+#endif
+
+/// Minimum size in bytes of the blocks allocated by arenas
+#ifndef THEORETICA_CORE_ARENA_BLOCK
+#define THEORETICA_CORE_ARENA_BLOCK 1048576
+#endif
+
 /// Default number of steps for integral approximation
 #ifndef THEORETICA_CALCULUS_INTEGRAL_STEPS
 #define THEORETICA_CALCULUS_INTEGRAL_STEPS 100
@@ -284,9 +430,77 @@ namespace theoretica {
 	/// Maximum number of iterations for eigensolvers
 	constexpr real ALGEBRA_EIGEN_ITER = THEORETICA_ALGEBRA_EIGEN_ITER;
 
+	/// Row block size of the blocked matrix multiplication kernel
+	constexpr unsigned int ALGEBRA_GEMM_MC = THEORETICA_ALGEBRA_GEMM_MC;
+
+	/// Inner block size of the blocked matrix multiplication kernel
+	constexpr unsigned int ALGEBRA_GEMM_KC = THEORETICA_ALGEBRA_GEMM_KC;
+
+	/// Column block size of the blocked matrix multiplication kernel
+	constexpr unsigned int ALGEBRA_GEMM_NC = THEORETICA_ALGEBRA_GEMM_NC;
+
+	/// Minimum size of a matrix product to use the blocked kernel
+	constexpr uint64_t ALGEBRA_GEMM_THRESHOLD = THEORETICA_ALGEBRA_GEMM_THRESHOLD;
+
+	/// Panel width of the blocked LU decomposition
+	constexpr unsigned int ALGEBRA_LU_BLOCK = THEORETICA_ALGEBRA_LU_BLOCK;
+
+	/// Panel width of the blocked QR decomposition
+	constexpr unsigned int ALGEBRA_QR_BLOCK = THEORETICA_ALGEBRA_QR_BLOCK;
+
+	/// Relative residual tolerance of Krylov iterative solvers
+	constexpr real ALGEBRA_KRYLOV_TOL = THEORETICA_ALGEBRA_KRYLOV_TOL;
+
+	/// Maximum number of iterations of Krylov iterative solvers
+	constexpr unsigned int ALGEBRA_KRYLOV_ITER = THEORETICA_ALGEBRA_KRYLOV_ITER;
+
+	/// Number of iterations between restarts of GMRES
+	constexpr unsigned int ALGEBRA_GMRES_RESTART = THEORETICA_ALGEBRA_GMRES_RESTART;
+
+	/// Maximum number of steps of iterative refinement
+	constexpr unsigned int ALGEBRA_REFINE_ITER = THEORETICA_ALGEBRA_REFINE_ITER;
+
+	/// Maximum number of iterations of the matrix square root
+	constexpr unsigned int ALGEBRA_SQRTM_ITER = THEORETICA_ALGEBRA_SQRTM_ITER;
+
+	/// Number of points in each block of pairwise distance kernels
+	constexpr unsigned int ALGEBRA_DISTANCE_BLOCK = THEORETICA_ALGEBRA_DISTANCE_BLOCK;
+
+	/// Maximum number of points in a leaf of a k-d tree
+	constexpr unsigned int ALGEBRA_KDTREE_LEAF = THEORETICA_ALGEBRA_KDTREE_LEAF;
+
+	/// Minimum number of elements inside the band of a banded
+	/// matrix for its product with a vector to be computed in parallel
+	constexpr unsigned int ALGEBRA_BANDED_PARALLEL_MIN = THEORETICA_ALGEBRA_BANDED_PARALLEL_MIN;
+
+	/// Minimum number of rows of a symmetric packed matrix
+	/// for its rank updates to be computed in parallel
+	constexpr unsigned int ALGEBRA_PACKED_PARALLEL_MIN = THEORETICA_ALGEBRA_PACKED_PARALLEL_MIN;
+
+	/// Minimum size of power of 2 Fast Fourier Transforms
+	/// which use the vectorized radix-4 kernel
+	constexpr unsigned int SIGNAL_FFT_SOA_MIN = THEORETICA_SIGNAL_FFT_SOA_MIN;
+
+	/// Number of elements of the blocks on which the first stages
+	/// of the radix-4 Fast Fourier Transform are computed in cache
+	constexpr unsigned int SIGNAL_FFT_BLOCK = THEORETICA_SIGNAL_FFT_BLOCK;
+
+	/// Minimum size of Fast Fourier Transforms computed in parallel
+	constexpr unsigned int SIGNAL_FFT_PARALLEL_MIN = THEORETICA_SIGNAL_FFT_PARALLEL_MIN;
+
+	/// Number of lines gathered together by multidimensional
+	/// Fast Fourier Transforms along non-contiguous axes
+	constexpr unsigned int SIGNAL_FFT_TILE = THEORETICA_SIGNAL_FFT_TILE;
+
 	/// Order of Taylor series approximations
 	constexpr int CORE_TAYLOR_ORDER = THEORETICA_CORE_TAYLOR_ORDER;
 
+	/// Alignment in bytes of memory from aligned and arena allocators
+	constexpr size_t CORE_ALIGNMENT = THEORETICA_CORE_ALIGNMENT;
+
+	/// Minimum size in bytes of the blocks allocated by arenas
+	constexpr size_t CORE_ARENA_BLOCK = THEORETICA_CORE_ARENA_BLOCK;
+
 	/// Default number of steps for integral approximation
 	constexpr int CALCULUS_INTEGRAL_STEPS = THEORETICA_CALCULUS_INTEGRAL_STEPS;
 
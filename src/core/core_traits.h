@@ -176,6 +176,13 @@ namespace theoretica {
 	using disable_vector = std::enable_if_t<!is_vector<Structure>::value, T>;
 
 
+	// Disable a function overload if the template typename
+	// is considerable a matrix. The std::enable_if structure
+	// is used, with type T which defaults to bool.
+	template<typename Structure, typename T = bool>
+	using disable_matrix = std::enable_if_t<!is_matrix<Structure>::value, T>;
+
+
 	namespace _internal {
 
 		// Helper structure to extract the first type of a variadic template
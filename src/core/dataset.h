@@ -14,6 +14,7 @@
 #include "./core_traits.h"
 #include "./constants.h"
 #include "./error.h"
+#include "./simd.h"
 
 
 namespace theoretica {
@@ -170,6 +171,37 @@ namespace theoretica {
 	}
 
 
+	namespace _internal {
+
+
+		/// Sum the elements of a vector in the given range, as the base
+		/// case of pairwise summation, using SIMD kernels when the vector
+		/// stores its real elements contiguously.
+		template<typename Vector, std::enable_if_t<
+			simd::is_simd_vector<Vector>::value
+			&& std::is_same<std::remove_cv_t<vector_element_t<Vector>>, real>::value, bool> = true>
+		inline real sum_block(const Vector& X, size_t begin, size_t end) {
+			return simd::sum(X.data() + begin, end - begin);
+		}
+
+
+		/// Sum the elements of a vector in the given range, as the base
+		/// case of pairwise summation.
+		template<typename Vector, std::enable_if_t<!(
+			simd::is_simd_vector<Vector>::value
+			&& std::is_same<std::remove_cv_t<vector_element_t<Vector>>, real>::value), bool> = true>
+		inline real sum_block(const Vector& X, size_t begin, size_t end) {
+
+			real sum = 0;
+
+			for (size_t i = begin; i < end; ++i)
+				sum += X[i];
+
+			return sum;
+		}
+	}
+
+
 	/// Compute the sum of a set of values using
 	/// pairwise summation to reduce round-off error.
 	/// The function does not check for validity of begin and end indices.
@@ -191,8 +223,7 @@ namespace theoretica {
 		// Base case with given size (defaults to 128)
 		if((end - begin) <= base_size) {
 
-			for (size_t i = begin; i < end; ++i)
-				sum += X[i];
+			sum = _internal::sum_block(X, begin, end);
 
 		} else {
 
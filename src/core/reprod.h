@@ -7,6 +7,7 @@
 #define THEORETICA_REPROD_H
 
 #include <string>
+#include "./constants.h"
 
 
 namespace theoretica {
@@ -44,6 +45,14 @@ namespace reprod {
         // AVX512 support
         bool has_avx512 {false};
 
+        // SSE2 support
+        bool has_sse2 {false};
+
+        // Width in bits of the registers used by the SIMD kernels,
+        // which determines the summation order of reductions,
+        // or zero if scalar kernels are used
+        unsigned int simd_bits {0};
+
         // CUDA support
         bool has_cuda {false};
 
@@ -63,10 +72,13 @@ namespace reprod {
 
             if (has_avx2) str += "AVX2 ";
             if (has_avx512) str += "AVX512 ";
+            if (has_sse2) str += "SSE2 ";
             if (has_cuda) str += "CUDA ";
             if (has_omp) str += "OpenMP ";
 
             str += "\n";
+            str += "SIMD Kernels: " + (simd_bits ?
+                std::to_string(simd_bits) + " bits" : std::string("scalar")) + "\n";
             //str += "Theoretica Version:  " + lib_version + "\n";
             str += "Build Date: " + build_date + "\n";
             
@@ -155,6 +167,19 @@ namespace reprod {
             env.has_avx512 = true;
         #endif
 
+        #ifdef __SSE2__
+            env.has_sse2 = true;
+        #endif
+
+        // SIMD kernels, as selected in constants.h
+        #if defined(THEORETICA_AVX512)
+            env.simd_bits = 512;
+        #elif defined(THEORETICA_AVX2)
+            env.simd_bits = 256;
+        #elif defined(THEORETICA_SSE2)
+            env.simd_bits = 128;
+        #endif
+
         #ifdef _OPENMP
             env.has_omp = true;
         #endif
@@ -0,0 +1,501 @@
+///
+/// @file simd.h Explicit SIMD kernels for BLAS-1 operations and reductions
+/// over contiguous arrays of `double` or `float`. The instruction set is
+/// selected at compile time from the THEORETICA_AVX512 and THEORETICA_AVX2
+/// macros (see constants.h), which are defined under the same conditions
+/// as the `has_avx512` and `has_avx2` flags of `reprod::environment`,
+/// falling back to THEORETICA_SSE2 on x86-64 targets. The register width
+/// in use, which determines the summation order of reductions, is recorded
+/// in the `simd_bits` field of `reprod::environment`.
+/// A portable scalar implementation is used when none is available.
+///
+
+#ifndef THEORETICA_SIMD_H
+#define THEORETICA_SIMD_H
+
+#include <cstddef>
+#include <type_traits>
+#include "./constants.h"
+#include "./core_traits.h"
+
+#if defined(THEORETICA_AVX512) || defined(THEORETICA_AVX2)
+#include <immintrin.h>
+#elif defined(THEORETICA_SSE2)
+#include <emmintrin.h>
+#endif
+
+
+namespace theoretica {
+
+/// @namespace theoretica::simd Explicit SIMD kernels
+namespace simd {
+
+
+	/// Type trait to check whether explicit SIMD
+	/// kernels are available for the given element type.
+	template<typename Type>
+	struct is_simd_type : std::false_type {};
+
+	template<>
+	struct is_simd_type<double> : std::true_type {};
+
+	template<>
+	struct is_simd_type<float> : std::true_type {};
+
+
+	// Check whether a vector stores its elements contiguously,
+	// by checking that it has a data() method returning a pointer
+	// to its elements, and whether the type of its elements
+	// is supported by the SIMD kernels.
+	template<typename Structure, typename = theoretica::_internal::void_t<>>
+	struct is_simd_vector : std::false_type {};
+
+	template<typename Structure>
+	struct is_simd_vector
+	<Structure, theoretica::_internal::void_t<
+		decltype(std::declval<Structure&>()[0]),
+		decltype(std::declval<Structure&>().data())>
+	> : std::integral_constant<bool,
+		is_simd_type<std::remove_cv_t<vector_element_t<Structure>>>::value
+		&& std::is_same<
+			std::remove_cv_t<std::remove_pointer_t<decltype(std::declval<Structure&>().data())>>,
+			std::remove_cv_t<vector_element_t<Structure>>
+		>::value
+	> {};
+
+
+	// Check whether two vectors are contiguous vectors
+	// with the same type of elements supported by the SIMD kernels.
+	template<typename Vector1, typename Vector2>
+	struct is_simd_pair : std::integral_constant<bool,
+		is_simd_vector<Vector1>::value && is_simd_vector<Vector2>::value
+		&& std::is_same<
+			std::remove_cv_t<vector_element_or_void_t<Vector1>>,
+			std::remove_cv_t<vector_element_or_void_t<Vector2>>
+		>::value
+	> {};
+
+
+	// Enable a function overload if the vectors are contiguous
+	// with the same element type supported by the SIMD kernels.
+	template<typename Vector1, typename Vector2 = Vector1>
+	using enable_simd = std::enable_if_t<is_simd_pair<Vector1, Vector2>::value, bool>;
+
+
+	// Enable a function overload if the vectors are not both
+	// contiguous with the same element type supported by the SIMD kernels.
+	template<typename Vector1, typename Vector2 = Vector1>
+	using disable_simd = std::enable_if_t<!is_simd_pair<Vector1, Vector2>::value, bool>;
+
+
+	namespace _internal {
+
+
+		/// Packed register of the widest instruction set available
+		/// for the given type. The generic implementation holds a single
+		/// element and is used as the scalar fallback.
+		template<typename Type>
+		struct pack {
+
+			using reg = Type;
+			static constexpr size_t width = 1;
+
+			static inline reg load(const Type* p) { return *p; }
+			static inline void store(Type* p, reg a) { *p = a; }
+			static inline reg set1(Type a) { return a; }
+			static inline reg zero() { return Type(0); }
+			static inline reg add(reg a, reg b) { return a + b; }
+			static inline reg sub(reg a, reg b) { return a - b; }
+			static inline reg mul(reg a, reg b) { return a * b; }
+			static inline reg div(reg a, reg b) { return a / b; }
+			static inline reg fmadd(reg a, reg b, reg c) { return a * b + c; }
+			static inline reg abs(reg a) { return a < Type(0) ? -a : a; }
+
+			/// Select x where a > b and y elsewhere
+			static inline reg select_gt(reg a, reg b, reg x, reg y) { return a > b ? x : y; }
+			static inline Type hsum(reg a) { return a; }
+		};
+
+
+#if defined(THEORETICA_AVX512)
+
+		template<>
+		struct pack<double> {
+
+			using reg = __m512d;
+			static constexpr size_t width = 8;
+
+			static inline reg load(const double* p) { return _mm512_loadu_pd(p); }
+			static inline void store(double* p, reg a) { _mm512_storeu_pd(p, a); }
+			static inline reg set1(double a) { return _mm512_set1_pd(a); }
+			static inline reg zero() { return _mm512_setzero_pd(); }
+			static inline reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+			static inline reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+			static inline reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+			static inline reg div(reg a, reg b) { return _mm512_div_pd(a, b); }
+			static inline reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+			static inline reg abs(reg a) { return _mm512_abs_pd(a); }
+
+			static inline reg select_gt(reg a, reg b, reg x, reg y) {
+				return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(a, b, _CMP_GT_OQ), y, x);
+			}
+			static inline double hsum(reg a) { return _mm512_reduce_add_pd(a); }
+		};
+
+
+		template<>
+		struct pack<float> {
+
+			using reg = __m512;
+			static constexpr size_t width = 16;
+
+			static inline reg load(const float* p) { return _mm512_loadu_ps(p); }
+			static inline void store(float* p, reg a) { _mm512_storeu_ps(p, a); }
+			static inline reg set1(float a) { return _mm512_set1_ps(a); }
+			static inline reg zero() { return _mm512_setzero_ps(); }
+			static inline reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+			static inline reg sub(reg a, reg b) { return _mm512_sub_ps(a, b); }
+			static inline reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+			static inline reg div(reg a, reg b) { return _mm512_div_ps(a, b); }
+			static inline reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+			static inline reg abs(reg a) { return _mm512_abs_ps(a); }
+
+			static inline reg select_gt(reg a, reg b, reg x, reg y) {
+				return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, b, _CMP_GT_OQ), y, x);
+			}
+			static inline float hsum(reg a) { return _mm512_reduce_add_ps(a); }
+		};
+
+#elif defined(THEORETICA_AVX2)
+
+		template<>
+		struct pack<double> {
+
+			using reg = __m256d;
+			static constexpr size_t width = 4;
+
+			static inline reg load(const double* p) { return _mm256_loadu_pd(p); }
+			static inline void store(double* p, reg a) { _mm256_storeu_pd(p, a); }
+			static inline reg set1(double a) { return _mm256_set1_pd(a); }
+			static inline reg zero() { return _mm256_setzero_pd(); }
+			static inline reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+			static inline reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+			static inline reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+			static inline reg div(reg a, reg b) { return _mm256_div_pd(a, b); }
+			static inline reg abs(reg a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+
+			static inline reg select_gt(reg a, reg b, reg x, reg y) {
+				return _mm256_blendv_pd(y, x, _mm256_cmp_pd(a, b, _CMP_GT_OQ));
+			}
+
+			static inline reg fmadd(reg a, reg b, reg c) {
+#ifdef __FMA__
+				return _mm256_fmadd_pd(a, b, c);
+#else
+				return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+			}
+
+			static inline double hsum(reg a) {
+				const __m128d s = _mm_add_pd(
+					_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+				return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+			}
+		};
+
+
+		template<>
+		struct pack<float> {
+
+			using reg = __m256;
+			static constexpr size_t width = 8;
+
+			static inline reg load(const float* p) { return _mm256_loadu_ps(p); }
+			static inline void store(float* p, reg a) { _mm256_storeu_ps(p, a); }
+			static inline reg set1(float a) { return _mm256_set1_ps(a); }
+			static inline reg zero() { return _mm256_setzero_ps(); }
+			static inline reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+			static inline reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+			static inline reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+			static inline reg div(reg a, reg b) { return _mm256_div_ps(a, b); }
+			static inline reg abs(reg a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0), a); }
+
+			static inline reg select_gt(reg a, reg b, reg x, reg y) {
+				return _mm256_blendv_ps(y, x, _mm256_cmp_ps(a, b, _CMP_GT_OQ));
+			}
+
+			static inline reg fmadd(reg a, reg b, reg c) {
+#ifdef __FMA__
+				return _mm256_fmadd_ps(a, b, c);
+#else
+				return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+			}
+
+			static inline float hsum(reg a) {
+				__m128 s = _mm_add_ps(
+					_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+				s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+				return _mm_cvtss_f32(_mm_add_ss(s, _mm_movehdup_ps(s)));
+			}
+		};
+
+#elif defined(THEORETICA_SSE2)
+
+		template<>
+		struct pack<double> {
+
+			using reg = __m128d;
+			static constexpr size_t width = 2;
+
+			static inline reg load(const double* p) { return _mm_loadu_pd(p); }
+			static inline void store(double* p, reg a) { _mm_storeu_pd(p, a); }
+			static inline reg set1(double a) { return _mm_set1_pd(a); }
+			static inline reg zero() { return _mm_setzero_pd(); }
+			static inline reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+			static inline reg sub(reg a, reg b) { return _mm_sub_pd(a, b); }
+			static inline reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+			static inline reg div(reg a, reg b) { return _mm_div_pd(a, b); }
+			static inline reg fmadd(reg a, reg b, reg c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+			static inline reg abs(reg a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+
+			static inline reg select_gt(reg a, reg b, reg x, reg y) {
+				const reg m = _mm_cmpgt_pd(a, b);
+				return _mm_or_pd(_mm_and_pd(m, x), _mm_andnot_pd(m, y));
+			}
+
+			static inline double hsum(reg a) {
+				return _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a)));
+			}
+		};
+
+
+		template<>
+		struct pack<float> {
+
+			using reg = __m128;
+			static constexpr size_t width = 4;
+
+			static inline reg load(const float* p) { return _mm_loadu_ps(p); }
+			static inline void store(float* p, reg a) { _mm_storeu_ps(p, a); }
+			static inline reg set1(float a) { return _mm_set1_ps(a); }
+			static inline reg zero() { return _mm_setzero_ps(); }
+			static inline reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+			static inline reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+			static inline reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+			static inline reg div(reg a, reg b) { return _mm_div_ps(a, b); }
+			static inline reg fmadd(reg a, reg b, reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+			static inline reg abs(reg a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+
+			static inline reg select_gt(reg a, reg b, reg x, reg y) {
+				const reg m = _mm_cmpgt_ps(a, b);
+				return _mm_or_ps(_mm_and_ps(m, x), _mm_andnot_ps(m, y));
+			}
+
+			static inline float hsum(reg a) {
+				const reg s = _mm_add_ps(a, _mm_movehl_ps(a, a));
+				return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+			}
+		};
+
+#endif
+
+
+		/// Sum the elements of a short array using four
+		/// independent packed accumulators.
+		template<typename Type>
+		inline Type block_sum(const Type* x, size_t n) {
+
+			using P = pack<Type>;
+			constexpr size_t W = P::width;
+
+			const size_t n4 = n - n % (4 * W);
+			const size_t n1 = n - n % W;
+
+			auto s0 = P::zero(), s1 = P::zero(), s2 = P::zero(), s3 = P::zero();
+			size_t i = 0;
+
+			for (; i < n4; i += 4 * W) {
+				s0 = P::add(s0, P::load(x + i));
+				s1 = P::add(s1, P::load(x + i + W));
+				s2 = P::add(s2, P::load(x + i + 2 * W));
+				s3 = P::add(s3, P::load(x + i + 3 * W));
+			}
+
+			for (; i < n1; i += W)
+				s0 = P::add(s0, P::load(x + i));
+
+			Type sum = P::hsum(P::add(P::add(s0, s1), P::add(s2, s3)));
+
+			for (; i < n; ++i)
+				sum += x[i];
+
+			return sum;
+		}
+
+
+		/// Compute the dot product of two short arrays using
+		/// four independent packed accumulators.
+		template<typename Type>
+		inline Type block_dot(const Type* x, const Type* y, size_t n) {
+
+			using P = pack<Type>;
+			constexpr size_t W = P::width;
+
+			const size_t n4 = n - n % (4 * W);
+			const size_t n1 = n - n % W;
+
+			auto s0 = P::zero(), s1 = P::zero(), s2 = P::zero(), s3 = P::zero();
+			size_t i = 0;
+
+			for (; i < n4; i += 4 * W) {
+				s0 = P::fmadd(P::load(x + i), P::load(y + i), s0);
+				s1 = P::fmadd(P::load(x + i + W), P::load(y + i + W), s1);
+				s2 = P::fmadd(P::load(x + i + 2 * W), P::load(y + i + 2 * W), s2);
+				s3 = P::fmadd(P::load(x + i + 3 * W), P::load(y + i + 3 * W), s3);
+			}
+
+			for (; i < n1; i += W)
+				s0 = P::fmadd(P::load(x + i), P::load(y + i), s0);
+
+			Type sum = P::hsum(P::add(P::add(s0, s1), P::add(s2, s3)));
+
+			for (; i < n; ++i)
+				sum += x[i] * y[i];
+
+			return sum;
+		}
+
+	}
+
+
+	/// Compute the sum of a contiguous array using pairwise summation,
+	/// with the same recursion as sum_pairwise and a packed base case,
+	/// so that the round-off error is of the same order.
+	///
+	/// @param x A pointer to the first element
+	/// @param n The number of elements
+	/// @param base_size The size of the base case, defaults to 128
+	/// @return The sum of the elements
+	template<typename Type>
+	inline Type sum(const Type* x, size_t n, size_t base_size = 128) {
+
+		if (n <= base_size)
+			return _internal::block_sum(x, n);
+
+		const size_t m = n / 2;
+		return sum(x, m, base_size) + sum(x + m, n - m, base_size);
+	}
+
+
+	/// Compute the dot product of two contiguous arrays,
+	/// accumulating partial products pairwise as in simd::sum.
+	///
+	/// @param x A pointer to the first element of the first array
+	/// @param y A pointer to the first element of the second array
+	/// @param n The number of elements
+	/// @param base_size The size of the base case, defaults to 128
+	/// @return The dot product of the two arrays
+	template<typename Type>
+	inline Type dot(const Type* x, const Type* y, size_t n, size_t base_size = 128) {
+
+		if (n <= base_size)
+			return _internal::block_dot(x, y, n);
+
+		const size_t m = n / 2;
+		return dot(x, y, m, base_size) + dot(x + m, y + m, n - m, base_size);
+	}
+
+
+	/// Compute the square of the Euclidean norm of a contiguous array.
+	///
+	/// @param x A pointer to the first element
+	/// @param n The number of elements
+	/// @return The sum of the squares of the elements
+	template<typename Type>
+	inline Type sqr_norm(const Type* x, size_t n) {
+		return dot(x, x, n);
+	}
+
+
+	/// Add a scaled array to another array,
+	/// equivalent to the operation y = a * x + y.
+	///
+	/// @param a The scalar factor
+	/// @param x A pointer to the first element of the array to scale
+	/// @param y A pointer to the first element of the array to overwrite
+	/// @param n The number of elements
+	template<typename Type>
+	inline void axpy(Type a, const Type* x, Type* y, size_t n) {
+
+		using P = _internal::pack<Type>;
+		constexpr size_t W = P::width;
+
+		const size_t n1 = n - n % W;
+		const auto a_p = P::set1(a);
+		size_t i = 0;
+
+		for (; i < n1; i += W)
+			P::store(y + i, P::fmadd(a_p, P::load(x + i), P::load(y + i)));
+
+		for (; i < n; ++i)
+			y[i] += a * x[i];
+	}
+
+
+	/// Scale an array by a scalar, equivalent to the operation y = a * x.
+	/// The two pointers may coincide to scale the array in place.
+	///
+	/// @param a The scalar factor
+	/// @param x A pointer to the first element of the array to scale
+	/// @param y A pointer to the first element of the array to overwrite
+	/// @param n The number of elements
+	template<typename Type>
+	inline void scale(Type a, const Type* x, Type* y, size_t n) {
+
+		using P = _internal::pack<Type>;
+		constexpr size_t W = P::width;
+
+		const size_t n1 = n - n % W;
+		const auto a_p = P::set1(a);
+		size_t i = 0;
+
+		for (; i < n1; i += W)
+			P::store(y + i, P::mul(a_p, P::load(x + i)));
+
+		for (; i < n; ++i)
+			y[i] = a * x[i];
+	}
+
+
+	/// Compute the linear combination of two arrays,
+	/// equivalent to the operation z = a * x + b * y.
+	/// The output pointer may coincide with either input.
+	///
+	/// @param a The first scalar factor
+	/// @param x A pointer to the first element of the first array
+	/// @param b The second scalar factor
+	/// @param y A pointer to the first element of the second array
+	/// @param z A pointer to the first element of the array to overwrite
+	/// @param n The number of elements
+	template<typename Type>
+	inline void lincomb(Type a, const Type* x, Type b, const Type* y, Type* z, size_t n) {
+
+		using P = _internal::pack<Type>;
+		constexpr size_t W = P::width;
+
+		const auto a_p = P::set1(a);
+		const auto b_p = P::set1(b);
+		const size_t n1 = n - n % W;
+		size_t i = 0;
+
+		for (; i < n1; i += W)
+			P::store(z + i, P::fmadd(a_p, P::load(x + i), P::mul(b_p, P::load(y + i))));
+
+		for (; i < n; ++i)
+			z[i] = a * x[i] + b * y[i];
+	}
+
+}}
+
+#endif
@@ -6,8 +6,10 @@
 #ifndef THEORETICA_SPLINES_H
 #define THEORETICA_SPLINES_H
 
+#include <algorithm>
 #include "../core/constants.h"
 #include "../algebra/algebra_types.h"
+#include "../algebra/banded.h"
 
 
 namespace theoretica {
@@ -255,71 +257,40 @@ namespace theoretica {
 			return { spline_node(x[0], y[0], slope, 0, 0) };
 		}
 
-		// Second derivatives at each point
-		std::vector<real> m (n_points);
-
-		// Intervals, reused for diagonal ratios
+		// Intervals h[i] = x[i+1] - x[i]
 		std::vector<real> h (n_nodes);
-		
-		// Compute differences h[i] = x[i+1] - x[i]
+
 		for (size_t i = 0; i < n_nodes; ++i)
 			h[i] = x[i + 1] - x[i];
-		
-		// Natural spline boundary conditions: m[0] = m[n] = 0
-		m[0] = 0;
-		m[n_nodes] = 0;
-		
-		// Solve tridiagonal system using Thomas algorithm
-		// Am = b where m are the second derivatives,
-		// using in-place forward elimination,
-		// h array will store the modified diagonal ratios.
-		
-		// Compute RHS and setup for Thomas algorithm
-		std::vector<real> rhs (n_points);
-		rhs[0] = 0;
-		rhs[n_nodes] = 0;
-		
-		// Build RHS: 6 * [(y[i+1] - y[i]) / h[i] - (y[i] - y[i-1]) / h[i-1]]
+
+		// Second derivatives at each point, with the natural
+		// spline boundary conditions m[0] = m[n] = 0
+		std::vector<real> m (n_points, 0.0);
+
+		// The second derivatives at the inner points solve the
+		// symmetric tridiagonal system with diagonal 2(h[i-1] + h[i]),
+		// off-diagonal h[i] and known terms:
+		// 6 * [(y[i+1] - y[i]) / h[i] - (y[i] - y[i-1]) / h[i-1]]
+		const size_t n_inner = n_points - 2;
+		std::vector<real> diag (n_inner);
+		std::vector<real> off (n_inner - 1);
+		std::vector<real> rhs (n_inner);
+
 		for (size_t i = 1; i < n_nodes; ++i) {
-			rhs[i] = 6.0 * (
+
+			diag[i - 1] = 2.0 * (h[i - 1] + h[i]);
+			rhs[i - 1] = 6.0 * (
 				(y[i + 1] - y[i]) / h[i] -
 				(y[i] - y[i - 1]) / h[i - 1]
 			);
 		}
-		
-		// Forward elimination
 
-		// Tridiagonal matrix has form:
-		// [ 2(h[0]+h[1])	h[1]			0,				...	]
-		// [ h[1]			2(h[1]+h[2])	h[2]				]
-		// [ 0				h[2]			2(h[2]+h[3])		]
-		// [ 0				0				...				...	]
-		
-		// Diagonal elements
-		std::vector<real> diag (n_points);
+		for (size_t i = 1; i < n_inner; ++i)
+			off[i - 1] = h[i];
 
-		// Boundary conditions
-		diag[0] = 1.0;
-		diag[n_nodes] = 1.0;
-		
-		for (size_t i = 1; i < n_nodes; ++i)
-			diag[i] = 2.0 * (h[i - 1] + h[i]);
-		
-		// Forward sweep
-		for (size_t i = 1; i < n_nodes; ++i) {
-			const real ratio = h[i - 1] / diag[i - 1];
-			diag[i] -= ratio * h[i - 1];
-			rhs[i] -= ratio * rhs[i - 1];
-		}
-		
-		// Back substitution
-		for (int i = int(n_nodes) - 1; i >= 0; --i) {
-			
-			if(i < int(n_nodes) - 1)
-				m[i] = (rhs[i] - h[i] * m[i + 1]) / diag[i];
-			else
-				m[i] = rhs[i] / diag[i];
-		}
+		// Solve the system using the Thomas algorithm, with O(n) complexity
+		algebra::solve_tridiagonal_inplace(off, diag, off, rhs);
+		std::copy(rhs.begin(), rhs.end(), m.begin() + 1);
 
 		// Compute spline coefficients from second derivatives
 		// For the interval [x[i], x[i+1]], the spline is:
@@ -347,7 +318,7 @@ namespace theoretica {
 	/// @param p The set of data points as a vector of coordinate pairs (x, y).
 	/// @return A vector of spline nodes representing the cubic spline interpolation.
 	template <typename DataPoints = std::vector<vec2>>
-	inline std::vector<spline_node> splines_cubic(DataPoints p) {
+	inline std::vector<spline_node> splines_cubic(const DataPoints& p) {
 
 		// Wrap a vector of vectors, providing access to a single coordinate as a vector
 		struct accessor {
@@ -401,29 +372,29 @@ namespace theoretica {
 		}
 
 
+		/// Find the node of the interval containing a given point,
+		/// using binary search over the nodes, or the first node
+		/// for points before the first interval (extrapolation).
+		inline const spline_node& node(real x) const {
+
+			auto it = std::upper_bound(nodes.begin(), nodes.end(), x,
+				[](real X, const spline_node& n) { return X < n.x; });
+
+			return (it == nodes.begin()) ? *it : *(it - 1);
+		}
+
+
 		/// Evaluate the natural cubic spline interpolation
 		/// at a given point.
 		inline real operator()(real x) const {
-			
-			for (int i = int(nodes.size()) - 1; i > 0; --i)
-				if(x >= nodes[i].x)
-					return nodes[i](x);
-
-			// Extrapolation for x < x_0
-			return nodes[0](x);
+			return node(x)(x);
 		}
 
 
 		/// Evaluate the derivative of the natural cubic
 		/// spline interpolation at a given point.
 		inline real deriv(real x) const {
-			
-			for (unsigned int i = nodes.size() - 1; i > 0; --i)
-				if(x >= nodes[i].x)
-					return nodes[i].deriv(x);
-
-			// Extrapolation for x < x_0
-			return nodes[0].deriv(x);
+			return node(x).deriv(x);
 		}
 
 
@@ -6,9 +6,12 @@
 #ifndef THEORETICA_FFT_H
 #define THEORETICA_FFT_H
 
+#include <vector>
+#include <cstdint>
 #include "../core/bit_op.h"
 #include "../algebra/algebra_types.h"
 #include "../algebra/algebra.h"
+#include "../algebra/view.h"
 #include "../complex/complex.h"
 
 
@@ -19,8 +22,830 @@ namespace theoretica {
 	namespace signal {
 
 
-		/// Compute the Fast Fourier Transform of a set of data points.
-		/// Bit reversion is used on the indices to simplify the resulting calculations.
+		namespace _internal {
+
+
+			/// Scalar operations with the same interface as
+			/// simd::_internal::pack, used for the elements
+			/// which do not fill a packed register.
+			template<typename Type>
+			struct scalar_pack {
+
+				using reg = Type;
+				static constexpr size_t width = 1;
+
+				static inline reg load(const Type* p) { return *p; }
+				static inline void store(Type* p, reg a) { *p = a; }
+				static inline reg add(reg a, reg b) { return a + b; }
+				static inline reg sub(reg a, reg b) { return a - b; }
+				static inline reg mul(reg a, reg b) { return a * b; }
+				static inline reg fmadd(reg a, reg b, reg c) { return a * b + c; }
+			};
+
+
+			/// Compute the radix-4 butterflies of the elements j0 to j1 of
+			/// a group of four sub-transforms of length h in split storage,
+			/// in bit reversed order, width elements at a time.
+			///
+			/// @param re The real parts of the first sub-transform
+			/// @param im The imaginary parts of the first sub-transform
+			/// @param h The length of the sub-transforms
+			/// @param j0 The first element to compute
+			/// @param j1 One past the last element to compute
+			/// @param tw The twiddle factors of the stage, as the real and
+			/// imaginary parts of \f$w^j\f$, \f$w^{2j}\f$ and \f$w^{3j}\f$
+			/// @param inverse Whether the transform is inverse
+			/// @return The first element which was not computed
+			template<typename P, typename Type>
+			inline unsigned int fft_radix4(
+				Type* re, Type* im, unsigned int h, unsigned int j0,
+				unsigned int j1, const Type* tw, bool inverse) {
+
+				using reg = typename P::reg;
+				constexpr unsigned int W = P::width;
+
+				Type* re1 = re + h;
+				Type* im1 = im + h;
+				Type* re2 = re + 2 * h;
+				Type* im2 = im + 2 * h;
+				Type* re3 = re + 3 * h;
+				Type* im3 = im + 3 * h;
+
+				unsigned int j = j0;
+
+				for (; j + W <= j1; j += W) {
+
+					// The second and third sub-transforms are exchanged
+					// by bit reversion, so their twiddle factors are swapped
+					const reg x1r = P::load(re2 + j), x1i = P::load(im2 + j);
+					const reg x2r = P::load(re1 + j), x2i = P::load(im1 + j);
+					const reg x3r = P::load(re3 + j), x3i = P::load(im3 + j);
+
+					const reg w1r = P::load(tw + j), w1i = P::load(tw + h + j);
+					const reg w2r = P::load(tw + 2 * h + j), w2i = P::load(tw + 3 * h + j);
+					const reg w3r = P::load(tw + 4 * h + j), w3i = P::load(tw + 5 * h + j);
+
+					const reg b0r = P::load(re + j), b0i = P::load(im + j);
+					const reg b1r = P::sub(P::mul(w1r, x1r), P::mul(w1i, x1i));
+					const reg b1i = P::fmadd(w1r, x1i, P::mul(w1i, x1r));
+					const reg b2r = P::sub(P::mul(w2r, x2r), P::mul(w2i, x2i));
+					const reg b2i = P::fmadd(w2r, x2i, P::mul(w2i, x2r));
+					const reg b3r = P::sub(P::mul(w3r, x3r), P::mul(w3i, x3i));
+					const reg b3i = P::fmadd(w3r, x3i, P::mul(w3i, x3r));
+
+					const reg t0r = P::add(b0r, b2r), t0i = P::add(b0i, b2i);
+					const reg t1r = P::sub(b0r, b2r), t1i = P::sub(b0i, b2i);
+					const reg t2r = P::add(b1r, b3r), t2i = P::add(b1i, b3i);
+					const reg t3r = P::sub(b1r, b3r), t3i = P::sub(b1i, b3i);
+
+					P::store(re + j, P::add(t0r, t2r));
+					P::store(im + j, P::add(t0i, t2i));
+					P::store(re2 + j, P::sub(t0r, t2r));
+					P::store(im2 + j, P::sub(t0i, t2i));
+
+					// Multiplication of t3 by the fourth root of unity
+					const reg y1r = P::add(t1r, t3i), y1i = P::sub(t1i, t3r);
+					const reg y3r = P::sub(t1r, t3i), y3i = P::add(t1i, t3r);
+
+					P::store(re1 + j, inverse ? y3r : y1r);
+					P::store(im1 + j, inverse ? y3i : y1i);
+					P::store(re3 + j, inverse ? y1r : y3r);
+					P::store(im3 + j, inverse ? y1i : y3i);
+				}
+
+				return j;
+			}
+		}
+
+
+		/// @class fft_plan
+		/// A precomputed Fast Fourier Transform of a given size and direction,
+		/// to run the same transform many times. All twiddle factors and index
+		/// tables are computed once on construction, each twiddle factor from its
+		/// phase instead of by repeated multiplication, to avoid the accumulation
+		/// of rounding errors. Transforms of any size are supported:
+		/// - Sizes which are powers of 2 use an in-place radix-2 algorithm
+		/// with bit reversion, which does not need any additional memory.
+		/// From SIGNAL_FFT_SOA_MIN elements, when a work buffer is provided,
+		/// a radix-4 algorithm is used instead, on the real and imaginary parts
+		/// stored separately in the work buffer, so that butterflies are
+		/// vectorized with the SIMD kernels of simd.h.
+		/// The first stages are computed on blocks of SIGNAL_FFT_BLOCK elements
+		/// which fit in cache, and from SIGNAL_FFT_PARALLEL_MIN elements
+		/// independent blocks and butterflies are computed in parallel.
+		/// - Sizes whose prime factors are all less than or equal to 7 use
+		/// a mixed-radix Cooley-Tukey algorithm with radices 2, 3, 4, 5 and 7,
+		/// in the Stockham formulation, which alternates between the buffer
+		/// and a work buffer of the same size without reordering the indices.
+		/// - All other sizes use Bluestein's algorithm, which computes
+		/// the transform as a convolution with a chirp, by means of
+		/// power of 2 transforms on a work buffer of size at least 2N - 1.
+		class fft_plan {
+			private:
+
+				/// A stage of the mixed-radix algorithm
+				struct fft_stage {
+
+					/// The radix of the stage
+					unsigned int radix;
+
+					/// The length of the sub-transforms
+					/// computed by the previous stages
+					unsigned int length;
+
+					/// The index of the first twiddle factor of the stage
+					unsigned int offset;
+				};
+
+				/// The size of the transform
+				unsigned int N {0};
+
+				/// Whether the plan computes the inverse transform
+				bool inverse {false};
+
+				/// The twiddle factors of all radix-2 stages, with the m / 2
+				/// factors of the stage of length m starting at index m / 2 - 1
+				std::vector<complex<real>> twiddles;
+
+				/// The pairs of indices to exchange by bit reversion,
+				/// stored consecutively
+				std::vector<unsigned int> swaps;
+
+				/// The stages of the mixed-radix algorithm
+				std::vector<fft_stage> stages;
+
+				/// The twiddle factors of the mixed-radix stages, each followed
+				/// by the roots of unity of the order of its radix
+				std::vector<complex<real>> stage_twiddles;
+
+				/// The size of the power of 2 transforms of Bluestein's
+				/// algorithm, or zero if the algorithm is not used
+				unsigned int bluestein_size {0};
+
+				/// The twiddle factors of the radix-4 stages, with the real and
+				/// imaginary parts of \f$w^j\f$, \f$w^{2j}\f$ and \f$w^{3j}\f$
+				/// of the stage of length 4h starting at index 2 (h - h_0)
+				std::vector<real> radix4_twiddles;
+
+				/// The length h_0 of the sub-transforms of the first
+				/// radix-4 stage, equal to 2 if the first stage is radix-2
+				unsigned int radix4_first {0};
+
+				/// The chirp of Bluestein's algorithm
+				std::vector<complex<real>> chirp;
+
+				/// The transform of the conjugate chirp, normalized
+				std::vector<complex<real>> chirp_fft;
+
+
+				/// Compute the twiddle factors and the bit reversion
+				/// table of a power of 2 transform of size M.
+				inline void plan_radix2(unsigned int M, real sign) {
+
+					twiddles.clear();
+					swaps.clear();
+
+					if (M < 2)
+						return;
+
+					// Twiddle factors of the last stage, computing the first
+					// eighth of the circle and obtaining the rest by symmetry
+					twiddles.resize(M - 1);
+					complex<real>* w_M = &twiddles[M / 2 - 1];
+					const unsigned int quarter = max(M / 4, 1u);
+					const unsigned int eighth = (M >= 8) ? (M / 8 + 1) : quarter;
+
+					for (unsigned int j = 0; j < eighth; ++j) {
+
+						const real theta = sign * 2 * PI * j / M;
+						w_M[j] = complex<real>(cos(theta), sin(theta));
+					}
+
+					// Reflection around the bisector of the first quadrant
+					for (unsigned int j = eighth; j < quarter; ++j) {
+
+						const complex<real> w = w_M[quarter - j];
+						w_M[j] = complex<real>(sign * w.b, sign * w.a);
+					}
+
+					// Rotation by a quarter of the circle
+					for (unsigned int j = quarter; j < M / 2; ++j) {
+
+						const complex<real> w = w_M[j - quarter];
+						w_M[j] = complex<real>(-sign * w.b, sign * w.a);
+					}
+
+					// The twiddle factors of the other stages
+					// are a subset of those of the last stage
+					for (unsigned int m = 2; m < M; m <<= 1) {
+
+						complex<real>* w = &twiddles[m / 2 - 1];
+
+						for (unsigned int j = 0; j < m / 2; ++j)
+							w[j] = w_M[j * (M / m)];
+					}
+
+					// Pairs of indices related by bit reversion,
+					// incrementing the reversed index j together with i
+					swaps.reserve(M);
+
+					for (unsigned int i = 0, j = 0; i < M; ++i) {
+
+						if (j > i) {
+							swaps.push_back(i);
+							swaps.push_back(j);
+						}
+
+						unsigned int bit = M >> 1;
+
+						while (j & bit) {
+							j ^= bit;
+							bit >>= 1;
+						}
+
+						j |= bit;
+					}
+				}
+
+
+				/// Compute the twiddle factors of the radix-4 stages of
+				/// a power of 2 transform, from those of the radix-2 stages.
+				inline void plan_radix4() {
+
+					const complex<real>* w_N = &twiddles[N / 2 - 1];
+					radix4_first = (ilog2(N) % 2) ? 2 : 1;
+					radix4_twiddles.clear();
+
+					for (unsigned int h = radix4_first; 4 * h <= N; h *= 4) {
+
+						const unsigned int offset = radix4_twiddles.size();
+						const unsigned int step = N / (4 * h);
+						radix4_twiddles.resize(offset + 6 * h);
+						real* tw = &radix4_twiddles[offset];
+
+						for (unsigned int j = 0; j < h; ++j) {
+							for (unsigned int r = 1; r <= 3; ++r) {
+
+								// The second half of the circle is opposite to the first
+								const unsigned int k = r * j * step;
+								const complex<real> w = (k < N / 2) ? w_N[k] : -w_N[k - N / 2];
+
+								tw[(2 * r - 2) * h + j] = w.a;
+								tw[(2 * r - 1) * h + j] = w.b;
+							}
+						}
+					}
+				}
+
+
+				/// Compute the stages of the mixed-radix algorithm,
+				/// returning false if the size has a prime factor greater than 7.
+				inline bool plan_mixed(real sign) {
+
+					std::vector<unsigned int> radices;
+					unsigned int n = N;
+
+					while (n % 4 == 0) {
+						radices.push_back(4);
+						n /= 4;
+					}
+
+					for (unsigned int p : {2, 3, 5, 7}) {
+						while (n % p == 0) {
+							radices.push_back(p);
+							n /= p;
+						}
+					}
+
+					if (n != 1)
+						return false;
+
+					unsigned int length = 1;
+					unsigned int offset = 0;
+
+					for (unsigned int p : radices) {
+
+						stages.push_back({p, length, offset});
+						offset += (p - 1) * length + p;
+						length *= p;
+					}
+
+					stage_twiddles.resize(offset);
+
+					for (const fft_stage& st : stages) {
+
+						const unsigned int p = st.radix;
+						const unsigned int L = st.length * p;
+						complex<real>* w = &stage_twiddles[st.offset];
+
+						// Twiddle factors of the k-th element of the q-th sub-transform
+						for (unsigned int k = 0; k < st.length; ++k) {
+							for (unsigned int q = 1; q < p; ++q) {
+
+								const real theta = sign * 2 * PI * ((q * k) % L) / L;
+								w[k * (p - 1) + q - 1] = complex<real>(cos(theta), sin(theta));
+							}
+						}
+
+						// Roots of unity of order p
+						complex<real>* roots = w + (p - 1) * st.length;
+
+						for (unsigned int j = 0; j < p; ++j) {
+
+							const real theta = sign * 2 * PI * j / p;
+							roots[j] = complex<real>(cos(theta), sin(theta));
+						}
+					}
+
+					return true;
+				}
+
+
+				/// Compute the chirp and the power of 2 transforms
+				/// needed by Bluestein's algorithm.
+				inline void plan_bluestein(real sign) {
+
+					unsigned int M = 1;
+
+					while (M < 2 * N - 1)
+						M <<= 1;
+
+					bluestein_size = M;
+					plan_radix2(M, -1.0);
+
+					// The exponent n^2 / N is reduced modulo 2
+					// to keep the phase accurate for large n
+					chirp.resize(N);
+
+					for (unsigned int n = 0; n < N; ++n) {
+
+						const uint64_t n2 = (uint64_t(n) * n) % (2 * uint64_t(N));
+						const real theta = sign * PI * n2 / N;
+						chirp[n] = complex<real>(cos(theta), sin(theta));
+					}
+
+					// Transform of the conjugate chirp, wrapped
+					// around the buffer for negative indices
+					chirp_fft.assign(M, complex<real>(0.0, 0.0));
+					chirp_fft[0] = chirp[0].conjugate();
+
+					for (unsigned int n = 1; n < N; ++n) {
+						chirp_fft[n] = chirp[n].conjugate();
+						chirp_fft[M - n] = chirp[n].conjugate();
+					}
+
+					radix2(chirp_fft, M);
+
+					const real norm = 1.0 / M;
+
+					for (unsigned int j = 0; j < M; ++j)
+						chirp_fft[j] *= norm;
+				}
+
+
+				/// Compute a power of 2 transform of size M in place.
+				template<typename Vector>
+				inline void radix2(Vector& x, unsigned int M) const {
+
+					for (unsigned int s = 0; s < swaps.size(); s += 2)
+						std::swap(x[swaps[s]], x[swaps[s + 1]]);
+
+					for (unsigned int m = 2; m <= M; m <<= 1) {
+
+						const unsigned int offset = m / 2;
+						const complex<real>* w = &twiddles[offset - 1];
+
+						for (unsigned int i = 0; i < M; i += m) {
+
+							for (unsigned int j = 0; j < offset; ++j) {
+
+								const complex<real> t = w[j] * x[i + j + offset];
+								x[i + j + offset] = x[i + j] - t;
+								x[i + j] += t;
+							}
+						}
+					}
+				}
+
+
+				/// Compute a radix-4 stage over n elements in split storage,
+				/// combining sub-transforms of length h, optionally in parallel.
+				inline void radix4_stage(
+					real* re, real* im, unsigned int n, unsigned int h, bool parallel) const {
+
+					using P = simd::_internal::pack<real>;
+
+					const real* tw = &radix4_twiddles[2 * (h - radix4_first)];
+					const unsigned int chunk = min(h, 256u);
+					const unsigned int chunks = h / chunk;
+					const unsigned int total = (n / (4 * h)) * chunks;
+
+					// Each group of butterflies is divided in chunks
+					// to balance the work of the last stages between threads
+					#pragma omp parallel for if(parallel)
+					for (unsigned int c = 0; c < total; ++c) {
+
+						const unsigned int g = c / chunks;
+						const unsigned int j0 = (c % chunks) * chunk;
+
+						unsigned int j = _internal::fft_radix4<P>(
+							re + 4 * h * g, im + 4 * h * g, h, j0, j0 + chunk, tw, inverse);
+
+						_internal::fft_radix4<_internal::scalar_pack<real>>(
+							re + 4 * h * g, im + 4 * h * g, h, j, j0 + chunk, tw, inverse);
+					}
+				}
+
+
+				/// Compute a power of 2 transform with the radix-4 algorithm,
+				/// on the real and imaginary parts stored separately in the
+				/// work buffer, which must be contiguous.
+				template<typename Vector, typename Buffer>
+				inline void radix4(Vector& x, Buffer& work) const {
+
+					static_assert(sizeof(complex<real>) == 2 * sizeof(real),
+						"Complex numbers must be stored as two consecutive real numbers");
+
+					real* re = reinterpret_cast<real*>(&work[0]);
+					real* im = re + N;
+
+					for (unsigned int i = 0; i < N; ++i) {
+						re[i] = x[i].a;
+						im[i] = x[i].b;
+					}
+
+					for (unsigned int s = 0; s < swaps.size(); s += 2) {
+						std::swap(re[swaps[s]], re[swaps[s + 1]]);
+						std::swap(im[swaps[s]], im[swaps[s + 1]]);
+					}
+
+					// The first stages are computed block by block in cache
+					const unsigned int block = min(N, SIGNAL_FFT_BLOCK);
+					const bool parallel = (N >= SIGNAL_FFT_PARALLEL_MIN);
+
+					#pragma omp parallel for if(parallel)
+					for (unsigned int b = 0; b < N / block; ++b) {
+
+						real* re_b = re + b * block;
+						real* im_b = im + b * block;
+
+						if (radix4_first == 2) {
+
+							for (unsigned int i = 0; i < block; i += 2) {
+
+								const real r = re_b[i + 1];
+								const real s = im_b[i + 1];
+								re_b[i + 1] = re_b[i] - r;
+								im_b[i + 1] = im_b[i] - s;
+								re_b[i] += r;
+								im_b[i] += s;
+							}
+						}
+
+						for (unsigned int h = radix4_first; 4 * h <= block; h *= 4)
+							radix4_stage(re_b, im_b, block, h, false);
+					}
+
+					// The last stages are computed over the whole buffer
+					unsigned int h = radix4_first;
+
+					while (4 * h <= block)
+						h *= 4;
+
+					for (; 4 * h <= N; h *= 4)
+						radix4_stage(re, im, N, h, parallel);
+
+					for (unsigned int i = 0; i < N; ++i)
+						x[i] = complex<real>(re[i], im[i]);
+				}
+
+
+				/// Compute a stage of the mixed-radix algorithm, combining p
+				/// sub-transforms of the given length from the input buffer
+				/// into transforms p times longer in the output buffer.
+				template<typename InputBuffer, typename OutputBuffer>
+				inline void mixed_stage(
+					const fft_stage& st, const InputBuffer& in, OutputBuffer& out) const {
+
+					const unsigned int p = st.radix;
+					const unsigned int L = st.length;
+					const unsigned int m = N / L;
+					const unsigned int s = m / p;
+					const real sign = (inverse ? 1.0 : -1.0);
+
+					const complex<real>* tw = &stage_twiddles[st.offset];
+					const complex<real>* roots = tw + (p - 1) * L;
+
+					complex<real> a[7];
+					complex<real> b[7];
+
+					for (unsigned int k = 0; k < L; ++k) {
+
+						const complex<real>* w = tw + k * (p - 1);
+
+						for (unsigned int r = 0; r < s; ++r) {
+
+							a[0] = in[r + m * k];
+
+							for (unsigned int q = 1; q < p; ++q)
+								a[q] = w[q - 1] * in[r + s * q + m * k];
+
+							switch (p) {
+
+								case 2:
+									b[0] = a[0] + a[1];
+									b[1] = a[0] - a[1];
+									break;
+
+								case 3: {
+									const complex<real> t1 = a[1] + a[2];
+									const complex<real> t2 = a[0] - t1 * 0.5;
+									const complex<real> d = (a[1] - a[2]) * (sign * SQRT3 * 0.5);
+									const complex<real> t3 = complex<real>(-d.b, d.a);
+									b[0] = a[0] + t1;
+									b[1] = t2 + t3;
+									b[2] = t2 - t3;
+									break;
+								}
+
+								case 4: {
+									const complex<real> t1 = a[0] + a[2];
+									const complex<real> t2 = a[0] - a[2];
+									const complex<real> t3 = a[1] + a[3];
+									const complex<real> d = a[1] - a[3];
+									const complex<real> t4 = complex<real>(-sign * d.b, sign * d.a);
+									b[0] = t1 + t3;
+									b[1] = t2 + t4;
+									b[2] = t1 - t3;
+									b[3] = t2 - t4;
+									break;
+								}
+
+								case 5: {
+									const complex<real> t1 = a[1] + a[4];
+									const complex<real> t2 = a[2] + a[3];
+									const complex<real> t3 = a[1] - a[4];
+									const complex<real> t4 = a[2] - a[3];
+									const complex<real> r1 = a[0] + t1 * roots[1].a + t2 * roots[2].a;
+									const complex<real> r2 = a[0] + t1 * roots[2].a + t2 * roots[1].a;
+									const complex<real> d1 = t3 * roots[1].b + t4 * roots[2].b;
+									const complex<real> d2 = t3 * roots[2].b - t4 * roots[1].b;
+									const complex<real> i1 = complex<real>(-d1.b, d1.a);
+									const complex<real> i2 = complex<real>(-d2.b, d2.a);
+									b[0] = a[0] + t1 + t2;
+									b[1] = r1 + i1;
+									b[2] = r2 + i2;
+									b[3] = r2 - i2;
+									b[4] = r1 - i1;
+									break;
+								}
+
+								default:
+									for (unsigned int u = 0; u < p; ++u) {
+
+										b[u] = a[0];
+
+										for (unsigned int q = 1; q < p; ++q)
+											b[u] += roots[(q * u) % p] * a[q];
+									}
+									break;
+							}
+
+							for (unsigned int u = 0; u < p; ++u)
+								out[r + s * (k + L * u)] = b[u];
+						}
+					}
+				}
+
+
+				/// Compute a transform with the mixed-radix algorithm,
+				/// alternating between the buffer and the work buffer.
+				template<typename Vector, typename Buffer>
+				inline void mixed(Vector& x, Buffer& work) const {
+
+					bool in_x = true;
+
+					for (const fft_stage& st : stages) {
+
+						if (in_x)
+							mixed_stage(st, x, work);
+						else
+							mixed_stage(st, work, x);
+
+						in_x = !in_x;
+					}
+
+					if (!in_x)
+						for (unsigned int i = 0; i < N; ++i)
+							x[i] = work[i];
+				}
+
+
+				/// Compute a transform with Bluestein's algorithm, as the
+				/// convolution of the input, multiplied by the chirp,
+				/// with the conjugate chirp.
+				template<typename Vector, typename Buffer>
+				inline void bluestein(Vector& x, Buffer& work) const {
+
+					const unsigned int M = bluestein_size;
+
+					for (unsigned int n = 0; n < N; ++n)
+						work[n] = x[n] * chirp[n];
+
+					for (unsigned int n = N; n < M; ++n)
+						work[n] = complex<real>(0.0, 0.0);
+
+					radix2(work, M);
+
+					// The inverse transform is computed as the
+					// conjugate of the transform of the conjugate
+					for (unsigned int j = 0; j < M; ++j)
+						work[j] = (work[j] * chirp_fft[j]).conjugate();
+
+					radix2(work, M);
+
+					for (unsigned int k = 0; k < N; ++k)
+						x[k] = chirp[k] * work[k].conjugate();
+				}
+
+
+				/// Normalize the result of an inverse transform by 1/N.
+				template<typename Vector>
+				inline Vector& normalize(Vector& x) const {
+
+					if (inverse) {
+
+						const real norm = 1.0 / N;
+
+						for (unsigned int i = 0; i < N; ++i)
+							x[i] *= norm;
+					}
+
+					return x;
+				}
+
+
+			public:
+
+				/// Construct an empty plan
+				fft_plan() {}
+
+
+				/// Construct a plan for transforms of the given size.
+				///
+				/// @param N The size of the transform
+				/// @param inverse Whether to compute the inverse transform
+				/// (defaults to false)
+				fft_plan(unsigned int N, bool inverse = false) {
+					plan(N, inverse);
+				}
+
+
+				/// Compute the tables of a transform of the given size,
+				/// discarding any previous content.
+				///
+				/// @param N The size of the transform
+				/// @param inverse Whether to compute the inverse transform
+				/// (defaults to false)
+				/// @return A reference to the plan
+				inline fft_plan& plan(unsigned int N, bool inverse = false) {
+
+					this->N = 0;
+					this->inverse = inverse;
+					twiddles.clear();
+					swaps.clear();
+					stages.clear();
+					stage_twiddles.clear();
+					bluestein_size = 0;
+					radix4_twiddles.clear();
+					radix4_first = 0;
+					chirp.clear();
+					chirp_fft.clear();
+
+					if (N == 0) {
+						TH_MATH_ERROR("fft_plan::plan", N, MathError::InvalidArgument);
+						return *this;
+					}
+
+					this->N = N;
+					const real sign = (inverse ? 1.0 : -1.0);
+
+					if ((N & (N - 1)) == 0) {
+
+						plan_radix2(N, sign);
+
+						if (N >= SIGNAL_FFT_SOA_MIN)
+							plan_radix4();
+
+					} else if (!plan_mixed(sign)) {
+						plan_bluestein(sign);
+					}
+
+					return *this;
+				}
+
+
+				/// Transform a buffer in place, using the given work buffer
+				/// if work_size() is not zero. No memory is allocated.
+				///
+				/// @param x The buffer to transform, of the same size as the plan
+				/// @param work A contiguous buffer of complex numbers with at
+				/// least work_size() elements, whose content is overwritten
+				/// @return A reference to the transformed buffer
+				template<typename Vector, typename Buffer, enable_vector<Vector> = true>
+				inline Vector& execute(Vector& x, Buffer& work) const {
+
+					if (x.size() != N || N == 0) {
+						TH_MATH_ERROR("fft_plan::execute", x.size(), MathError::InvalidArgument);
+						return algebra::vec_error(x);
+					}
+
+					if (work.size() < work_size()) {
+						TH_MATH_ERROR("fft_plan::execute", work.size(), MathError::InvalidArgument);
+						return algebra::vec_error(x);
+					}
+
+					if (bluestein_size)
+						bluestein(x, work);
+					else if (stages.size())
+						mixed(x, work);
+					else if (radix4_first)
+						radix4(x, work);
+					else
+						radix2(x, N);
+
+					return normalize(x);
+				}
+
+
+				/// Transform a buffer in place. Sizes which are powers of 2
+				/// do not allocate any memory, using the in-place radix-2 algorithm
+				/// at all sizes, while other sizes allocate a work buffer of
+				/// work_size() elements on each call. Providing a work buffer
+				/// avoids the allocation and enables the radix-4 algorithm.
+				///
+				/// @param x The buffer to transform, of the same size as the plan
+				/// @return A reference to the transformed buffer
+				template<typename Vector, enable_vector<Vector> = true>
+				inline Vector& execute(Vector& x) const {
+
+					if (stages.size() || bluestein_size) {
+						std::vector<complex<real>> work (work_size());
+						return execute(x, work);
+					}
+
+					if (x.size() != N || N == 0) {
+						TH_MATH_ERROR("fft_plan::execute", x.size(), MathError::InvalidArgument);
+						return algebra::vec_error(x);
+					}
+
+					radix2(x, N);
+					return normalize(x);
+				}
+
+
+				/// Compute the transform of a set of data points,
+				/// returning the result in a new vector.
+				///
+				/// @param x The set of data points
+				/// @return The transformed data
+				template<typename ReturnVector = cvec, typename InputVector = cvec>
+				inline ReturnVector operator()(const InputVector& x) const {
+
+					ReturnVector k = x;
+					std::vector<complex<real>> work (work_size());
+
+					return execute(k, work);
+				}
+
+
+				/// Get the size of the transform
+				inline unsigned int size() const {
+					return N;
+				}
+
+
+				/// Get the number of elements of the work buffer
+				/// needed to execute the plan
+				inline unsigned int work_size() const {
+
+					if (bluestein_size)
+						return bluestein_size;
+
+					return (stages.size() || radix4_first) ? N : 0;
+				}
+
+
+				/// Get whether the plan computes the inverse transform
+				inline bool is_inverse() const {
+					return inverse;
+				}
+		};
+
+
+		/// Compute the Fast Fourier Transform of a set of data points
+		/// of any size. To repeat transforms of the same size,
+		/// construct an fft_plan instead.
 		///
 		/// @param x The set of data points in the time domain
 		/// @param inverse Whether to run the inverse transform (defaults to false)
@@ -35,62 +860,489 @@ namespace theoretica {
 
 			// Resulting vector in the frequency domain
 			ReturnVector k = x;
-			const unsigned int N = x.size();
-			const real sign = (inverse ? 1.0 : -1.0);
 
-			// Compute the logarithm of the size
-			const unsigned int log2N = ilog2(N);
+			const fft_plan plan (x.size(), inverse);
+			std::vector<complex<real>> work (plan.work_size());
+
+			return plan.execute(k, work);
+		}
+
+
+		/// Compute the Inverse Fast Fourier Transform of a set of data points
+		/// of any size.
+		///
+		/// @param k The set of data points in the frequency domain
+		/// @return The data in the time domain
+		template<typename ReturnVector = cvec, typename InputVector = cvec>
+		inline ReturnVector ifft(const InputVector& k) {
+			return fft(k, true);
+		}
+
+
+		/// @class rfft_plan
+		/// A precomputed Fast Fourier Transform of real data of a given size,
+		/// which computes the N / 2 + 1 non-redundant elements of the spectrum,
+		/// the others being their complex conjugates. For even sizes, the even
+		/// and odd elements of the data are packed into the real and imaginary
+		/// parts of a complex sequence of size N / 2, whose transform is computed
+		/// in the memory of the result and then separated into the spectrum, roughly
+		/// halving time and memory with respect to a complex transform. Odd sizes
+		/// use a complex transform of size N on a temporary buffer.
+		class rfft_plan {
+			private:
+
+				/// The size of the real data
+				unsigned int N {0};
+
+				/// The complex transform of size N / 2,
+				/// or of size N for odd sizes
+				fft_plan plan;
+
+				/// The twiddle factors \f$e^{-2 \pi i k / N}\f$
+				/// used to separate the packed transform
+				std::vector<complex<real>> twiddles;
+
+			public:
+
+				/// Construct an empty plan
+				rfft_plan() {}
+
+
+				/// Construct a plan for real data of the given size.
+				///
+				/// @param N The size of the real data
+				rfft_plan(unsigned int N) : N(N) {
+
+					if (N == 0) {
+						TH_MATH_ERROR("rfft_plan", N, MathError::InvalidArgument);
+						return;
+					}
+
+					if (N % 2) {
+						plan = fft_plan(N);
+						return;
+					}
+
+					const unsigned int M = N / 2;
+					plan = fft_plan(M);
+					twiddles.resize(M / 2 + 1);
+
+					for (unsigned int k = 0; k <= M / 2; ++k) {
+
+						const real theta = -2 * PI * k / N;
+						twiddles[k] = complex<real>(cos(theta), sin(theta));
+					}
+				}
+
+
+				/// Compute the non-redundant elements of the transform
+				/// of real data. The result must be stored contiguously.
+				///
+				/// @param x The real data, with size() elements
+				/// @param X The vector to write the N / 2 + 1 elements
+				/// of the spectrum to, already of that size
+				/// @return A reference to the spectrum
+				template<typename RealVector, typename ComplexVector>
+				inline ComplexVector& forward(const RealVector& x, ComplexVector& X) const {
+
+					if (x.size() != N || N == 0) {
+						TH_MATH_ERROR("rfft_plan::forward", x.size(), MathError::InvalidArgument);
+						return algebra::vec_error(X);
+					}
+
+					if (X.size() != N / 2 + 1) {
+						TH_MATH_ERROR("rfft_plan::forward", X.size(), MathError::InvalidArgument);
+						return algebra::vec_error(X);
+					}
+
+					if (N % 2) {
+
+						std::vector<complex<real>> z (N);
+
+						for (unsigned int i = 0; i < N; ++i)
+							z[i] = complex<real>(x[i], 0.0);
+
+						plan.execute(z);
+
+						for (unsigned int k = 0; k <= N / 2; ++k)
+							X[k] = z[k];
+
+						return X;
+					}
+
+					// Pack even and odd elements and transform
+					// them in the memory of the result
+					const unsigned int M = N / 2;
+					vec_view<complex<real>> Z (&X[0], M);
+
+					for (unsigned int n = 0; n < M; ++n)
+						Z[n] = complex<real>(x[2 * n], x[2 * n + 1]);
+
+					plan.execute(Z);
+
+					// Separate the transforms of the even and odd elements,
+					// two elements at a time, as X_k depends on Z_k and Z_{M-k}
+					const complex<real> Z0 = Z[0];
+					X[0] = complex<real>(Z0.a + Z0.b, 0.0);
+					X[M] = complex<real>(Z0.a - Z0.b, 0.0);
+
+					for (unsigned int k = 1; k <= M / 2; ++k) {
+
+						const complex<real> Z_k = Z[k];
+						const complex<real> Z_Mk = Z[M - k];
+
+						// Transforms of the even and odd elements
+						const complex<real> E = (Z_k + Z_Mk.conjugate()) * 0.5;
+						const complex<real> D = (Z_k - Z_Mk.conjugate()) * 0.5;
+						const complex<real> O = complex<real>(D.b, -D.a);
+
+						const complex<real> WO = twiddles[k] * O;
+						X[k] = E + WO;
+						X[M - k] = (E - WO).conjugate();
+					}
+
+					return X;
+				}
+
+
+				/// Compute real data from the non-redundant elements
+				/// of its transform, normalized by 1 / N.
+				///
+				/// @param X The N / 2 + 1 elements of the spectrum
+				/// @param x The vector to write the real data to,
+				/// already of size size()
+				/// @return A reference to the real data
+				template<typename ComplexVector, typename RealVector>
+				inline RealVector& inverse(const ComplexVector& X, RealVector& x) const {
 
-			// Enforce power of 2 vector size
-			if (N != (unsigned int) (1 << log2N)) {
-				return algebra::vec_error(k);
+					if (X.size() != N / 2 + 1 || N == 0) {
+						TH_MATH_ERROR("rfft_plan::inverse", X.size(), MathError::InvalidArgument);
+						return algebra::vec_error(x);
+					}
+
+					if (x.size() != N) {
+						TH_MATH_ERROR("rfft_plan::inverse", x.size(), MathError::InvalidArgument);
+						return algebra::vec_error(x);
+					}
+
+					// The inverse transform is computed as the
+					// conjugate of the transform of the conjugate
+					if (N % 2) {
+
+						std::vector<complex<real>> z (N);
+
+						for (unsigned int k = 0; k <= N / 2; ++k)
+							z[k] = X[k].conjugate();
+
+						for (unsigned int k = N / 2 + 1; k < N; ++k)
+							z[k] = X[N - k];
+
+						plan.execute(z);
+
+						for (unsigned int i = 0; i < N; ++i)
+							x[i] = z[i].a / N;
+
+						return x;
+					}
+
+					// Recombine the transforms of the even and odd elements
+					const unsigned int M = N / 2;
+					std::vector<complex<real>> Z (M);
+
+					for (unsigned int k = 0; k < M; ++k) {
+
+						const complex<real> X_k = X[k];
+						const complex<real> X_Mk = X[M - k].conjugate();
+
+						const complex<real> E = X_k + X_Mk;
+						const complex<real> W = (k <= M / 2)
+							? twiddles[k].conjugate()
+							: complex<real>(-twiddles[M - k].a, -twiddles[M - k].b);
+						const complex<real> O = W * (X_k - X_Mk);
+
+						Z[k] = (E + complex<real>(-O.b, O.a)).conjugate();
+					}
+
+					plan.execute(Z);
+
+					for (unsigned int n = 0; n < M; ++n) {
+						x[2 * n] = Z[n].a / N;
+						x[2 * n + 1] = -Z[n].b / N;
+					}
+
+					return x;
+				}
+
+
+				/// Get the size of the real data
+				inline unsigned int size() const {
+					return N;
+				}
+		};
+
+
+		/// Compute the Fast Fourier Transform of real data,
+		/// returning the N / 2 + 1 non-redundant elements of the spectrum.
+		/// The remaining elements are the complex conjugates \f$X_{N-k} = X_k^*\f$.
+		///
+		/// @param x The real data in the time domain
+		/// @return The N / 2 + 1 elements of the spectrum
+		template<typename ReturnVector = cvec, typename InputVector = vec<real>>
+		inline ReturnVector rfft(const InputVector& x) {
+
+			if (x.size() == 0) {
+				TH_MATH_ERROR("rfft", x.size(), MathError::InvalidArgument);
+				return make_error<ReturnVector>(1);
+			}
+
+			ReturnVector X;
+			X.resize(x.size() / 2 + 1);
+
+			return rfft_plan(x.size()).forward(x, X);
+		}
+
+
+		/// Compute real data from the N / 2 + 1 non-redundant
+		/// elements of its Fast Fourier Transform.
+		///
+		/// @param X The N / 2 + 1 elements of the spectrum
+		/// @param N The size of the real data, which is needed
+		/// to distinguish between even and odd sizes, defaults to
+		/// 2 * (X.size() - 1), the even size
+		/// @return The real data in the time domain
+		template<typename ReturnVector = vec<real>, typename InputVector = cvec>
+		inline ReturnVector irfft(const InputVector& X, unsigned int N = 0) {
+
+			if (N == 0)
+				N = 2 * (X.size() - 1);
+
+			if (X.size() == 0 || N == 0 || X.size() != N / 2 + 1) {
+				TH_MATH_ERROR("irfft", X.size(), MathError::InvalidArgument);
+				return make_error<ReturnVector>(1);
 			}
 
-			// Bit reverse
-			swap_bit_reverse(k, log2N);
+			ReturnVector x;
+			x.resize(N);
+
+			return rfft_plan(N).inverse(X, x);
+		}
+
+
+		namespace _internal {
+
+
+			/// Transform the lines along one axis of a multidimensional
+			/// array stored contiguously with the last index varying fastest.
+			/// The array is seen as having shape (outer, n, inner) and lines
+			/// are gathered SIGNAL_FFT_TILE at a time into a contiguous buffer,
+			/// transposing tiles of consecutive elements, so that strided axes
+			/// are read and written in cache-friendly order. Tiles of lines
+			/// are transformed in parallel.
+			///
+			/// @param x The array to transform in place
+			/// @param outer The product of the sizes of the preceding axes
+			/// @param n The size of the axis to transform
+			/// @param inner The product of the sizes of the following axes
+			/// @param plan The plan of the transform of size n
+			template<typename Vector>
+			inline void fft_axis(
+				Vector& x, unsigned int outer, unsigned int n,
+				unsigned int inner, const fft_plan& plan) {
+
+				const unsigned int lines = outer * inner;
+				const unsigned int tile = SIGNAL_FFT_TILE;
+				const unsigned int tiles = (lines + tile - 1) / tile;
+
+				#pragma omp parallel if(lines * n >= SIGNAL_FFT_PARALLEL_MIN)
+				{
+					std::vector<complex<real>> buffer (tile * n);
+					std::vector<complex<real>> work (plan.work_size());
+					std::vector<unsigned int> first (tile);
+
+					#pragma omp for schedule(dynamic)
+					for (unsigned int b = 0; b < tiles; ++b) {
+
+						const unsigned int l0 = b * tile;
+						const unsigned int count = min(tile, lines - l0);
+
+						// Index of the first element of each line
+						for (unsigned int t = 0; t < count; ++t) {
 
-			for (unsigned int p = 1; p <= log2N; p++) {
+							const unsigned int l = l0 + t;
+							first[t] = (l / inner) * n * inner + l % inner;
+						}
 
-				const unsigned int m = 1 << p;
-				const unsigned int offset = m / 2;
-				
-				complex<real> w (1.0, 0.0);
+						// Gather the lines, reading consecutive
+						// elements of the array when possible
+						if (inner == 1) {
 
-				// Phase shift between iterations
-				const complex<real> phase = complex<real>(
-					cos(sign * 2 * PI / m),
-					sin(sign * 2 * PI / m)
-				);
+							for (unsigned int t = 0; t < count; ++t)
+								for (unsigned int k = 0; k < n; ++k)
+									buffer[t * n + k] = x[first[t] + k];
 
-				for (unsigned int j = 0; j < offset; j++) {
+						} else {
 
-					for (unsigned int i = j; i < N; i += m) {
+							for (unsigned int k = 0; k < n; ++k)
+								for (unsigned int t = 0; t < count; ++t)
+									buffer[t * n + k] = x[first[t] + k * inner];
+						}
 
-						const complex<real> t = w * k[i + offset];
-						k[i + offset] = k[i] - t;
-						k[i] += t;
+						for (unsigned int t = 0; t < count; ++t) {
+							vec_view<complex<real>> line (&buffer[t * n], n);
+							plan.execute(line, work);
+						}
+
+						// Scatter the transformed lines
+						if (inner == 1) {
+
+							for (unsigned int t = 0; t < count; ++t)
+								for (unsigned int k = 0; k < n; ++k)
+									x[first[t] + k] = buffer[t * n + k];
+
+						} else {
+
+							for (unsigned int k = 0; k < n; ++k)
+								for (unsigned int t = 0; t < count; ++t)
+									x[first[t] + k * inner] = buffer[t * n + k];
+						}
 					}
-					
-					w *= phase;
 				}
 			}
+		}
+
+
+		/// Compute the multidimensional Fast Fourier Transform of an array
+		/// stored contiguously with the last index varying fastest, in place.
+		/// The transform is computed along each axis in turn, on tiles of
+		/// lines which are transformed in parallel.
+		///
+		/// @param x The array to transform, with as many elements
+		/// as the product of the sizes of its axes
+		/// @param shape The size of each axis of the array
+		/// @param inverse Whether to run the inverse transform (defaults to false)
+		/// @return A reference to the transformed array
+		template<typename Vector, enable_vector<Vector> = true>
+		inline Vector& fftn(
+			Vector& x, const std::vector<unsigned int>& shape, bool inverse = false) {
+
+			unsigned int total = shape.size() ? 1 : 0;
+
+			for (unsigned int n : shape)
+				total *= n;
+
+			if (total == 0 || total != x.size()) {
+				TH_MATH_ERROR("fftn", x.size(), MathError::InvalidArgument);
+				return algebra::vec_error(x);
+			}
 
-			// The normalization constant is 1/N
-			if (inverse)
-				k /= N;
+			unsigned int outer = 1;
+			unsigned int inner = total;
 
-			return k;
+			for (unsigned int n : shape) {
+
+				inner /= n;
+
+				if (n > 1)
+					_internal::fft_axis(x, outer, n, inner, fft_plan(n, inverse));
+
+				outer *= n;
+			}
+
+			return x;
 		}
 
 
-		/// Compute the Inverse Fast Fourier Transform of a set of data points.
-		/// Bit reversion is used on the indices to simplify the resulting calculations.
+		/// Compute the multidimensional Inverse Fast Fourier Transform of an
+		/// array stored contiguously with the last index varying fastest, in place.
 		///
-		/// @param k The set of data points in the frequency domain
-		/// @return The data in the time domain
-		template<typename ReturnVector = cvec, typename InputVector = cvec>
-		inline ReturnVector ifft(const InputVector& k) {
-			return fft(k, true);
+		/// @param x The array to transform, with as many elements
+		/// as the product of the sizes of its axes
+		/// @param shape The size of each axis of the array
+		/// @return A reference to the transformed array
+		template<typename Vector, enable_vector<Vector> = true>
+		inline Vector& ifftn(Vector& x, const std::vector<unsigned int>& shape) {
+			return fftn(x, shape, true);
+		}
+
+
+		/// Compute the three-dimensional Fast Fourier Transform of an array
+		/// of size n0 x n1 x n2, stored contiguously with the last index
+		/// varying fastest, in place.
+		///
+		/// @param x The array to transform, with n0 * n1 * n2 elements
+		/// @param n0 The size of the first axis
+		/// @param n1 The size of the second axis
+		/// @param n2 The size of the third axis, along which elements are contiguous
+		/// @param inverse Whether to run the inverse transform (defaults to false)
+		/// @return A reference to the transformed array
+		template<typename Vector, enable_vector<Vector> = true>
+		inline Vector& fft3(
+			Vector& x, unsigned int n0, unsigned int n1,
+			unsigned int n2, bool inverse = false) {
+
+			return fftn(x, {n0, n1, n2}, inverse);
+		}
+
+
+		/// Compute the three-dimensional Inverse Fast Fourier Transform of
+		/// an array of size n0 x n1 x n2, stored contiguously with the last
+		/// index varying fastest, in place.
+		///
+		/// @param x The array to transform, with n0 * n1 * n2 elements
+		/// @param n0 The size of the first axis
+		/// @param n1 The size of the second axis
+		/// @param n2 The size of the third axis, along which elements are contiguous
+		/// @return A reference to the transformed array
+		template<typename Vector, enable_vector<Vector> = true>
+		inline Vector& ifft3(Vector& x, unsigned int n0, unsigned int n1, unsigned int n2) {
+			return fftn(x, {n0, n1, n2}, true);
+		}
+
+
+		/// Compute the two-dimensional Fast Fourier Transform of a matrix,
+		/// transforming its rows and columns.
+		///
+		/// @param A The matrix of data points in the space domain
+		/// @param inverse Whether to run the inverse transform (defaults to false)
+		/// @return The matrix of data in the frequency domain
+		template<typename ReturnMatrix = cmat, typename InputMatrix = cmat>
+		inline ReturnMatrix fft2(const InputMatrix& A, bool inverse = false) {
+
+			const unsigned int rows = A.rows();
+			const unsigned int cols = A.cols();
+
+			ReturnMatrix R;
+			R.resize(rows, cols);
+
+			if (rows == 0 || cols == 0) {
+				TH_MATH_ERROR("fft2", rows * cols, MathError::InvalidArgument);
+				return algebra::mat_error(R);
+			}
+
+			std::vector<complex<real>> x (rows * cols);
+
+			for (unsigned int i = 0; i < rows; ++i)
+				for (unsigned int j = 0; j < cols; ++j)
+					x[i * cols + j] = A(i, j);
+
+			fftn(x, {rows, cols}, inverse);
+
+			for (unsigned int i = 0; i < rows; ++i)
+				for (unsigned int j = 0; j < cols; ++j)
+					R(i, j) = x[i * cols + j];
+
+			return R;
+		}
+
+
+		/// Compute the two-dimensional Inverse Fast Fourier Transform
+		/// of a matrix, transforming its rows and columns.
+		///
+		/// @param A The matrix of data in the frequency domain
+		/// @return The matrix of data points in the space domain
+		template<typename ReturnMatrix = cmat, typename InputMatrix = cmat>
+		inline ReturnMatrix ifft2(const InputMatrix& A) {
+			return fft2<ReturnMatrix>(A, true);
 		}
 	}
 }
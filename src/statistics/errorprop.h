@@ -22,6 +22,8 @@ namespace theoretica {
 
 		/// Build the covariance matrix given a vector of datasets
 		/// by computing the covariance between all couples of sets.
+		/// The matrix is symmetric, so each covariance is computed once,
+		/// and a packed_mat may be used to store only half of the elements.
 		///
 		/// @param v A vector of datasets of measures
 		/// @return The covariance matrix of the datasets
@@ -34,9 +36,15 @@ namespace theoretica {
 			Matrix cm;
 			cm.resize(v.size(), v.size());
 
-			for (unsigned int i = 0; i < cm.rows(); ++i)
-				for (unsigned int j = 0; j < cm.cols(); ++j)
-					cm(i, j) = stats::covariance(v[i], v[j]);
+			for (unsigned int i = 0; i < cm.rows(); ++i) {
+
+				for (unsigned int j = 0; j <= i; ++j) {
+
+					const real c = stats::covariance(v[i], v[j]);
+					cm(i, j) = c;
+					cm(j, i) = c;
+				}
+			}
 
 			return cm;
 		}
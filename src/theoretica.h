@@ -14,6 +14,8 @@
 #include "core/error.h"
 #include "core/core_traits.h"
 #include "core/reprod.h"
+#include "core/simd.h"
+#include "core/allocator.h"
 
 // IO module
 #include "io/io.h"
@@ -30,6 +32,17 @@
 #include "algebra/vec.h"
 #include "algebra/mat.h"
 #include "algebra/distance.h"
+#include "algebra/kdtree.h"
+#include "algebra/factorization.h"
+#include "algebra/eigen.h"
+#include "algebra/svd.h"
+#include "algebra/sparse.h"
+#include "algebra/banded.h"
+#include "algebra/packed.h"
+#include "algebra/matrix_function.h"
+#include "algebra/krylov.h"
+#include "algebra/view.h"
+#include "algebra/batch.h"
 
 // Complex and quaternion classes
 #include "complex/complex.h"
@@ -6,9 +6,155 @@ using namespace chebyshev;
 using namespace theoretica;
 
 
+// Generate a random square matrix with uniformly distributed elements
+mat<real> rand_mat(pdf_sampler& unif, unsigned int n) {
+
+	mat<real> A (n, n);
+
+	for (auto& x : A)
+		x = unif();
+
+	return A;
+}
+
+
+// Generate a random vector with uniformly distributed elements
+vec<real> rand_vec(pdf_sampler& unif, unsigned int n) {
+
+	vec<real> v (n);
+
+	for (auto& x : v)
+		x = unif();
+
+	return v;
+}
+
+
+// Reference matrix product using a triple loop
+mat<real> naive_mul(const mat<real>& A, const mat<real>& B) {
+
+	mat<real> R (A.rows(), B.cols());
+
+	for (unsigned int i = 0; i < A.rows(); ++i)
+		for (unsigned int j = 0; j < B.cols(); ++j)
+			for (unsigned int k = 0; k < A.cols(); ++k)
+				R(i, j) += A(i, k) * B(k, j);
+
+	return R;
+}
+
+
 int main(int argc, char const *argv[]) {
 	
 	auto ctx = benchmark::make_context("algebra", argc, argv);
-	ctx.settings.outputFiles = { "test/benchmark/benchmark_algebra.h" };
-	
+	ctx.output->settings.outputFiles = { "test/benchmark/benchmark_algebra.csv" };
+	ctx.settings.defaultRuns = 3;
+
+	PRNG g = PRNG::xoshiro(time(nullptr));
+	pdf_sampler unif = pdf_sampler::uniform(-1.0, 1.0, g);
+
+	// Matrix size
+	const unsigned int N = 512;
+
+	std::vector<mat<real>> data = { rand_mat(unif, N), rand_mat(unif, N) };
+
+	ctx.benchmark(
+		"naive_mul (512x512)",
+		[&](const mat<real>& A) { return naive_mul(A, data[0])(0, 0); },
+		data
+	);
+
+	ctx.benchmark(
+		"mat_mul (512x512)",
+		[&](const mat<real>& A) { return algebra::mat_mul(A, data[0])(0, 0); },
+		data
+	);
+
+	ctx.benchmark(
+		"parallel::mat_mul (512x512)",
+		[&](const mat<real>& A) { return parallel::mat_mul(A, data[0])(0, 0); },
+		data
+	);
+
+
+	// Vector size
+	const unsigned int M = 1000000;
+
+	std::vector<vec<real>> vectors = { rand_vec(unif, M), rand_vec(unif, M) };
+
+	ctx.benchmark(
+		"dot (10^6)",
+		[&](const vec<real>& v) { return algebra::dot(v, vectors[0]); },
+		vectors
+	);
+
+	ctx.benchmark(
+		"vec_sum (10^6)",
+		[&](const vec<real>& v) {
+			vec<real> w = v;
+			return algebra::vec_sum(w, vectors[0])[0];
+		},
+		vectors
+	);
+
+
+	// Number of small matrices
+	const unsigned int B = 10000;
+
+	std::vector<mat<real, 4, 4>> small (B);
+	std::vector<vec<real, 4>> points (B);
+
+	for (unsigned int b = 0; b < B; ++b) {
+
+		for (auto& x : small[b])
+			x = unif();
+
+		for (auto& x : points[b])
+			x = unif();
+	}
+
+	const mat_batch<real, 4, 4> small_batch (small);
+	const vec_batch<real, 4> points_batch (points);
+	mat_batch<real, 4, 4> res_batch (B);
+	vec_batch<real, 4> sol_batch (B);
+
+	ctx.benchmark(
+		"inverse (4x4, 10^4)",
+		[&](real) {
+
+			real s = 0.0;
+
+			for (unsigned int b = 0; b < B; ++b)
+				s += algebra::inverse(small[b])(0, 0);
+
+			return s;
+		},
+		std::vector<real>(10)
+	);
+
+	ctx.benchmark(
+		"inverse (batch 4x4, 10^4)",
+		[&](real) { return algebra::inverse(res_batch, small_batch)(0, 0, 0); },
+		std::vector<real>(10)
+	);
+
+	ctx.benchmark(
+		"solve (4x4, 10^4)",
+		[&](real) {
+
+			real s = 0.0;
+
+			for (unsigned int b = 0; b < B; ++b)
+				s += algebra::solve(small[b], points[b])[0];
+
+			return s;
+		},
+		std::vector<real>(10)
+	);
+
+	ctx.benchmark(
+		"solve (batch 4x4, 10^4)",
+		[&](real) { return algebra::solve(sol_batch, small_batch, points_batch)(0, 0); },
+		std::vector<real>(10)
+	);
 }
@@ -0,0 +1,163 @@
+
+#include "theoretica.h"
+#include "chebyshev.h"
+
+using namespace chebyshev;
+using namespace theoretica;
+
+
+// Generate a random complex vector with uniformly distributed elements
+cvec rand_cvec(pdf_sampler& unif, unsigned int n) {
+
+	cvec v (n);
+
+	for (auto& z : v)
+		z = complex<real>(unif(), unif());
+
+	return v;
+}
+
+
+// Reference radix-2 transform with twiddle factors
+// computed by repeated multiplication at each call
+cvec radix2_fft(const cvec& x) {
+
+	cvec k = x;
+	const unsigned int N = x.size();
+	const unsigned int log2N = ilog2(N);
+
+	swap_bit_reverse(k, log2N);
+
+	for (unsigned int p = 1; p <= log2N; p++) {
+
+		const unsigned int m = 1 << p;
+		const unsigned int offset = m / 2;
+
+		complex<real> w (1.0, 0.0);
+		const complex<real> phase = complex<real>(th::cos(-2 * PI / m), th::sin(-2 * PI / m));
+
+		for (unsigned int j = 0; j < offset; j++) {
+
+			for (unsigned int i = j; i < N; i += m) {
+
+				const complex<real> t = w * k[i + offset];
+				k[i + offset] = k[i] - t;
+				k[i] += t;
+			}
+
+			w *= phase;
+		}
+	}
+
+	return k;
+}
+
+
+int main(int argc, char const *argv[]) {
+
+	auto ctx = benchmark::make_context("signal", argc, argv);
+	ctx.output->settings.outputFiles = { "test/benchmark/benchmark_signal.csv" };
+	ctx.settings.defaultRuns = 3;
+
+	PRNG g = PRNG::xoshiro(time(nullptr));
+	pdf_sampler unif = pdf_sampler::uniform(-1.0, 1.0, g);
+
+	for (unsigned int log2N : {10, 16, 20}) {
+
+		const unsigned int N = 1 << log2N;
+		const std::string size = "(2^" + std::to_string(log2N) + ")";
+
+		std::vector<cvec> data = { rand_cvec(unif, N), rand_cvec(unif, N) };
+
+		const signal::fft_plan plan (N);
+		std::vector<complex<real>> work (plan.work_size());
+		cvec buffer (N);
+
+		ctx.benchmark(
+			"radix2_fft " + size,
+			[&](const cvec& x) { return radix2_fft(x)[1].a; },
+			data
+		);
+
+		ctx.benchmark(
+			"fft " + size,
+			[&](const cvec& x) { return signal::fft(x)[1].a; },
+			data
+		);
+
+		ctx.benchmark(
+			"fft_plan::execute " + size,
+			[&](const cvec& x) {
+				buffer = x;
+				return plan.execute(buffer, work)[1].a;
+			},
+			data
+		);
+	}
+
+
+	// Sizes which are not powers of 2
+	for (unsigned int N : {44100, 65537}) {
+
+		const std::string size = "(" + std::to_string(N) + ")";
+		std::vector<cvec> data = { rand_cvec(unif, N), rand_cvec(unif, N) };
+
+		const signal::fft_plan plan (N);
+		std::vector<complex<real>> work (plan.work_size());
+		cvec buffer (N);
+
+		ctx.benchmark(
+			"fft_plan::execute " + size,
+			[&](const cvec& x) {
+				buffer = x;
+				return plan.execute(buffer, work)[1].a;
+			},
+			data
+		);
+	}
+
+
+	// Real data
+	const unsigned int N = 1 << 16;
+	std::vector<vec<real>> signals = { vec<real>(N), vec<real>(N) };
+
+	for (auto& v : signals)
+		for (auto& x : v)
+			x = unif();
+
+	ctx.benchmark(
+		"fft (real data, 2^16)",
+		[&](const vec<real>& x) {
+
+			cvec z (N);
+
+			for (unsigned int i = 0; i < N; ++i)
+				z[i] = x[i];
+
+			return signal::fft(z)[1].a;
+		},
+		signals
+	);
+
+	ctx.benchmark(
+		"rfft (2^16)",
+		[&](const vec<real>& x) { return signal::rfft(x)[1].a; },
+		signals
+	);
+
+
+	// Two-dimensional data
+	const unsigned int side = 512;
+	std::vector<cmat> images = { cmat(side, side), cmat(side, side) };
+
+	for (auto& A : images)
+		for (unsigned int i = 0; i < side; ++i)
+			for (unsigned int j = 0; j < side; ++j)
+				A(i, j) = complex<real>(unif(), unif());
+
+	ctx.benchmark(
+		"fft2 (512 x 512)",
+		[&](const cmat& A) { return signal::fft2(A)(1, 1).a; },
+		images
+	);
+}
@@ -229,6 +229,52 @@ int main(int argc, char const *argv[]) {
 	});
 
 
+	test_residual(ctx, "dot (SIMD)", []() {
+
+		// Odd size to exercise the tail of the packed kernels
+		const unsigned int n = 1003;
+		auto v = rand_vec(0.0, 1.0, n);
+		auto w = rand_vec(0.0, 1.0, n);
+
+		long double d = 0.0;
+		for (unsigned int i = 0; i < n; ++i)
+			d += (long double) v[i] * w[i];
+
+		return std::abs(algebra::dot(v, w) - d);
+	});
+
+
+	test_residual(ctx, "vec_scalmul (SIMD)", []() {
+
+		const unsigned int n = 1003;
+		auto v = rand_vec<vec<float>>(0.0, 1.0, n);
+		vec<float> w = vec<float>(n);
+		algebra::vec_scalmul(w, 0.5f, v);
+
+		real m = 0.0;
+		for (unsigned int i = 0; i < n; ++i)
+			m = std::max(m, (real) std::abs(w[i] - v[i] / 2));
+
+		return m;
+	});
+
+
+	test_residual(ctx, "mat_lincomb", []() {
+
+		auto A = rand_mat(0.0, 1.0, N, N + 3);
+		auto B = rand_mat(0.0, 1.0, N, N + 3);
+		mat<real> C = mat<real>(N, N + 3);
+		algebra::mat_lincomb(C, 2.0, A, 0.25, B);
+
+		real m = 0.0;
+		for (unsigned int i = 0; i < C.rows(); ++i)
+			for (unsigned int j = 0; j < C.cols(); ++j)
+				m = std::max(m, std::abs(C(i, j) - (A(i, j) * 2.0 + B(i, j) * 0.25)));
+
+		return m;
+	});
+
+
 	test_residual(ctx, "cross", []() {
 		auto v1 = rand_vec(0.0, 1.0, 3);
 		auto v2 = rand_vec(0.0, 1.0, 3);
@@ -279,6 +325,48 @@ int main(int argc, char const *argv[]) {
 	});
 
 
+	test_residual(ctx, "mat_mul", []() {
+
+		// Odd sizes exercise the edges of the blocked kernel
+		const unsigned int n = 301, k = 273, m = 157;
+
+		auto A = rand_mat(0.0, 1.0, n, k);
+		auto B = rand_mat(0.0, 1.0, k, m);
+		auto C = algebra::mat_mul(A, B);
+
+		mat<real> R (n, m);
+
+		for (unsigned int i = 0; i < n; ++i)
+			for (unsigned int j = 0; j < m; ++j)
+				for (unsigned int l = 0; l < k; ++l)
+					R(i, j) += A(i, l) * B(l, j);
+
+		return linf_norm(C - R);
+	}, 1);
+
+
+	test_residual(ctx, "mat_transpose_mul", []() {
+
+		auto A = rand_mat(0.0, 1.0, 90, 70);
+		auto B = rand_mat(0.0, 1.0, 90, 60);
+
+		return linf_norm(
+			algebra::mat_transpose_mul(A, B) - algebra::transpose(A) * B
+		);
+	});
+
+
+	test_residual(ctx, "mat_mul_transpose", []() {
+
+		auto A = rand_mat(0.0, 1.0, 70, 90);
+		auto B = rand_mat(0.0, 1.0, 60, 90);
+
+		return linf_norm(
+			algebra::mat_mul_transpose(A, B) - A * algebra::transpose(B)
+		);
+	});
+
+
 	test_residual(ctx, "det", []() {
 
 		size_t sz = 10;
@@ -298,27 +386,1577 @@ int main(int argc, char const *argv[]) {
 	});
 
 
-	// mat.h
+	test_residual(ctx, "decompose_lu_pivot_inplace", []() {
 
-	test_residual(ctx, "mat::unpack", [&]() {
+		// Bigger than a panel, to test the blocked update
+		const unsigned int n = 150;
 
-		mat<real> A = rand_mat(0.0, 1.0, N, N);
-		vec<real> v = A.unpack();
-		mat<real> B (v, A.rows(), A.cols());
+		auto A = rand_mat(-1.0, 1.0, n, n);
+		auto LU = A;
+		std::vector<unsigned int> perm;
 
-		return linf_norm(A - B);
+		algebra::decompose_lu_pivot_inplace(LU, perm);
+
+		mat<real> L (n, n), U (n, n), PA (n, n);
+
+		for (unsigned int i = 0; i < n; ++i) {
+
+			for (unsigned int j = 0; j < n; ++j) {
+
+				PA(i, j) = A(perm[i], j);
+
+				if (j < i)
+					L(i, j) = LU(i, j);
+				else
+					U(i, j) = LU(i, j);
+			}
+
+			L(i, i) = 1.0;
+		}
+
+		return linf_norm(PA - L * U);
+	}, 1);
+
+
+	test_residual(ctx, "solve_lu (pivoting)", []() {
+
+		// The unpivoted decomposition fails on this matrix
+		mat<real> A = {
+			{0.0, 2.0, 1.0},
+			{1.0, 1.0, 0.0},
+			{3.0, 0.0, 1.0}
+		};
+
+		vec<real> x = rand_vec(-1.0, 1.0, 3);
+		vec<real> b = A * x;
+
+		return linf_norm(algebra::solve_lu(A, b) - x);
 	});
 
-	test_residual(ctx, "mat<N, K>::unpack", [&]() {
 
-		mat<real, 4, 4> A = rand_mat(0.0, 1.0, 4, 4);
-		vec<real, 16> v = A.unpack();
-		mat<real, 4, 4> B (v, A.rows(), A.cols());
+	test_residual(ctx, "lu_factor", []() {
 
-		return linf_norm(A - B);
+		auto A = rand_mat(-1.0, 1.0, N, N);
+		lu_factor<> LU (A);
+
+		real max_res = 0.0;
+
+		// Reuse the factorization for many known vectors
+		for (unsigned int k = 0; k < 5; ++k) {
+
+			vec<real> b = rand_vec(-1.0, 1.0, N);
+			max_res = std::max(max_res, linf_norm(A * LU.solve(b) - b));
+		}
+
+		return max_res;
 	});
 
-	// vec.h
 
-	// distance.h
+	test_residual(ctx, "lu_factor::inverse", []() {
+
+		auto A = rand_mat(-1.0, 1.0, N, N);
+		lu_factor<> LU (A);
+
+		mat<real> I (N, N);
+		algebra::make_identity(I);
+
+		return linf_norm(A * LU.inverse() - I);
+	});
+
+
+	test_residual(ctx, "lu_factor::det", []() {
+
+		auto A = rand_mat(-1.0, 1.0, 10, 10);
+		lu_factor<> LU (A);
+
+		return std::abs(LU.det() - algebra::det(A)) / std::abs(algebra::det(A));
+	});
+
+
+	test_residual(ctx, "cholesky_factor::solve_many", []() {
+
+		auto A = rand_mat_posdef(0.0, 1.0, N);
+		auto B = rand_mat(-1.0, 1.0, N, 5);
+		cholesky_factor<> L (A);
+
+		return linf_norm(A * L.solve_many(B) - B);
+	});
+
+
+
+	test_residual(ctx, "cholesky_update", []() {
+
+		// Well conditioned positive definite matrix
+		auto B = rand_mat(0.0, 1.0, N, 2 * N);
+		mat<real> A = algebra::mat_mul_transpose(B, B);
+		vec<real> v = rand_vec(0.0, 1.0, N);
+
+		mat<real> L = algebra::decompose_cholesky(A);
+		algebra::cholesky_update(L, v);
+
+		mat<real> A_new = A;
+
+		for (unsigned int i = 0; i < N; ++i)
+			for (unsigned int j = 0; j < N; ++j)
+				A_new(i, j) += v[i] * v[j];
+
+		return linf_norm(L - algebra::decompose_cholesky(A_new));
+	});
+
+
+	test_residual(ctx, "cholesky_factor (update, downdate)", []() {
+
+		auto B = rand_mat(0.0, 1.0, N, 2 * N);
+		vec<real> v = rand_vec(0.0, 1.0, N);
+		vec<real> w = rand_vec(0.0, 1.0, N);
+
+		mat<real> A = algebra::mat_mul_transpose(B, B);
+		mat<real> A_new = A;
+
+		for (unsigned int i = 0; i < N; ++i) {
+			for (unsigned int j = 0; j < N; ++j) {
+				A(i, j) += w[i] * w[j];
+				A_new(i, j) += v[i] * v[j];
+			}
+		}
+
+		// Move a window of observations by one,
+		// adding v and removing w
+		cholesky_factor<> F (A);
+		F.update(v).downdate(w);
+
+		return linf_norm(F.L - algebra::decompose_cholesky(A_new));
+	});
+
+
+	test_residual(ctx, "qr_factor::solve", []() {
+
+		auto A = rand_mat(-1.0, 1.0, N, N);
+		vec<real> b = rand_vec(-1.0, 1.0, N);
+		qr_factor<> QR (A);
+
+		return linf_norm(A * QR.solve(b) - b);
+	});
+
+
+	test_residual(ctx, "qr_factor::solve (least squares)", []() {
+
+		auto A = rand_mat(-1.0, 1.0, 200, 10);
+		vec<real> b = rand_vec(-1.0, 1.0, 200);
+		qr_factor<> QR (A);
+
+		// The residual of the least squares solution
+		// is orthogonal to the columns of A
+		vec<real> r = A * QR.solve(b) - b;
+		return linf_norm(algebra::transform(algebra::transpose(A), r));
+	});
+
+
+	test_residual(ctx, "decompose_qr_inplace", []() {
+
+		// Bigger than a panel, to test the blocked update
+		const unsigned int m = 157, n = 101;
+
+		auto A = rand_mat(-1.0, 1.0, m, n);
+		auto QR = A;
+		std::vector<real> tau;
+
+		algebra::decompose_qr_inplace(QR, tau);
+
+		// Reconstruct each column of A as Q R_j
+		real max_res = 0.0;
+
+		for (unsigned int j = 0; j < n; ++j) {
+
+			vec<real> col (m);
+
+			for (unsigned int i = 0; i <= j; ++i)
+				col[i] = QR(i, j);
+
+			algebra::householder_q_inplace(QR, tau, col);
+
+			for (unsigned int i = 0; i < m; ++i)
+				max_res = std::max(max_res, std::abs(col[i] - A(i, j)));
+		}
+
+		return max_res;
+	}, 1);
+
+
+	test_residual(ctx, "solve_least_squares", []() {
+
+		auto A = rand_mat(-1.0, 1.0, 300, 40);
+		vec<real> b = rand_vec(-1.0, 1.0, 300);
+
+		// The residual of the least squares solution
+		// is orthogonal to the columns of A
+		vec<real> r = A * algebra::solve_least_squares(A, b) - b;
+		return linf_norm(algebra::transform(algebra::transpose(A), r));
+	}, 1);
+
+
+	test_residual(ctx, "qr_factor::det", []() {
+
+		auto A = rand_mat(-1.0, 1.0, 10, 10);
+		qr_factor<> QR (A);
+
+		return std::abs(QR.det() - algebra::det(A)) / std::abs(algebra::det(A));
+	});
+
+
+	test_residual(ctx, "qr_factor (rank deficient)", []() {
+
+		auto A = rand_mat(-1.0, 1.0, 10, 10);
+
+		for (unsigned int i = 0; i < 10; ++i)
+			A(i, 2) = 0.0;
+
+		qr_factor<> QR (A);
+		vec<real> b = rand_vec(-1.0, 1.0, 10);
+
+		// Singular systems give NaN instead of infinite solutions
+		mat<real> A_inv = QR.inverse();
+		real res = 0.0;
+
+		for (real x : A_inv)
+			res += !std::isnan(x);
+
+		for (real x : QR.solve_inplace(b))
+			res += !std::isnan(x);
+
+		return res;
+	}, 1);
+
+
+	test_residual(ctx, "det (pivoting)", []() {
+
+		// Single row swap of a diagonal matrix
+		mat<real> A = {
+			{0.0, 2.0, 0.0},
+			{3.0, 0.0, 0.0},
+			{0.0, 0.0, 5.0}
+		};
+
+		return std::abs(algebra::det(A) + 30.0);
+	});
+
+
+
+	test_residual(ctx, "solve_mixed", []() {
+
+		auto A = rand_mat(-1.0, 1.0, N, N);
+		vec<real> b = rand_vec(-1.0, 1.0, N);
+
+		auto res = algebra::solve_mixed(A, b);
+
+		if (!res.converged())
+			return inf();
+
+		return linf_norm(A * res.value - b);
+	});
+
+
+	test_residual(ctx, "solve_mixed (cholesky)", []() {
+
+		auto A = rand_mat_posdef(0.0, 1.0, N);
+		vec<real> b = rand_vec(-1.0, 1.0, N);
+
+		auto res = algebra::solve_mixed<cholesky_factor<mat<float>>>(A, b);
+
+		if (!res.converged())
+			return inf();
+
+		return linf_norm(A * res.value - b);
+	});
+
+	// eigen.h
+
+	test_residual(ctx, "eigenpairs_symmetric", []() {
+
+		auto A = rand_mat_posdef(-1.0, 1.0, N);
+		mat<real> V;
+
+		auto lambda = algebra::eigenpairs_symmetric(A, V);
+
+		// Check that A V = V Lambda
+		mat<real> V_lambda = V;
+
+		for (unsigned int i = 0; i < N; ++i)
+			for (unsigned int j = 0; j < N; ++j)
+				V_lambda(i, j) *= lambda[j];
+
+		return linf_norm(A * V - V_lambda);
+	}, 1);
+
+
+	test_residual(ctx, "eigenpairs_symmetric (orthogonality)", []() {
+
+		auto A = rand_mat_posdef(-1.0, 1.0, N);
+		mat<real> V;
+
+		algebra::eigenpairs_symmetric(A, V);
+
+		mat<real> I (N, N);
+		algebra::make_identity(I);
+
+		return linf_norm(algebra::mat_transpose_mul(V, V) - I);
+	}, 1);
+
+
+	test_residual(ctx, "eigenvalues_symmetric", []() {
+
+		auto A = rand_mat_posdef(-1.0, 1.0, N);
+		mat<real> V;
+
+		auto lambda = algebra::eigenvalues_symmetric(A);
+		auto lambda_V = algebra::eigenpairs_symmetric(A, V);
+
+		// The trace is equal to the sum of the eigenvalues
+		real tr = 0.0;
+
+		for (unsigned int i = 0; i < N; ++i)
+			tr += A(i, i);
+
+		return linf_norm(lambda - lambda_V) + std::abs(tr - sum(lambda)) / std::abs(tr);
+	}, 1);
+
+
+	// svd.h
+
+	test_residual(ctx, "decompose_svd", []() {
+
+		auto A = rand_mat(0.0, 1.0, 60, 25);
+		mat<real> U, V;
+		vec<real> S;
+
+		algebra::decompose_svd(A, U, S, V);
+
+		// Reconstruct A as U S V^T
+		for (unsigned int i = 0; i < U.rows(); ++i)
+			for (unsigned int j = 0; j < U.cols(); ++j)
+				U(i, j) *= S[j];
+
+		return linf_norm(A - algebra::mat_mul_transpose(U, V));
+	}, 1);
+
+
+	test_residual(ctx, "decompose_svd (full, wide)", []() {
+
+		auto A = rand_mat(0.0, 1.0, 20, 45);
+		mat<real> U, V;
+		vec<real> S;
+
+		algebra::decompose_svd(A, U, S, V, false);
+
+		mat<real> I (V.rows(), V.cols());
+		algebra::make_identity(I);
+
+		mat<real> US = U;
+
+		for (unsigned int i = 0; i < US.rows(); ++i)
+			for (unsigned int j = 0; j < US.cols(); ++j)
+				US(i, j) *= S[j];
+
+		// Use the first columns of V in the reconstruction
+		mat<real> V_thin (V.rows(), S.size());
+
+		for (unsigned int i = 0; i < V.rows(); ++i)
+			for (unsigned int j = 0; j < S.size(); ++j)
+				V_thin(i, j) = V(i, j);
+
+		return linf_norm(A - algebra::mat_mul_transpose(US, V_thin))
+			+ linf_norm(algebra::mat_transpose_mul(V, V) - I);
+	}, 1);
+
+
+	test_residual(ctx, "decompose_svd (complex)", []() {
+
+		mat<complex<>> A (30, 20);
+
+		for (unsigned int i = 0; i < A.rows(); ++i)
+			for (unsigned int j = 0; j < A.cols(); ++j)
+				A(i, j) = complex<>(rnd.gaussian(0.0, 1.0), rnd.gaussian(0.0, 1.0));
+
+		mat<complex<>> U, V;
+		vec<real> S;
+
+		algebra::decompose_svd(A, U, S, V);
+
+		// Reconstruct A as U S V^H
+		real max_res = 0.0;
+
+		for (unsigned int i = 0; i < A.rows(); ++i) {
+			for (unsigned int j = 0; j < A.cols(); ++j) {
+
+				complex<> sum = 0.0;
+
+				for (unsigned int l = 0; l < S.size(); ++l)
+					sum += U(i, l) * S[l] * conjugate(V(j, l));
+
+				max_res = std::max(max_res, abs(sum - A(i, j)));
+			}
+		}
+
+		return max_res;
+	}, 1);
+
+
+	test_residual(ctx, "pinv", []() {
+
+		// Rank deficient matrix, A = B C with 40x5 and 5x30 factors
+		auto A = rand_mat(0.0, 1.0, 40, 5) * rand_mat(0.0, 1.0, 5, 30);
+		auto P = algebra::pinv(A);
+
+		// Moore-Penrose conditions A P A = A and P A P = P
+		return linf_norm(A * P * A - A) + linf_norm(P * A * P - P);
+	}, 1);
+
+
+	test_residual(ctx, "rank", []() {
+
+		auto A = rand_mat(0.0, 1.0, 40, 5) * rand_mat(0.0, 1.0, 5, 30);
+		return std::abs(real(algebra::rank(A)) - 5.0);
+	}, 1);
+
+
+	// sparse.h
+
+	test_residual(ctx, "sparse_mat::transform", []() {
+
+		// Second order finite difference operator
+		const unsigned int n = 500;
+		std::vector<sparse_triplet<real>> entries;
+
+		for (unsigned int i = 0; i < n; ++i) {
+
+			entries.push_back({i, i, -2.0});
+
+			if (i > 0)
+				entries.push_back({i, i - 1, 1.0});
+
+			if (i < n - 1)
+				entries.push_back({i, i + 1, 1.0});
+		}
+
+		sparse_mat<> A (n, n, entries);
+		sparse_mat<real, SparseFormat::CSC> B (n, n, entries);
+
+		mat<real> D;
+		D = A;
+
+		vec<real> v = rand_vec(0.0, 1.0, n);
+		vec<real> w = D * v;
+
+		return linf_norm(A * v - w) + linf_norm(algebra::transform(B, v) - w);
+	}, 1);
+
+
+	test_residual(ctx, "sparse_mat (dense)", []() {
+
+		auto A = rand_mat(0.0, 1.0, 40, 30);
+
+		// Remove most elements
+		for (unsigned int i = 0; i < A.rows(); ++i)
+			for (unsigned int j = 0; j < A.cols(); ++j)
+				if ((i * 7 + j * 3) % 10)
+					A(i, j) = 0.0;
+
+		sparse_mat<> S (A);
+		sparse_mat<real, SparseFormat::CSC> T (A);
+
+		// Generic algebra routines accept sparse matrices
+		auto B = rand_mat(0.0, 1.0, 30, 20);
+
+		mat<real> SB = algebra::mat_mul<sparse_mat<>, mat<real>, mat<real>>(S, B);
+		mat<real> TB = algebra::mat_mul<decltype(T), mat<real>, mat<real>>(T, B);
+		mat<real> St = algebra::transpose<decltype(S.transpose()), mat<real>>(S.transpose());
+
+		return linf_norm(SB - A * B) + linf_norm(TB - A * B) + linf_norm(St - A);
+	}, 1);
+
+
+	test_residual(ctx, "sparse_mat (tolerance)", []() {
+
+		mat<real> A (4, 4);
+		A(0, 0) = 1.0;
+		A(1, 2) = 1E-20;
+		A(2, 1) = -1E-14;
+		A(3, 3) = 0.5;
+
+		// All nonzero elements are kept by default
+		sparse_mat<> S (A);
+		sparse_mat<real, SparseFormat::CSC> T (A);
+
+		// Small elements are only dropped when a tolerance is given
+		sparse_mat<> R (A, 1E-10);
+
+		return std::abs(S.nonzeros() - 4.0) + std::abs(T.nonzeros() - 4.0)
+			+ std::abs(R.nonzeros() - 2.0)
+			+ std::abs(S(1, 2) - 1E-20) + std::abs(T(2, 1) + 1E-14);
+	}, 1);
+
+
+	test_residual(ctx, "sparse_mat (triangular)", []() {
+
+		auto L = rand_mat(0.0, 1.0, N, N);
+		auto U = rand_mat(0.0, 1.0, N, N);
+
+		// Make the matrices triangular and diagonally dominant
+		for (unsigned int i = 0; i < N; ++i) {
+
+			for (unsigned int j = 0; j < N; ++j) {
+
+				if (j > i)
+					L(i, j) = 0.0;
+				else if (j < i)
+					U(i, j) = 0.0;
+			}
+
+			L(i, i) += N;
+			U(i, i) += N;
+		}
+
+		vec<real> b = rand_vec(0.0, 1.0, N);
+
+		sparse_mat<> L_csr (L), U_csr (U);
+		sparse_mat<real, SparseFormat::CSC> L_csc (L), U_csc (U);
+
+		return linf_norm(L * algebra::solve_triangular_lower(L_csr, b) - b)
+			+ linf_norm(L * algebra::solve_triangular_lower(L_csc, b) - b)
+			+ linf_norm(U * algebra::solve_triangular_upper(U_csr, b) - b)
+			+ linf_norm(U * algebra::solve_triangular_upper(U_csc, b) - b);
+	}, 1);
+
+
+	// banded.h
+
+
+	test_residual(ctx, "tridiag_mat (solve)", []() {
+
+		const unsigned int n = 1000;
+		tridiag_mat<> A (n);
+
+		// Diagonally dominant, as required by the Thomas algorithm
+		for (unsigned int i = 0; i < n - 1; ++i) {
+			A.lower[i] = rnd.gaussian(0.0, 1.0);
+			A.upper[i] = rnd.gaussian(0.0, 1.0);
+		}
+
+		for (unsigned int i = 0; i < n; ++i)
+			A.diag[i] = 8.0 + rnd.gaussian(0.0, 1.0);
+
+		vec<real> b = rand_vec(0.0, 1.0, n);
+		vec<real> x = algebra::solve(A, b);
+
+		// Generic routines accept tridiagonal matrices
+		mat<real> D (A);
+
+		return linf_norm(A * x - b) + linf_norm(D * x - b);
+	}, 1);
+
+
+	test_residual(ctx, "banded_lu_factor::solve", []() {
+
+		const unsigned int kl = 3, ku = 2;
+		auto D = rand_mat(0.0, 1.0, N, N);
+
+		// Remove the elements outside of the band,
+		// the diagonal is not dominant so pivoting is needed
+		for (unsigned int i = 0; i < N; ++i)
+			for (unsigned int j = 0; j < N; ++j)
+				if (j + kl < i || j > i + ku)
+					D(i, j) = 0.0;
+
+		banded_mat<> A (D, kl, ku);
+		vec<real> b = rand_vec(0.0, 1.0, N);
+
+		banded_lu_factor<> LU (A);
+		vec<real> x = LU.solve(b);
+
+		return linf_norm(A * x - b) + linf_norm(D * algebra::solve(A, b) - b);
+	});
+
+
+	test_residual(ctx, "banded_lu_factor::det", []() {
+
+		auto D = rand_mat(0.0, 1.0, 10, 10);
+
+		for (unsigned int i = 0; i < 10; ++i)
+			for (unsigned int j = 0; j < 10; ++j)
+				if (j + 2 < i || j > i + 1)
+					D(i, j) = 0.0;
+
+		banded_lu_factor<> LU (banded_mat<>(D, 2, 1));
+
+		return std::abs(LU.det() - algebra::det(D)) / std::abs(algebra::det(D));
+	});
+
+
+	// packed.h
+
+
+	test_residual(ctx, "packed_mat::transform", []() {
+
+		auto A = rand_mat_symmetric(0.0, 1.0, N, N);
+		auto T = rand_mat(0.0, 1.0, N, N);
+		vec<real> v = rand_vec(0.0, 1.0, N);
+
+		packed_mat<> S (A);
+		packed_mat<real, PackedFormat::Lower> L (T);
+		packed_mat<real, PackedFormat::Upper> U (T);
+
+		// Triangular parts of the dense matrix
+		mat<real> T_lower = T, T_upper = T;
+
+		for (unsigned int i = 0; i < N; ++i) {
+			for (unsigned int j = 0; j < N; ++j) {
+
+				if (j > i)
+					T_lower(i, j) = 0.0;
+				else if (j < i)
+					T_upper(i, j) = 0.0;
+			}
+		}
+
+		// Generic routines accept packed matrices
+		mat<real> S_dense (S);
+
+		return linf_norm(S * v - A * v)
+			+ linf_norm(L * v - T_lower * v)
+			+ linf_norm(U * v - T_upper * v)
+			+ linf_norm(S_dense - A);
+	});
+
+
+	test_residual(ctx, "packed_mat (cholesky)", []() {
+
+		auto A = rand_mat_posdef(0.0, 1.0, N);
+		vec<real> b = rand_vec(0.0, 1.0, N);
+
+		auto L = algebra::decompose_cholesky(packed_mat<>(A));
+		vec<real> x = algebra::solve_cholesky(L, b);
+
+		return linf_norm(A * x - b)
+			+ linf_norm(mat<real>(L) - algebra::decompose_cholesky(A));
+	});
+
+
+	test_residual(ctx, "packed_mat (triangular)", []() {
+
+		auto T = rand_mat(0.0, 1.0, N, N);
+
+		for (unsigned int i = 0; i < N; ++i)
+			T(i, i) += N;
+
+		packed_mat<real, PackedFormat::Lower> L (T);
+		packed_mat<real, PackedFormat::Upper> U (T);
+		vec<real> b = rand_vec(0.0, 1.0, N);
+
+		return linf_norm(L * algebra::solve_triangular_lower(L, b) - b)
+			+ linf_norm(U * algebra::solve_triangular_upper(U, b) - b);
+	});
+
+
+	test_residual(ctx, "packed_mat (rank_update)", []() {
+
+		real res = 0.0;
+
+		// Sizes below and above the threshold for parallel updates
+		for (unsigned int n : {N, ALGEBRA_PACKED_PARALLEL_MIN + 3}) {
+
+			auto B = rand_mat(0.0, 1.0, n, 10);
+			vec<real> v = rand_vec(0.0, 1.0, n);
+
+			packed_mat<> S (n);
+			algebra::rank_update(S, B, 2.0);
+			algebra::rank_update(S, v, -1.0);
+
+			mat<real> expected = algebra::mat_mul_transpose(B, B) * 2.0;
+
+			for (unsigned int i = 0; i < n; ++i)
+				for (unsigned int j = 0; j < n; ++j)
+					expected(i, j) -= v[i] * v[j];
+
+			res = max(res, linf_norm(mat<real>(S) - expected));
+		}
+
+		return res;
+	}, 1);
+
+
+	test_residual(ctx, "packed_mat (covar_mat)", []() {
+
+		// Correlated datasets of measures
+		std::vector<vec<real>> data (6, vec<real>(100));
+
+		for (unsigned int k = 0; k < 100; ++k) {
+
+			const real common = rnd.gaussian(0.0, 1.0);
+
+			for (unsigned int i = 0; i < data.size(); ++i)
+				data[i][k] = common * i + rnd.gaussian(0.0, 1.0);
+		}
+
+		mat<real> C = stats::covar_mat(data);
+		packed_mat<> P = stats::covar_mat<packed_mat<>>(data);
+
+		mat<real> expected (data.size(), data.size());
+
+		for (unsigned int i = 0; i < data.size(); ++i)
+			for (unsigned int j = 0; j < data.size(); ++j)
+				expected(i, j) = stats::covariance(data[i], data[j]);
+
+		return linf_norm(mat<real>(P) - expected) + linf_norm(C - expected);
+	}, 1);
+
+
+	// matrix_function.h
+
+
+	test_residual(ctx, "expm", []() {
+
+		// Test the Padé approximants of all degrees
+		// and the scaling and squaring of the matrix
+		real max_res = 0.0;
+
+		for (real scale : {0.001, 0.1, 0.5, 1.0, 4.0}) {
+
+			mat<real> A = rand_mat(0.0, scale / std::sqrt(20.0), 20, 20);
+			mat<real> I (20, 20);
+			algebra::make_identity(I);
+
+			max_res = std::max(max_res, linf_norm(
+				algebra::expm(A) * algebra::expm(mat<real>(A * -1.0)) - I
+			));
+		}
+
+		// The exponential of a diagonal matrix is diagonal
+		mat<real> D (3, 3);
+		algebra::mat_zeroes(D);
+		D(0, 0) = 1.0;
+		D(1, 1) = -2.0;
+		D(2, 2) = 10.0;
+
+		mat<real> E = algebra::expm(D);
+
+		return max_res
+			+ std::abs(E(0, 0) - std::exp(1.0))
+			+ std::abs(E(1, 1) - std::exp(-2.0))
+			+ std::abs(E(2, 2) - std::exp(10.0)) / std::exp(10.0);
+	});
+
+
+	test_residual(ctx, "expm_multiply", []() {
+
+		mat<real> A = rand_mat(0.0, 1.0, N, N);
+		vec<real> v = rand_vec(0.0, 1.0, N);
+
+		vec<real> expected = algebra::expm(mat<real>(A * 0.5)) * v;
+
+		return linf_norm(algebra::expm_multiply(A, v, 0.5) - expected)
+			/ linf_norm(expected);
+	});
+
+
+	test_residual(ctx, "sqrtm", []() {
+
+		auto B = rand_mat(0.0, 1.0, 20, 20);
+		mat<real> A = algebra::expm(mat<real>(B * 0.3));
+		mat<real> R = algebra::sqrtm(A);
+
+		return linf_norm(R * R - A);
+	});
+
+
+	test_residual(ctx, "logm", []() {
+
+		auto B = rand_mat(0.0, 0.3, 20, 20);
+
+		return linf_norm(algebra::logm(algebra::expm(B)) - B);
+	});
+
+
+	// krylov.h
+
+	test_residual(ctx, "solve_cg (sparse)", []() {
+
+		// Negative of the 2D Laplacian on a 30x30 grid
+		const unsigned int m = 30;
+		const unsigned int n = m * m;
+		std::vector<sparse_triplet<real>> entries;
+
+		for (unsigned int i = 0; i < m; ++i) {
+			for (unsigned int j = 0; j < m; ++j) {
+
+				const unsigned int k = i * m + j;
+				entries.push_back({k, k, 4.0});
+
+				if (i > 0) entries.push_back({k, k - m, -1.0});
+				if (i < m - 1) entries.push_back({k, k + m, -1.0});
+				if (j > 0) entries.push_back({k, k - 1, -1.0});
+				if (j < m - 1) entries.push_back({k, k + 1, -1.0});
+			}
+		}
+
+		sparse_mat<> A (n, n, entries);
+		vec<real> b = rand_vec(0.0, 1.0, n);
+
+		auto res = algebra::solve_cg(A, b, identity_preconditioner(), 1E-12);
+		auto res_jacobi = algebra::solve_cg(A, b, jacobi_preconditioner<>(A), 1E-12);
+
+		if (!res.converged() || !res_jacobi.converged())
+			return inf();
+
+		return linf_norm(A * res.value - b) + linf_norm(A * res_jacobi.value - b);
+	}, 1);
+
+
+	test_residual(ctx, "solve_cg (matrix-free)", []() {
+
+		// Apply the 1D Laplacian with Dirichlet boundary conditions
+		// without storing the matrix
+		const unsigned int n = 200;
+
+		auto laplacian = [](const vec<real>& x) {
+
+			vec<real> y (x.size());
+
+			for (unsigned int i = 0; i < x.size(); ++i) {
+
+				y[i] = 2.0 * x[i];
+
+				if (i > 0)
+					y[i] -= x[i - 1];
+
+				if (i < x.size() - 1)
+					y[i] -= x[i + 1];
+			}
+
+			return y;
+		};
+
+		vec<real> b = rand_vec(0.0, 1.0, n);
+		auto res = algebra::solve_cg(laplacian, b, identity_preconditioner(), 1E-12);
+
+		if (!res.converged())
+			return inf();
+
+		return linf_norm(laplacian(res.value) - b);
+	}, 1);
+
+
+	test_residual(ctx, "solve_cg (breakdown)", []() {
+
+		// Indefinite matrix for which the first search
+		// direction is A-orthogonal to itself
+		mat<real> A = {{1.0, 0.0}, {0.0, -1.0}};
+		vec<real> b = {1.0, 1.0};
+
+		auto res = algebra::solve_cg(A, b);
+		real err = 0.0;
+
+		if (res.status != ConvergenceStatus::Stalled)
+			err += 1.0;
+
+		for (real x : res.value)
+			err += !std::isnan(x);
+
+		return err;
+	}, 1);
+
+
+	test_residual(ctx, "solve_bicgstab", []() {
+
+		// Nonsymmetric convection-diffusion operator
+		const unsigned int n = 500;
+		std::vector<sparse_triplet<real>> entries;
+
+		for (unsigned int i = 0; i < n; ++i) {
+
+			entries.push_back({i, i, 3.0});
+
+			if (i > 0)
+				entries.push_back({i, i - 1, -1.5});
+
+			if (i < n - 1)
+				entries.push_back({i, i + 1, -0.5});
+
+			if (i + 10 < n)
+				entries.push_back({i, i + 10, 0.2});
+		}
+
+		sparse_mat<> A (n, n, entries);
+		vec<real> b = rand_vec(0.0, 1.0, n);
+
+		auto res = algebra::solve_bicgstab(A, b, identity_preconditioner(), 1E-12);
+		auto res_ilu = algebra::solve_bicgstab(A, b, ilu0_preconditioner<>(A), 1E-12);
+
+		if (!res.converged() || !res_ilu.converged())
+			return inf();
+
+		return linf_norm(A * res.value - b) + linf_norm(A * res_ilu.value - b);
+	}, 1);
+
+
+	test_residual(ctx, "solve_gmres", []() {
+
+		// Dense nonsymmetric diagonally dominant matrix
+		const unsigned int n = 100;
+		auto A = rand_mat(-1.0, 1.0, n, n);
+
+		for (unsigned int i = 0; i < n; ++i)
+			A(i, i) += n;
+
+		vec<real> b = rand_vec(0.0, 1.0, n);
+
+		auto res = algebra::solve_gmres(A, b, identity_preconditioner(), 1E-12);
+		auto res_ilu = algebra::solve_gmres(
+			A, b, ilu0_preconditioner<>(A), 1E-12, ALGEBRA_KRYLOV_ITER, 5);
+
+		if (!res.converged() || !res_ilu.converged())
+			return inf();
+
+		return linf_norm(A * res.value - b) + linf_norm(A * res_ilu.value - b);
+	}, 1);
+
+
+	// parallel.h
+
+	test_residual(ctx, "parallel::mat_mul", []() {
+
+		auto A = rand_mat(0.0, 1.0, 301, 273);
+		auto B = rand_mat(0.0, 1.0, 273, 157);
+
+		return linf_norm(parallel::mat_mul(A, B) - algebra::mat_mul(A, B));
+	}, 1);
+
+
+	test_residual(ctx, "parallel::mat_transpose_mul", []() {
+
+		auto A = rand_mat(0.0, 1.0, 90, 70);
+		auto B = rand_mat(0.0, 1.0, 90, 60);
+
+		return linf_norm(
+			parallel::mat_transpose_mul(A, B) - algebra::mat_transpose_mul(A, B)
+		);
+	});
+
+
+	test_residual(ctx, "parallel::transform", []() {
+
+		auto A = rand_mat(0.0, 1.0, N, N);
+		auto v = rand_vec(0.0, 1.0, N);
+
+		return linf_norm(parallel::transform(A, v) - algebra::transform(A, v));
+	});
+
+
+	test_residual(ctx, "parallel::decompose_lu", []() {
+
+		auto A = rand_mat_posdef(0.0, 1.0, N);
+		mat<real> L, U;
+
+		parallel::decompose_lu(A, L, U);
+		return linf_norm(A - L * U);
+	});
+
+
+	test_residual(ctx, "parallel::decompose_cholesky", []() {
+
+		auto A = rand_mat_posdef(0.0, 1.0, N);
+		auto L = parallel::decompose_cholesky(A);
+		return linf_norm(A - algebra::mat_mul_transpose(L, L));
+	});
+
+
+	test_residual(ctx, "parallel::inverse", []() {
+
+		auto A = rand_mat_posdef(0.0, 1.0, N);
+		auto A_inv = parallel::inverse(A);
+
+		mat<real> I (N, N);
+		algebra::make_identity(I);
+
+		return linf_norm(A * A_inv - I);
+	});
+
+
+	test_residual(ctx, "parallel::det", []() {
+
+		auto A = rand_mat_posdef(0.0, 1.0, 10);
+		return std::abs(parallel::det(A) - algebra::det(A)) / std::abs(algebra::det(A));
+	});
+
+
+	test_residual(ctx, "parallel::det (zero pivot)", []() {
+
+		// A null leading element requires pivoting
+		mat<real> P = {{0, 1}, {1, 0}};
+
+		mat<real> A = rand_mat(0.0, 1.0, 10, 10);
+		A(0, 0) = 0.0;
+
+		return std::abs(parallel::det(P) + 1.0)
+			+ std::abs(parallel::det(A) - algebra::det(A)) / std::abs(algebra::det(A));
+	});
+
+
+	test_residual(ctx, "parallel::decompose_lu_pivot_inplace", []() {
+
+		mat<real> A = rand_mat(0.0, 1.0, N, N);
+		A(0, 0) = 0.0;
+
+		mat<real> LU = A;
+		std::vector<unsigned int> perm;
+		parallel::decompose_lu_pivot_inplace(LU, perm);
+
+		mat<real> L (N, N), U (N, N);
+
+		for (unsigned int i = 0; i < N; ++i) {
+			for (unsigned int j = 0; j < N; ++j) {
+				L(i, j) = (j < i) ? LU(i, j) : (i == j ? 1.0 : 0.0);
+				U(i, j) = (j >= i) ? LU(i, j) : 0.0;
+			}
+		}
+
+		// Rows of PA
+		mat<real> PA (N, N);
+
+		for (unsigned int i = 0; i < N; ++i)
+			for (unsigned int j = 0; j < N; ++j)
+				PA(i, j) = A(perm[i], j);
+
+		return linf_norm(PA - L * U);
+	});
+
+
+	// mat.h
+
+	test_residual(ctx, "mat::unpack", [&]() {
+
+		mat<real> A = rand_mat(0.0, 1.0, N, N);
+		vec<real> v = A.unpack();
+		mat<real> B (v, A.rows(), A.cols());
+
+		return linf_norm(A - B);
+	});
+
+	test_residual(ctx, "mat<N, K>::unpack", [&]() {
+
+		mat<real, 4, 4> A = rand_mat(0.0, 1.0, 4, 4);
+		vec<real, 16> v = A.unpack();
+		mat<real, 4, 4> B (v, A.rows(), A.cols());
+
+		return linf_norm(A - B);
+	});
+
+	test_residual(ctx, "mat (expression)", []() {
+
+		mat<real> A = rand_mat(0.0, 1.0, 30, 20);
+		mat<real> B = rand_mat(0.0, 1.0, 30, 20);
+		mat<real> C = rand_mat(0.0, 1.0, 30, 20);
+
+		// Every operand is wrapped, so that no temporary is evaluated
+		// and later changes to the operands are seen by the expression
+		auto expr = lazy(A) * 2.0 + lazy(B) / 4.0 - 3.0 * lazy(C);
+		B(0, 0) += 1.0;
+
+		// Evaluate A * 2 + B / 4 - 3 * C in a single pass
+		mat<real> R = expr;
+		mat<real> E (30, 20);
+
+		for (unsigned int i = 0; i < E.rows(); ++i)
+			for (unsigned int j = 0; j < E.cols(); ++j)
+				E(i, j) = 2.0 * A(i, j) + B(i, j) / 4.0 - 3.0 * C(i, j);
+
+		// Expressions may be multiplied by matrices and vectors
+		auto D = rand_mat(0.0, 1.0, 20, 10);
+		vec<real> v = rand_vec(0.0, 1.0, 20);
+
+		// Operators between matrices alone are evaluated eagerly
+		auto S = A + B;
+		S(0, 0) = 0.0;
+
+		return linf_norm(R - E) + std::abs(S(0, 0))
+			+ linf_norm((lazy(A) + B) * D - (A * D + B * D))
+			+ linf_norm((A - lazy(B)) * v - (A * v - B * v));
+	}, 1);
+
+
+	test_residual(ctx, "mat (aligned_allocator)", []() {
+
+		using aligned_mat = mat<real, 0, 0, aligned_allocator<real>>;
+		using aligned_vec = vec<real, 0, aligned_allocator<real>>;
+
+		aligned_mat A = rand_mat<aligned_mat>(0.0, 1.0, N, N);
+		aligned_vec b = rand_vec<aligned_vec>(0.0, 1.0, N);
+		aligned_vec x = algebra::solve(A, b);
+
+		const real misaligned =
+			(reinterpret_cast<uintptr_t>(A.data()) % CORE_ALIGNMENT)
+			+ (reinterpret_cast<uintptr_t>(x.data()) % CORE_ALIGNMENT);
+
+		return misaligned + linf_norm(A * x - b);
+	}, 1);
+
+
+	test_residual(ctx, "mat (arena_allocator)", []() {
+
+		using arena_mat = mat<real, 0, 0, arena_allocator<real>>;
+
+		// Small blocks to allocate more than one
+		arena scratch (4096);
+		arena_allocator<real> alloc (scratch);
+		size_t capacity = 0;
+		real res = 0.0;
+
+		for (unsigned int k = 0; k < 3; ++k) {
+
+			{
+				arena_mat A (N, N, alloc);
+
+				for (auto& x : A)
+					x = rnd.gaussian(0.0, 1.0);
+
+				// Copies use the same arena
+				arena_mat B = A;
+				arena_mat C (N, N, alloc);
+				algebra::mat_lincomb(C, 1.0, A, -1.0, B);
+
+				res += linf_norm(C) + (B.get_allocator() != alloc);
+			}
+
+			// Memory is reused after a reset
+			if (k == 0)
+				capacity = scratch.capacity();
+
+			res += (scratch.capacity() != capacity);
+			scratch.reset();
+		}
+
+		return res;
+	}, 1);
+
+	// vec.h
+
+	test_residual(ctx, "vec (expression)", []() {
+
+		const unsigned int n = 1000;
+		vec<real> x = rand_vec(0.0, 1.0, n);
+		vec<real> y = rand_vec(0.0, 1.0, n);
+		vec<real> z = rand_vec(0.0, 1.0, n);
+
+		// Every operand is wrapped, so that no temporary is evaluated
+		// and later changes to the operands are seen by the expression
+		auto expr = 2.0 * lazy(x) + lazy(y) * 3.0 - lazy(z) / 2.0;
+		z[0] += 1.0;
+
+		// Evaluate a * x + b * y - z / 2 in a single pass
+		vec<real> w = expr;
+		vec<real> e (n);
+
+		for (unsigned int i = 0; i < n; ++i)
+			e[i] = 2.0 * x[i] + 3.0 * y[i] - z[i] / 2.0;
+
+		// Assignment to an operand and accumulation
+		vec<real> u = x;
+		u = lazy(u) * 2.0 - y;
+		u += lazy(x) * 3.0;
+
+		vec<real> f (n);
+
+		for (unsigned int i = 0; i < n; ++i)
+			f[i] = 5.0 * x[i] - y[i];
+
+		// Operators between vectors alone are evaluated eagerly,
+		// so that the result may outlive local operands
+		auto g = [](const vec<real>& x) {
+			vec<real> t = x;
+			return 2.0 * t + x;
+		};
+
+		auto h = x + y;
+		h[0] = 0.0;
+
+		return linf_norm(w - e) + linf_norm(u - f)
+			+ linf_norm(g(x) - 3.0 * x) + std::abs(h[0])
+			+ std::abs((lazy(x) - y) * z - (x * z - y * z))
+			+ std::abs((-lazy(x)).norm() - x.norm());
+	}, 1);
+
+	// view.h
+
+	test_residual(ctx, "mat_view (block)", []() {
+
+		mat<real> A = rand_mat(0.0, 1.0, N, N);
+		mat<real> B = A;
+		mat<real> D = rand_mat(0.0, 1.0, 4, 5);
+		vec<real> v = rand_vec(0.0, 1.0, 5);
+
+		// Writing to a block modifies the matrix
+		auto S = algebra::submatrix(A, 2, 3, 4, 5);
+		S += D;
+
+		real res = linf_norm(algebra::transform(S, v) - (
+			algebra::transform(D, v) + algebra::transform(
+				algebra::submatrix(B, 2, 3, 4, 5), v)));
+
+		for (unsigned int i = 0; i < N; ++i)
+			for (unsigned int j = 0; j < N; ++j)
+				res += std::abs(A(i, j) - B(i, j)
+					- ((i >= 2 && i < 6 && j >= 3 && j < 8) ? D(i - 2, j - 3) : 0.0));
+
+		// Rows, columns and the diagonal
+		auto row1 = algebra::row(A, 1);
+		algebra::vec_copy(row1, algebra::col(B, 0));
+		vec<real> r, c;
+		algebra::vec_copy(r, algebra::row(A, 1));
+		algebra::vec_copy(c, algebra::col(B, 0));
+		res += linf_norm(r - c);
+		real tr = 0.0;
+		for (real x : algebra::view(A).diagonal())
+			tr += x;
+
+		res += std::abs(tr - algebra::trace(A));
+
+		return res;
+	}, 1);
+
+
+	test_residual(ctx, "vec_view (slice)", []() {
+
+		vec<real> x = rand_vec(0.0, 1.0, 100);
+		vec<real> y = rand_vec(0.0, 1.0, 100);
+
+		// Every third element, starting from the second
+		vec_view<real> s = algebra::slice(x, 1, 33, 3);
+		vec_view<const real> t = algebra::slice(y, 1, 33, 3);
+
+		real dot = 0.0;
+		for (unsigned int i = 0; i < 33; ++i)
+			dot += x[1 + 3 * i] * y[1 + 3 * i];
+
+		real res = std::abs(algebra::dot(s, t) - dot);
+
+		// Scaling a slice leaves the other elements untouched
+		vec<real> z = x;
+		s *= 2.0;
+
+		for (unsigned int i = 0; i < x.size(); ++i)
+			res += std::abs(x[i] - ((i % 3 == 1 && i < 100) ? 2.0 : 1.0) * z[i]);
+
+		// Slices of slices compose their strides
+		res += std::abs(s.slice(2, 5, 2)[1] - x[1 + 3 * 4]);
+
+		return res;
+	}, 1);
+
+
+	test_residual(ctx, "vec_view (copy, clone)", []() {
+
+		vec<real> x = rand_vec(0.0, 1.0, 50);
+		vec<real> x0 = x;
+
+		// Copies reference the same elements
+		vec_view<real> v = algebra::view(x);
+		vec_view<real> w = v;
+		w[3] = 10.0;
+
+		// Views over constant elements may be passed by value
+		const vec<real>& cx = x;
+		vec_view<const real> c = algebra::view(cx);
+		auto by_value = [](vec_view<const real> u) { return u[3]; };
+
+		real res = std::abs(x[3] - 10.0) + std::abs(by_value(c) - 10.0);
+
+		// Clones own their elements
+		vec_view<real> u = algebra::clone(v);
+		u[4] = 20.0;
+		res += std::abs(x[4] - x0[4]) + std::abs(u[4] - 20.0);
+
+		// Routines working on a copy of their argument leave it untouched
+		mat<real> A = rand_mat(0.0, 1.0, 10, 10);
+		mat_view<real> V = algebra::view(A);
+		mat<real> A0 = A;
+		vec<real> b = rand_vec(0.0, 1.0, 10);
+
+		res += linf_norm(algebra::solve(V, b) - algebra::solve(A0, b));
+		res += linf_norm(A - A0);
+
+		// Bound views cannot change size
+		w.resize(10);
+		res += !std::isnan(x[0]);
+
+		return res;
+	}, 1);
+
+
+	test_residual(ctx, "mat_view (external buffer)", []() {
+
+		const unsigned int n = 20;
+
+		// A buffer in C order, as provided by NumPy
+		std::vector<real> buffer (n * n);
+		mat<real> A (n, n);
+
+		for (unsigned int i = 0; i < n; ++i) {
+			for (unsigned int j = 0; j < n; ++j) {
+				buffer[i * n + j] = rnd.gaussian(0.0, 1.0);
+				A(i, j) = buffer[i * n + j];
+			}
+		}
+
+		mat_view<real> V (buffer.data(), n, n, n, 1);
+		vec<real> b = rand_vec(0.0, 1.0, n);
+
+		// Generic routines returning a view allocate storage
+		mat_view<real> T = algebra::transpose(V);
+		mat<real> P = algebra::mat_mul(V, A);
+		mat<real> T1, T2;
+		algebra::mat_copy(T1, T);
+		algebra::mat_copy(T2, V.transposed());
+
+		real res = linf_norm(algebra::solve(V, b) - algebra::solve(A, b))
+			+ linf_norm(T1 - algebra::transpose(A))
+			+ linf_norm(T2 - algebra::transpose(A))
+			+ linf_norm(P - A * A);
+
+		// In place decomposition writes to the buffer
+		algebra::decompose_lu_inplace(V);
+		algebra::decompose_lu_inplace(A);
+
+		for (unsigned int i = 0; i < n; ++i)
+			for (unsigned int j = 0; j < n; ++j)
+				res += std::abs(buffer[i * n + j] - A(i, j));
+
+		return res;
+	}, 1);
+
+	// batch.h
+
+	test_residual(ctx, "mat_batch (mat_mul, transform)", []() {
+
+		// Not a multiple of the number of lanes
+		const unsigned int n = 37;
+
+		std::vector<mat<real, 4, 3>> A (n);
+		std::vector<mat<real, 3, 4>> B (n);
+		std::vector<vec<real, 3>> v (n);
+
+		for (unsigned int b = 0; b < n; ++b) {
+			A[b] = rand_mat(0.0, 1.0, 4, 3);
+			B[b] = rand_mat(0.0, 1.0, 3, 4);
+			v[b] = rand_vec(0.0, 1.0, 3);
+		}
+
+		mat_batch<real, 4, 3> A_batch (A);
+		mat_batch<real, 3, 4> B_batch (B);
+		vec_batch<real, 3> v_batch (v);
+
+		auto R = algebra::mat_mul(A_batch, B_batch);
+		auto w = algebra::transform(A_batch, v_batch);
+
+		real res = 0.0;
+
+		for (unsigned int b = 0; b < n; ++b) {
+
+			vec<real, 4> r;
+			algebra::transform(r, A[b], v[b]);
+
+			res += linf_norm(R.get(b) - A[b].mul(B[b]));
+			res += linf_norm(w.get(b) - r);
+		}
+
+		return res;
+	}, 1);
+
+
+	test_residual(ctx, "mat_batch (inverse, det, solve)", []() {
+
+		const unsigned int n = 37;
+
+		std::vector<mat<real, 4, 4>> A (n);
+		std::vector<vec<real, 4>> v (n);
+
+		for (unsigned int b = 0; b < n; ++b) {
+			A[b] = rand_mat(0.0, 1.0, 4, 4);
+			v[b] = rand_vec(0.0, 1.0, 4);
+		}
+
+		// A permutation with null diagonal requires pivoting
+		A[5] = mat<real, 4, 4>({
+			{0, 1, 0, 0},
+			{0, 0, 0, 2},
+			{3, 0, 0, 0},
+			{0, 0, 4, 0}
+		});
+
+		mat_batch<real, 4, 4> A_batch (A);
+		vec_batch<real, 4> v_batch (v);
+
+		auto A_inv = algebra::inverse(A_batch);
+		auto x = algebra::solve(A_batch, v_batch);
+		vec<real> d = algebra::det(A_batch);
+
+		real res = 0.0;
+
+		for (unsigned int b = 0; b < n; ++b) {
+
+			res += linf_norm(A[b] * A_inv.get(b) - algebra::identity<mat<real, 4, 4>>());
+			res += linf_norm(A[b] * x.get(b) - v[b]);
+			res += std::abs(d[b] - algebra::det(A[b])) / std::abs(algebra::det(A[b]));
+		}
+
+		return res;
+	}, 1);
+
+	// distance.h
+
+	// Extract a row of a matrix as a vector
+	auto row = [](const mat<real>& A, unsigned int i) {
+
+		vec<real> r (A.cols());
+
+		for (unsigned int j = 0; j < A.cols(); ++j)
+			r[j] = A(i, j);
+
+		return r;
+	};
+
+
+	test_residual(ctx, "euclidean_distance_matrix", [&]() {
+
+		mat<real> X = rand_mat(0.0, 1.0, 150, 7);
+		mat<real> Y = rand_mat(1.0, 2.0, 90, 7);
+
+		mat<real> D = algebra::euclidean_distance_matrix(X, Y);
+		mat<real> D_sym = algebra::distance_matrix(X);
+		real res = 0.0;
+
+		for (unsigned int i = 0; i < X.rows(); ++i) {
+
+			for (unsigned int j = 0; j < Y.rows(); ++j)
+				res = std::max(res, std::abs(
+					D(i, j) - algebra::euclidean_distance(row(X, i), row(Y, j))));
+
+			for (unsigned int j = 0; j < X.rows(); ++j)
+				res = std::max(res, std::abs(
+					D_sym(i, j) - algebra::euclidean_distance(row(X, i), row(X, j))));
+		}
+
+		return res;
+	}, 1);
+
+
+	test_residual(ctx, "cosine_distance_matrix", [&]() {
+
+		mat<real> X = rand_mat(0.0, 1.0, 150, 7);
+		mat<real> Y = rand_mat(1.0, 2.0, 90, 7);
+
+		mat<real> D = algebra::cosine_distance_matrix(X, Y);
+		mat<real> D_sym = algebra::cosine_distance_matrix(X);
+		real res = 0.0;
+
+		for (unsigned int i = 0; i < X.rows(); ++i) {
+
+			for (unsigned int j = 0; j < Y.rows(); ++j)
+				res = std::max(res, std::abs(
+					D(i, j) - algebra::cosine_distance(row(X, i), row(Y, j))));
+
+			for (unsigned int j = 0; j < X.rows(); ++j)
+				res = std::max(res, std::abs(
+					D_sym(i, j) - algebra::cosine_distance(row(X, i), row(X, j))));
+		}
+
+		return res;
+	}, 1);
+
+
+	test_residual(ctx, "manhattan_distance_matrix", [&]() {
+
+		mat<real> X = rand_mat(0.0, 1.0, 150, 7);
+		mat<real> Y = rand_mat(1.0, 2.0, 90, 7);
+
+		mat<real> D_1 = algebra::manhattan_distance_matrix(X, Y);
+		mat<real> D_inf = algebra::chebyshev_distance_matrix(X, Y);
+		real res = 0.0;
+
+		for (unsigned int i = 0; i < X.rows(); ++i) {
+			for (unsigned int j = 0; j < Y.rows(); ++j) {
+
+				res = std::max(res, std::abs(
+					D_1(i, j) - algebra::manhattan_distance(row(X, i), row(Y, j))));
+
+				res = std::max(res, std::abs(
+					D_inf(i, j) - algebra::chebyshev_distance(row(X, i), row(Y, j))));
+			}
+		}
+
+		return res;
+	}, 1);
+
+
+	test_residual(ctx, "kd_tree::nearest", [&]() {
+
+		const unsigned int k = 10;
+		mat<real> X = rand_mat(0.0, 1.0, 2000, 3);
+		mat<real> Q = rand_mat(0.0, 1.2, 50, 3);
+
+		kd_tree tree (X);
+		mat<real> D = algebra::distance_matrix(Q, X);
+		auto neighbours = tree.nearest(Q, k);
+		real res = 0.0;
+
+		for (unsigned int i = 0; i < Q.rows(); ++i) {
+
+			// Brute force search of the nearest neighbours
+			std::vector<unsigned int> idx (X.rows());
+			std::iota(idx.begin(), idx.end(), 0);
+			std::partial_sort(idx.begin(), idx.begin() + k, idx.end(),
+				[&](unsigned int a, unsigned int b) { return D(i, a) < D(i, b); });
+
+			if (neighbours[i].size() != k)
+				return inf();
+
+			for (unsigned int j = 0; j < k; ++j) {
+
+				if (neighbours[i][j].index != idx[j])
+					return inf();
+
+				res = std::max(res, std::abs(neighbours[i][j].distance - D(i, idx[j])));
+			}
+		}
+
+		return res;
+	}, 1);
+
+
+	test_residual(ctx, "kd_tree::within", [&]() {
+
+		const real radius = 0.4;
+		mat<real> X = rand_mat(0.0, 1.0, 2000, 3);
+		mat<real> Q = rand_mat(0.0, 1.2, 50, 3);
+
+		kd_tree tree (X, 4);
+		real res = 0.0;
+
+		for (unsigned int i = 0; i < Q.rows(); ++i) {
+
+			auto found = tree.within(row(Q, i), radius);
+			unsigned int count = 0;
+
+			for (unsigned int j = 0; j < X.rows(); ++j)
+				if (algebra::euclidean_distance(row(Q, i), row(X, j)) <= radius)
+					count++;
+
+			if (found.size() != count)
+				return inf();
+
+			for (const auto& nb : found)
+				res = std::max(res, std::abs(
+					nb.distance - algebra::euclidean_distance(row(Q, i), row(X, nb.index))));
+		}
+
+		return res;
+	}, 1);
 }
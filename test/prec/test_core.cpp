@@ -723,6 +723,35 @@ int main(int argc, char const *argv[]) {
 	ctx.equals("th::is_inf", th::is_inf(th::inf()), true);
 
 
+	// dataset.h
+
+	{
+		// Ill-conditioned sum, with large terms cancelling out and
+		// an odd size to exercise the tail of the SIMD kernels
+		const unsigned int n = 100003;
+		vec<real> X (n);
+
+		for (unsigned int i = 0; i < n; ++i)
+			X[i] = 1E+12 * std::sin(i) + 1E-3 * std::cos(i);
+
+		real abs_sum = 0.0;
+
+		for (real x : X)
+			abs_sum += std::abs(x);
+
+		// Error bound of pairwise summation with base case
+		// of 128 elements, relative to the sum of absolute values
+		const real bound = (128 + std::ceil(std::log2(n))) * MACH_EPSILON * abs_sum;
+
+		ctx.equals(
+			"sum_pairwise (ill-conditioned)",
+			sum_pairwise(X),
+			sum_compensated(X),
+			bound
+		);
+	}
+
+
 	// reprod.h
 	auto env = reprod::get_env();
 	ctx.equals("get_env().os", env.os != "", true);
@@ -731,4 +760,12 @@ int main(int argc, char const *argv[]) {
 	ctx.equals("get_env().compiler_version", env.compiler_version != "", true);
 	ctx.equals("get_env().build_date", env.build_date != "", true);
 	ctx.equals("get_env().cpp_standard", env.cpp_standard != "", true);
+
+	// The register width of the SIMD kernels in use
+	const unsigned int width = simd::_internal::pack<real>::width;
+	ctx.equals(
+		"get_env().simd_bits",
+		env.simd_bits,
+		width > 1 ? width * sizeof(real) * 8 : 0
+	);
 }
@@ -385,6 +385,24 @@ int main(int argc, char const *argv[]) {
 		}
 	}
 
+	// Test natural boundary conditions of splines_cubic
+	{
+		std::vector<real> x, y;
+
+		for (int i = 0; i <= 10; ++i) {
+			x.push_back(0.3 * i);
+			y.push_back(std::sin(0.3 * i));
+		}
+
+		auto nodes = splines_cubic(x, y);
+		const spline_node& last = nodes.back();
+
+		// Second derivatives vanish at the extremes
+		ctx.equals("splines_cubic (natural, x_0)", nodes[0].c, 0.0, 1E-10);
+		ctx.equals("splines_cubic (natural, x_n)",
+			2.0 * last.c + 6.0 * last.d * (x.back() - last.x), 0.0, 1E-10);
+	}
+
 	// Test spline continuity
 	{
 		std::vector<vec2> points = {{0, 0}, {1, 1}, {2, 0}};
@@ -6,6 +6,26 @@ using namespace chebyshev;
 using namespace theoretica;
 
 
+// Compute the Discrete Fourier Transform by definition
+cvec dft(const cvec& x) {
+
+	const unsigned int N = x.size();
+	cvec k = cvec(N);
+
+	for (unsigned int i = 0; i < N; ++i) {
+
+		k[i] = 0;
+
+		for (unsigned int n = 0; n < N; ++n) {
+			const real theta = -2 * PI * ((unsigned long) i * n % N) / N;
+			k[i] += x[n] * complex<real>(std::cos(theta), std::sin(theta));
+		}
+	}
+
+	return k;
+}
+
+
 int main(int argc, char const *argv[]) {
 	
 	auto ctx = prec::make_context("signal", argc, argv);
@@ -75,13 +95,290 @@ int main(int argc, char const *argv[]) {
 		);
 	}
 
+	{
+		PRNG g = PRNG::xoshiro(time(nullptr));
+		pdf_sampler gauss = pdf_sampler::gaussian(0, 1, g);
+
+		const unsigned int N = 1 << 10;
+		cvec x = cvec(N);
+		gauss.fill(x);
+
+		cvec expected = dft(x);
+
+		signal::fft_plan plan (N);
+		signal::fft_plan inverse_plan (N, true);
+
+		cvec k = x;
+		plan.execute(k);
+
+		ctx.equals(
+			"fft_plan::execute",
+			algebra::linf_norm(k - expected) / algebra::linf_norm(expected),
+			0
+		);
+
+		ctx.equals(
+			"fft_plan (fft)",
+			algebra::linf_norm(signal::fft(x) - k),
+			0
+		);
+
+		ctx.equals(
+			"fft_plan (inverse)",
+			algebra::linf_norm(inverse_plan(expected) - x) / algebra::linf_norm(x),
+			0
+		);
+
+		// Plans may be executed any number of times
+		for (unsigned int i = 0; i < 10; ++i) {
+			plan.execute(k);
+			inverse_plan.execute(k);
+		}
+
+		ctx.equals(
+			"fft_plan (repeated)",
+			algebra::linf_norm(k - expected) / algebra::linf_norm(expected),
+			0
+		);
+	}
+
+	{
+		PRNG g = PRNG::xoshiro(time(nullptr));
+		pdf_sampler gauss = pdf_sampler::gaussian(0, 1, g);
+
+		// Without a work buffer, powers of 2 use the in-place radix-2
+		// algorithm, while the radix-4 kernel needs the work buffer
+		const unsigned int N = 4 * SIGNAL_FFT_SOA_MIN;
+		cvec x = cvec(N);
+		gauss.fill(x);
+
+		signal::fft_plan plan (N);
+		std::vector<complex<real>> work (plan.work_size());
+
+		cvec k_inplace = x;
+		cvec k_work = x;
+		plan.execute(k_inplace);
+		plan.execute(k_work, work);
+
+		ctx.equals(
+			"fft_plan::execute (work buffer)",
+			algebra::linf_norm(k_inplace - k_work) / algebra::linf_norm(k_work),
+			0
+		);
+	}
+
 	{
 		cvec x = {1, 1, 1};
+		cvec expected = {3, 0, 0};
 
 		ctx.equals(
 			"fft (N != 2^m)",
-			is_nan(signal::fft(x)[0]),
-			true
+			algebra::linf_norm(signal::fft(x) - expected),
+			0
+		);
+	}
+
+	{
+		PRNG g = PRNG::xoshiro(time(nullptr));
+		pdf_sampler gauss = pdf_sampler::gaussian(0, 1, g);
+
+		// Mixed radix sizes, sizes with large prime factors
+		// and powers of 2 using the radix-4 kernel
+		for (unsigned int N : {6, 12, 35, 49, 100, 3000, 17, 286, 1009, 2048, 8192, 16384}) {
+
+			cvec x = cvec(N);
+			gauss.fill(x);
+			cvec expected = dft(x);
+
+			ctx.equals(
+				"fft (N = " + std::to_string(N) + ")",
+				algebra::linf_norm(signal::fft(x) - expected) / algebra::linf_norm(expected),
+				0
+			);
+
+			ctx.equals(
+				"ifft (N = " + std::to_string(N) + ")",
+				algebra::linf_norm(signal::ifft(expected) - x) / algebra::linf_norm(x),
+				0
+			);
+		}
+	}
+
+	{
+		PRNG g = PRNG::xoshiro(time(nullptr));
+		pdf_sampler gauss = pdf_sampler::gaussian(0, 1, g);
+
+		// Even and odd sizes, with power of 2, mixed radix
+		// and Bluestein transforms of the packed data
+		for (unsigned int N : {1, 2, 16, 1024, 3000, 34, 15, 101}) {
+
+			vec<real> x = vec<real>(N);
+			gauss.fill(x);
+
+			cvec x_complex = cvec(N);
+
+			for (unsigned int i = 0; i < N; ++i)
+				x_complex[i] = x[i];
+
+			cvec expected = dft(x_complex);
+			cvec X = signal::rfft(x);
+			real res = (X.size() == N / 2 + 1) ? 0.0 : inf();
+
+			for (unsigned int k = 0; k < X.size(); ++k)
+				res = max(res, abs(X[k] - expected[k]));
+
+			ctx.equals(
+				"rfft (N = " + std::to_string(N) + ")",
+				res / algebra::linf_norm(expected),
+				0
+			);
+
+			ctx.equals(
+				"irfft (N = " + std::to_string(N) + ")",
+				algebra::linf_norm(signal::irfft(X, N) - x) / algebra::linf_norm(x),
+				0
+			);
+		}
+	}
+
+	{
+		PRNG g = PRNG::xoshiro(time(nullptr));
+		pdf_sampler gauss = pdf_sampler::gaussian(0, 1, g);
+
+		const unsigned int rows = 12;
+		const unsigned int cols = 10;
+
+		cmat A = cmat(rows, cols);
+
+		for (unsigned int i = 0; i < rows; ++i)
+			for (unsigned int j = 0; j < cols; ++j)
+				A(i, j) = complex<real>(gauss(), gauss());
+
+		// Transform the rows and then the columns by definition
+		cmat expected = cmat(rows, cols);
+
+		for (unsigned int i = 0; i < rows; ++i) {
+
+			cvec row = cvec(cols);
+
+			for (unsigned int j = 0; j < cols; ++j)
+				row[j] = A(i, j);
+
+			row = dft(row);
+
+			for (unsigned int j = 0; j < cols; ++j)
+				expected(i, j) = row[j];
+		}
+
+		for (unsigned int j = 0; j < cols; ++j) {
+
+			cvec col = cvec(rows);
+
+			for (unsigned int i = 0; i < rows; ++i)
+				col[i] = expected(i, j);
+
+			col = dft(col);
+
+			for (unsigned int i = 0; i < rows; ++i)
+				expected(i, j) = col[i];
+		}
+
+		cmat R = signal::fft2(A);
+		real res = 0.0;
+		real res_inv = 0.0;
+		real norm = 0.0;
+		real norm_inv = 0.0;
+
+		cmat A_inv = signal::ifft2(R);
+
+		for (unsigned int i = 0; i < rows; ++i) {
+			for (unsigned int j = 0; j < cols; ++j) {
+				res = max(res, abs(R(i, j) - expected(i, j)));
+				res_inv = max(res_inv, abs(A_inv(i, j) - A(i, j)));
+				norm = max(norm, abs(expected(i, j)));
+				norm_inv = max(norm_inv, abs(A(i, j)));
+			}
+		}
+
+		ctx.equals("fft2", res / norm, 0);
+		ctx.equals("ifft2", res_inv / norm_inv, 0);
+	}
+
+	{
+		PRNG g = PRNG::xoshiro(time(nullptr));
+		pdf_sampler gauss = pdf_sampler::gaussian(0, 1, g);
+
+		const unsigned int n0 = 4;
+		const unsigned int n1 = 6;
+		const unsigned int n2 = 5;
+
+		cvec x = cvec(n0 * n1 * n2);
+		gauss.fill(x);
+
+		// Three-dimensional transform by definition
+		cvec expected = cvec(n0 * n1 * n2);
+
+		for (unsigned int k0 = 0; k0 < n0; ++k0) {
+			for (unsigned int k1 = 0; k1 < n1; ++k1) {
+				for (unsigned int k2 = 0; k2 < n2; ++k2) {
+
+					complex<real> sum = 0;
+
+					for (unsigned int i0 = 0; i0 < n0; ++i0) {
+						for (unsigned int i1 = 0; i1 < n1; ++i1) {
+							for (unsigned int i2 = 0; i2 < n2; ++i2) {
+
+								const real theta = -2 * PI * (
+									real(k0 * i0 % n0) / n0 +
+									real(k1 * i1 % n1) / n1 +
+									real(k2 * i2 % n2) / n2);
+
+								sum += x[(i0 * n1 + i1) * n2 + i2]
+									* complex<real>(std::cos(theta), std::sin(theta));
+							}
+						}
+					}
+
+					expected[(k0 * n1 + k1) * n2 + k2] = sum;
+				}
+			}
+		}
+
+		cvec X = x;
+		signal::fft3(X, n0, n1, n2);
+
+		ctx.equals(
+			"fft3",
+			algebra::linf_norm(X - expected) / algebra::linf_norm(expected),
+			0
+		);
+
+		signal::ifft3(X, n0, n1, n2);
+
+		ctx.equals(
+			"ifft3",
+			algebra::linf_norm(X - x) / algebra::linf_norm(x),
+			0
+		);
+	}
+
+	{
+		PRNG g = PRNG::xoshiro(time(nullptr));
+		pdf_sampler gauss = pdf_sampler::gaussian(0, 1, g);
+
+		// Large enough to transform the lines in parallel
+		const std::vector<unsigned int> shape = {32, 48, 64};
+
+		cvec x = cvec(32 * 48 * 64);
+		gauss.fill(x);
+
+		cvec X = x;
+		signal::ifftn(signal::fftn(X, shape), shape);
+
+		ctx.equals(
+			"ifftn(fftn(x)) = x",
+			algebra::linf_norm(X - x) / algebra::linf_norm(x),
+			0
 		);
 	}
 }